@@ -17,7 +17,8 @@
 #include "Parser.h"
 #include "Util.h"
 #include "Typing.h"
-#include "Evaluator.h" // to initialize the builtins
+#include "Evaluator.h"
+#include "Interpreter.h" // to initialize the builtins
 
 struct StatementAnalysis
 {
@@ -544,7 +545,8 @@ try
         fileToAnalyze = std::string(argv[1]);
     }
 
-    initialize();
+    auto interpreter = std::make_shared<interp::Interpreter>();
+    interp::CurrentInterpreter currentInterpreter(interpreter.get());
 
     if (!fileToAnalyze.empty())
     {
@@ -595,7 +597,7 @@ try
     {
         std::cerr << "No file specified" << std::endl;
     }
-    finalize();
+    interpreter.reset();
     return returnValue;
 }
 catch (std::runtime_error &e)
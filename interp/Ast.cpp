@@ -386,6 +386,16 @@ namespace ast
         return ss.str();
     }
 
+    std::string YieldStatement::text(int indent) const
+    {
+        std::stringstream ss;
+        ss << indentation(indent) << tokenLiteral() << " ";
+        if (value)
+            ss << value->text();
+        ss << ";";
+        return ss.str();
+    }
+
     std::string BreakStatement::text(int indent) const
     {
         std::stringstream ss;
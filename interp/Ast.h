@@ -9,6 +9,8 @@
 #ifndef GUARDIAN_OF_INCLUSION_AST_H
 #define GUARDIAN_OF_INCLUSION_AST_H
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <complex>
@@ -75,13 +77,7 @@ namespace ast
         TryExceptStatement = 48,
         ContinueStatement = 49,
         RangeLiteral = 50,
-    };
-
-    enum class MarkedAsBuiltin
-    {
-        Unknown = -1,
-        False = 0,
-        True = 1,
+        YieldStatement = 51,
     };
 
     struct Node
@@ -364,10 +360,26 @@ namespace ast
         NullLiteral() : Expression(NodeType::NullLiteral){};
     };
 
+    /* the version of the builtins in which an identifier was last found not to name a builtin, 0 when unknown;
+     * the syntax tree is shared by interpreters on several threads so it is kept in an atomic
+     */
+    struct NotBuiltinMemo
+    {
+        std::atomic<uint64_t> version{0};
+
+        NotBuiltinMemo() = default;
+        NotBuiltinMemo(const NotBuiltinMemo &other) : version(other.version.load(std::memory_order_relaxed)){};
+        NotBuiltinMemo &operator=(const NotBuiltinMemo &other)
+        {
+            version.store(other.version.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
     struct Identifier : public Expression
     {
-        // tracks if this indentifier clashes with a built-in function/variable name
-        MarkedAsBuiltin markedAsBuiltin = ast::MarkedAsBuiltin::Unknown;
+        // avoids looking up variables in the builtins of an interpreter again and again
+        NotBuiltinMemo notBuiltin;
 
         std::string value;
         virtual std::string text(int indent = 0) const override;
@@ -389,6 +401,7 @@ namespace ast
         std::vector<std::unique_ptr<TypeExpression>> argumentTypes;
         std::unique_ptr<TypeExpression> returnType;
         std::unique_ptr<BlockStatement> body;
+        bool isGenerator = false; /*< the body contains a yield statement */
 
         virtual std::string text(int indent = 0) const override;
         FunctionLiteral() : Expression(NodeType::FunctionLiteral){};
@@ -532,6 +545,13 @@ namespace ast
         ReturnStatement() : Statement(NodeType::ReturnStatement){};
     };
 
+    struct YieldStatement : public Statement
+    {
+        std::unique_ptr<Expression> value;
+        virtual std::string text(int indent = 0) const override;
+        YieldStatement() : Statement(NodeType::YieldStatement){};
+    };
+
     struct BreakStatement : public Statement
     {
         virtual std::string text(int indent = 0) const override;
@@ -0,0 +1,876 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "AstSerializer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    /* tag written in place of a node type for absent (nullptr) children */
+    const int32_t nullNodeTag = -2;
+
+    /* upper bound on the length of any string or list, protects against garbage input */
+    const uint64_t maxSequenceLength = uint64_t(1) << 32;
+
+    struct DeserializeError : public std::runtime_error
+    {
+        DeserializeError(const std::string &msg) : std::runtime_error(msg){};
+    };
+
+    class Writer
+    {
+    public:
+        Writer(std::ostream &ios) : os(ios){};
+
+        template <typename T>
+        void pod(const T &value)
+        {
+            os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        void boolean(bool value) { pod<uint8_t>(value ? 1 : 0); }
+        void size(size_t value) { pod<uint64_t>(static_cast<uint64_t>(value)); }
+
+        void string(const std::string &value)
+        {
+            size(value.size());
+            os.write(value.data(), value.size());
+        }
+
+        void token(const Token &token)
+        {
+            pod<int32_t>(static_cast<int32_t>(token.type));
+            string(token.literal);
+            size(token.lineNumber);
+            size(token.columnNumber);
+        }
+
+        void identifier(const ast::Identifier &identifier)
+        {
+            token(identifier.token);
+            string(identifier.value);
+        }
+
+        template <typename T>
+        void nodes(const std::vector<std::unique_ptr<T>> &children)
+        {
+            size(children.size());
+            for (const auto &child : children)
+                node(child.get());
+        }
+
+        void node(const ast::Node *node);
+
+    private:
+        std::ostream &os;
+    };
+
+    void Writer::node(const ast::Node *node)
+    {
+        if (!node)
+        {
+            pod<int32_t>(nullNodeTag);
+            return;
+        }
+
+        pod<int32_t>(static_cast<int32_t>(node->type));
+        token(node->token);
+
+        switch (node->type)
+        {
+        case ast::NodeType::Program:
+            nodes(static_cast<const ast::Program *>(node)->statements);
+            break;
+        case ast::NodeType::BlockStatement:
+            nodes(static_cast<const ast::BlockStatement *>(node)->statements);
+            break;
+        case ast::NodeType::ScopeStatement:
+            nodes(static_cast<const ast::ScopeStatement *>(node)->statements);
+            break;
+        case ast::NodeType::LetStatement:
+        {
+            auto statement = static_cast<const ast::LetStatement *>(node);
+            boolean(statement->constant);
+            identifier(statement->name);
+            this->node(statement->valueType.get());
+            this->node(statement->value.get());
+        }
+        break;
+        case ast::NodeType::ImportStatement:
+        {
+            auto statement = static_cast<const ast::ImportStatement *>(node);
+            this->node(&statement->name);
+        }
+        break;
+        case ast::NodeType::TypeStatement:
+        {
+            auto statement = static_cast<const ast::TypeStatement *>(node);
+            boolean(statement->constant);
+            identifier(statement->name);
+            this->node(statement->exprType.get());
+            this->node(statement->value.get());
+        }
+        break;
+        case ast::NodeType::ReturnStatement:
+            this->node(static_cast<const ast::ReturnStatement *>(node)->returnValue.get());
+            break;
+        case ast::NodeType::YieldStatement:
+            this->node(static_cast<const ast::YieldStatement *>(node)->value.get());
+            break;
+        case ast::NodeType::BreakStatement:
+        case ast::NodeType::ContinueStatement:
+            break;
+        case ast::NodeType::TryExceptStatement:
+        {
+            auto statement = static_cast<const ast::TryExceptStatement *>(node);
+            this->node(statement->statement.get());
+            this->node(statement->except.get());
+            identifier(statement->name);
+            this->node(statement->errorType.get());
+        }
+        break;
+        case ast::NodeType::ExpressionStatement:
+            this->node(static_cast<const ast::ExpressionStatement *>(node)->expression.get());
+            break;
+        case ast::NodeType::IfExpression:
+        {
+            auto expression = static_cast<const ast::IfExpression *>(node);
+            this->node(expression->condition.get());
+            this->node(expression->consequence.get());
+            this->node(expression->alternative.get());
+        }
+        break;
+        case ast::NodeType::WhileExpression:
+        {
+            auto expression = static_cast<const ast::WhileExpression *>(node);
+            this->node(expression->condition.get());
+            this->node(expression->statement.get());
+        }
+        break;
+        case ast::NodeType::ForExpression:
+        {
+            auto expression = static_cast<const ast::ForExpression *>(node);
+            boolean(expression->constant);
+            identifier(expression->name);
+            this->node(expression->iterType.get());
+            this->node(expression->iterable.get());
+            this->node(expression->statement.get());
+        }
+        break;
+        case ast::NodeType::InfixExpression:
+        {
+            auto expression = static_cast<const ast::InfixExpression *>(node);
+            this->node(expression->left.get());
+            token(expression->operator_t);
+            this->node(expression->right.get());
+        }
+        break;
+        case ast::NodeType::OperatorExpression:
+        {
+            auto expression = static_cast<const ast::OperatorExpression *>(node);
+            this->node(expression->left.get());
+            token(expression->operator_t);
+            this->node(expression->right.get());
+        }
+        break;
+        case ast::NodeType::PrefixExpression:
+        {
+            auto expression = static_cast<const ast::PrefixExpression *>(node);
+            token(expression->operator_t);
+            this->node(expression->right.get());
+        }
+        break;
+        case ast::NodeType::BooleanLiteral:
+            boolean(static_cast<const ast::BooleanLiteral *>(node)->value);
+            break;
+        case ast::NodeType::IntegerLiteral:
+            pod<int64_t>(static_cast<const ast::IntegerLiteral *>(node)->value);
+            break;
+        case ast::NodeType::RangeLiteral:
+        {
+            auto expression = static_cast<const ast::RangeLiteral *>(node);
+            pod<int64_t>(expression->lower);
+            pod<int64_t>(expression->upper);
+            pod<int64_t>(expression->stride);
+        }
+        break;
+        case ast::NodeType::DoubleLiteral:
+            pod<double>(static_cast<const ast::DoubleLiteral *>(node)->value);
+            break;
+        case ast::NodeType::ComplexLiteral:
+        {
+            auto expression = static_cast<const ast::ComplexLiteral *>(node);
+            pod<double>(expression->value.real());
+            pod<double>(expression->value.imag());
+        }
+        break;
+        case ast::NodeType::StringLiteral:
+            string(static_cast<const ast::StringLiteral *>(node)->value);
+            break;
+        case ast::NodeType::NullLiteral:
+            string(static_cast<const ast::NullLiteral *>(node)->value);
+            break;
+        case ast::NodeType::Identifier:
+            string(static_cast<const ast::Identifier *>(node)->value);
+            break;
+        case ast::NodeType::ModuleIdentifier:
+        {
+            auto expression = static_cast<const ast::ModuleIdentifier *>(node);
+            size(expression->path.size());
+            for (const auto &element : expression->path)
+                string(element);
+        }
+        break;
+        case ast::NodeType::FunctionLiteral:
+        {
+            auto expression = static_cast<const ast::FunctionLiteral *>(node);
+            string(expression->doc);
+            string(expression->value);
+            size(expression->arguments.size());
+            for (const auto &argument : expression->arguments)
+                identifier(argument);
+            nodes(expression->argumentTypes);
+            this->node(expression->returnType.get());
+            this->node(expression->body.get());
+            boolean(expression->isGenerator);
+        }
+        break;
+        case ast::NodeType::CallExpression:
+        {
+            auto expression = static_cast<const ast::CallExpression *>(node);
+            this->node(expression->function.get());
+            nodes(expression->arguments);
+        }
+        break;
+        case ast::NodeType::MemberExpression:
+        {
+            auto expression = static_cast<const ast::MemberExpression *>(node);
+            this->node(expression->expr.get());
+            identifier(expression->value);
+        }
+        break;
+        case ast::NodeType::ModuleMemberExpression:
+        {
+            auto expression = static_cast<const ast::ModuleMemberExpression *>(node);
+            this->node(expression->expr.get());
+            identifier(expression->value);
+        }
+        break;
+        case ast::NodeType::ArrayLiteral:
+            nodes(static_cast<const ast::ArrayLiteral *>(node)->elements);
+            break;
+        case ast::NodeType::ArrayDoubleLiteral:
+        {
+            auto expression = static_cast<const ast::ArrayDoubleLiteral *>(node);
+            size(expression->elements.size());
+            for (const auto &element : expression->elements)
+                pod<double>(element);
+        }
+        break;
+        case ast::NodeType::ArrayComplexLiteral:
+        {
+            auto expression = static_cast<const ast::ArrayComplexLiteral *>(node);
+            size(expression->elements.size());
+            for (const auto &element : expression->elements)
+            {
+                pod<double>(element.real());
+                pod<double>(element.imag());
+            }
+        }
+        break;
+        case ast::NodeType::DictLiteral:
+        {
+            auto expression = static_cast<const ast::DictLiteral *>(node);
+            size(expression->elements.size());
+            for (const auto &[key, value] : expression->elements)
+            {
+                this->node(key.get());
+                this->node(value.get());
+            }
+        }
+        break;
+        case ast::NodeType::SetLiteral:
+        {
+            auto expression = static_cast<const ast::SetLiteral *>(node);
+            size(expression->elements.size());
+            for (const auto &element : expression->elements)
+                this->node(element.get());
+        }
+        break;
+        case ast::NodeType::IndexExpression:
+        {
+            auto expression = static_cast<const ast::IndexExpression *>(node);
+            this->node(expression->expression.get());
+            this->node(expression->index.get());
+        }
+        break;
+        case ast::NodeType::TypeLiteral:
+        {
+            auto expression = static_cast<const ast::TypeLiteral *>(node);
+            string(expression->name);
+            string(expression->doc);
+            nodes(expression->definitions);
+        }
+        break;
+        case ast::NodeType::TypeNull:
+        case ast::NodeType::TypeAny:
+        case ast::NodeType::TypeAll:
+            break;
+        case ast::NodeType::TypeIdentifier:
+            string(static_cast<const ast::TypeIdentifier *>(node)->value);
+            break;
+        case ast::NodeType::TypeType:
+            string(static_cast<const ast::TypeType *>(node)->value);
+            break;
+        case ast::NodeType::TypeChoice:
+            nodes(static_cast<const ast::TypeChoice *>(node)->choices);
+            break;
+        case ast::NodeType::TypeArray:
+            this->node(static_cast<const ast::TypeArray *>(node)->elementType.get());
+            break;
+        case ast::NodeType::TypeSet:
+            this->node(static_cast<const ast::TypeSet *>(node)->elementType.get());
+            break;
+        case ast::NodeType::TypeDictionary:
+        {
+            auto type = static_cast<const ast::TypeDictionary *>(node);
+            this->node(type->keyType.get());
+            this->node(type->valueType.get());
+        }
+        break;
+        case ast::NodeType::TypeFunction:
+        {
+            auto type = static_cast<const ast::TypeFunction *>(node);
+            this->node(type->returnType.get());
+            nodes(type->argTypes);
+        }
+        break;
+        case ast::NodeType::BoundType:
+        {
+            auto type = static_cast<const ast::BoundType *>(node);
+            this->node(type->boundTo.get());
+            this->node(type->boundType.get());
+        }
+        break;
+        default:
+            throw std::logic_error("serialize: unsupported node type " + std::to_string(static_cast<int>(node->type)));
+        }
+    }
+
+    class Reader
+    {
+    public:
+        Reader(std::istream &iis, const std::shared_ptr<std::string> &ifileName) : is(iis), fileName(ifileName){};
+
+        template <typename T>
+        T pod()
+        {
+            T value;
+            is.read(reinterpret_cast<char *>(&value), sizeof(T));
+            if (!is)
+                throw DeserializeError("unexpected end of stream");
+            return value;
+        }
+
+        bool boolean() { return pod<uint8_t>() != 0; }
+
+        size_t size()
+        {
+            auto value = pod<uint64_t>();
+            if (value > maxSequenceLength)
+                throw DeserializeError("sequence length out of bounds");
+            return static_cast<size_t>(value);
+        }
+
+        std::string string()
+        {
+            std::string value(size(), '\0');
+            if (!value.empty())
+                is.read(value.data(), value.size());
+            if (!is)
+                throw DeserializeError("unexpected end of stream");
+            return value;
+        }
+
+        Token token()
+        {
+            Token token;
+            token.fileName = fileName;
+            token.type = static_cast<TokenType>(pod<int32_t>());
+            token.literal = string();
+            token.lineNumber = size();
+            token.columnNumber = size();
+            return token;
+        }
+
+        void identifier(ast::Identifier &identifier)
+        {
+            identifier.token = token();
+            identifier.value = string();
+        }
+
+        /* read a node and verify it is of the expected category (Statement, Expression, ...) */
+        template <typename T>
+        std::unique_ptr<T> node()
+        {
+            auto result = anyNode();
+            if (!result)
+                return nullptr;
+            T *casted = dynamic_cast<T *>(result.get());
+            if (!casted)
+                throw DeserializeError("unexpected node type " + std::to_string(static_cast<int>(result->type)));
+            result.release();
+            return std::unique_ptr<T>(casted);
+        }
+
+        template <typename T>
+        void nodes(std::vector<std::unique_ptr<T>> &children)
+        {
+            auto count = size();
+            children.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+                children.push_back(node<T>());
+        }
+
+        std::unique_ptr<ast::Node> anyNode();
+
+    private:
+        std::istream &is;
+        std::shared_ptr<std::string> fileName;
+    };
+
+    std::unique_ptr<ast::Node> Reader::anyNode()
+    {
+        auto tag = pod<int32_t>();
+        if (tag == nullNodeTag)
+            return nullptr;
+
+        auto nodeType = static_cast<ast::NodeType>(tag);
+        auto nodeToken = token();
+
+        std::unique_ptr<ast::Node> result;
+        switch (nodeType)
+        {
+        case ast::NodeType::Program:
+        {
+            auto program = std::make_unique<ast::Program>();
+            nodes(program->statements);
+            result = std::move(program);
+        }
+        break;
+        case ast::NodeType::BlockStatement:
+        {
+            auto statement = std::make_unique<ast::BlockStatement>();
+            nodes(statement->statements);
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::ScopeStatement:
+        {
+            auto statement = std::make_unique<ast::ScopeStatement>();
+            nodes(statement->statements);
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::LetStatement:
+        {
+            auto statement = std::make_unique<ast::LetStatement>();
+            statement->constant = boolean();
+            identifier(statement->name);
+            statement->valueType = node<ast::TypeExpression>();
+            statement->value = node<ast::Expression>();
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::ImportStatement:
+        {
+            auto statement = std::make_unique<ast::ImportStatement>();
+            auto name = node<ast::ModuleIdentifier>();
+            if (!name)
+                throw DeserializeError("import statement without module identifier");
+            statement->name = std::move(*name);
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::TypeStatement:
+        {
+            auto statement = std::make_unique<ast::TypeStatement>();
+            statement->constant = boolean();
+            identifier(statement->name);
+            statement->exprType = node<ast::TypeExpression>();
+            statement->value = node<ast::Expression>();
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::ReturnStatement:
+        {
+            auto statement = std::make_unique<ast::ReturnStatement>();
+            statement->returnValue = node<ast::Expression>();
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::YieldStatement:
+        {
+            auto statement = std::make_unique<ast::YieldStatement>();
+            statement->value = node<ast::Expression>();
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::BreakStatement:
+            result = std::make_unique<ast::BreakStatement>();
+            break;
+        case ast::NodeType::ContinueStatement:
+            result = std::make_unique<ast::ContinueStatement>();
+            break;
+        case ast::NodeType::TryExceptStatement:
+        {
+            auto statement = std::make_unique<ast::TryExceptStatement>();
+            statement->statement = node<ast::BlockStatement>();
+            statement->except = node<ast::BlockStatement>();
+            identifier(statement->name);
+            statement->errorType = node<ast::TypeExpression>();
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::ExpressionStatement:
+        {
+            auto statement = std::make_unique<ast::ExpressionStatement>();
+            statement->expression = node<ast::Expression>();
+            result = std::move(statement);
+        }
+        break;
+        case ast::NodeType::IfExpression:
+        {
+            auto expression = std::make_unique<ast::IfExpression>();
+            expression->condition = node<ast::Expression>();
+            expression->consequence = node<ast::BlockStatement>();
+            expression->alternative = node<ast::BlockStatement>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::WhileExpression:
+        {
+            auto expression = std::make_unique<ast::WhileExpression>();
+            expression->condition = node<ast::Expression>();
+            expression->statement = node<ast::BlockStatement>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::ForExpression:
+        {
+            auto expression = std::make_unique<ast::ForExpression>();
+            expression->constant = boolean();
+            identifier(expression->name);
+            expression->iterType = node<ast::TypeExpression>();
+            expression->iterable = node<ast::Expression>();
+            expression->statement = node<ast::BlockStatement>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::InfixExpression:
+        {
+            auto expression = std::make_unique<ast::InfixExpression>();
+            expression->left = node<ast::Expression>();
+            expression->operator_t = token();
+            expression->right = node<ast::Expression>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::OperatorExpression:
+        {
+            auto expression = std::make_unique<ast::OperatorExpression>();
+            expression->left = node<ast::Expression>();
+            expression->operator_t = token();
+            expression->right = node<ast::Expression>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::PrefixExpression:
+        {
+            auto expression = std::make_unique<ast::PrefixExpression>();
+            expression->operator_t = token();
+            expression->right = node<ast::Expression>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::BooleanLiteral:
+        {
+            auto expression = std::make_unique<ast::BooleanLiteral>();
+            expression->value = boolean();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::IntegerLiteral:
+        {
+            auto expression = std::make_unique<ast::IntegerLiteral>();
+            expression->value = pod<int64_t>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::RangeLiteral:
+        {
+            auto expression = std::make_unique<ast::RangeLiteral>();
+            expression->lower = pod<int64_t>();
+            expression->upper = pod<int64_t>();
+            expression->stride = pod<int64_t>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::DoubleLiteral:
+        {
+            auto expression = std::make_unique<ast::DoubleLiteral>();
+            expression->value = pod<double>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::ComplexLiteral:
+        {
+            auto expression = std::make_unique<ast::ComplexLiteral>();
+            auto real = pod<double>();
+            auto imag = pod<double>();
+            expression->value = std::complex<double>(real, imag);
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::StringLiteral:
+        {
+            auto expression = std::make_unique<ast::StringLiteral>();
+            expression->value = string();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::NullLiteral:
+        {
+            auto expression = std::make_unique<ast::NullLiteral>();
+            expression->value = string();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::Identifier:
+        {
+            auto expression = std::make_unique<ast::Identifier>();
+            expression->value = string();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::ModuleIdentifier:
+        {
+            auto expression = std::make_unique<ast::ModuleIdentifier>();
+            auto count = size();
+            for (size_t i = 0; i < count; ++i)
+                expression->path.push_back(string());
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::FunctionLiteral:
+        {
+            auto expression = std::make_unique<ast::FunctionLiteral>();
+            expression->doc = string();
+            expression->value = string();
+            auto count = size();
+            expression->arguments.resize(count);
+            for (auto &argument : expression->arguments)
+                identifier(argument);
+            nodes(expression->argumentTypes);
+            expression->returnType = node<ast::TypeExpression>();
+            expression->body = node<ast::BlockStatement>();
+            expression->isGenerator = boolean();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::CallExpression:
+        {
+            auto expression = std::make_unique<ast::CallExpression>();
+            expression->function = node<ast::Expression>();
+            nodes(expression->arguments);
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::MemberExpression:
+        {
+            auto expression = std::make_unique<ast::MemberExpression>();
+            expression->expr = node<ast::Expression>();
+            identifier(expression->value);
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::ModuleMemberExpression:
+        {
+            auto expression = std::make_unique<ast::ModuleMemberExpression>();
+            expression->expr = node<ast::Expression>();
+            identifier(expression->value);
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::ArrayLiteral:
+        {
+            auto expression = std::make_unique<ast::ArrayLiteral>();
+            nodes(expression->elements);
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::ArrayDoubleLiteral:
+        {
+            auto expression = std::make_unique<ast::ArrayDoubleLiteral>();
+            auto count = size();
+            expression->elements.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+                expression->elements.push_back(pod<double>());
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::ArrayComplexLiteral:
+        {
+            auto expression = std::make_unique<ast::ArrayComplexLiteral>();
+            auto count = size();
+            expression->elements.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto real = pod<double>();
+                auto imag = pod<double>();
+                expression->elements.push_back(std::complex<double>(real, imag));
+            }
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::DictLiteral:
+        {
+            auto expression = std::make_unique<ast::DictLiteral>();
+            auto count = size();
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto key = node<ast::Expression>();
+                auto value = node<ast::Expression>();
+                expression->elements.insert_or_assign(std::move(key), std::move(value));
+            }
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::SetLiteral:
+        {
+            auto expression = std::make_unique<ast::SetLiteral>();
+            auto count = size();
+            for (size_t i = 0; i < count; ++i)
+                expression->elements.insert(node<ast::Expression>());
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::IndexExpression:
+        {
+            auto expression = std::make_unique<ast::IndexExpression>();
+            expression->expression = node<ast::Expression>();
+            expression->index = node<ast::Expression>();
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::TypeLiteral:
+        {
+            auto expression = std::make_unique<ast::TypeLiteral>();
+            expression->name = string();
+            expression->doc = string();
+            nodes(expression->definitions);
+            result = std::move(expression);
+        }
+        break;
+        case ast::NodeType::TypeNull:
+            result = std::make_unique<ast::TypeNull>();
+            break;
+        case ast::NodeType::TypeAny:
+            result = std::make_unique<ast::TypeAny>();
+            break;
+        case ast::NodeType::TypeAll:
+            result = std::make_unique<ast::TypeAll>();
+            break;
+        case ast::NodeType::TypeIdentifier:
+            result = std::make_unique<ast::TypeIdentifier>(string());
+            break;
+        case ast::NodeType::TypeType:
+        {
+            auto type = std::make_unique<ast::TypeType>();
+            type->value = string();
+            result = std::move(type);
+        }
+        break;
+        case ast::NodeType::TypeChoice:
+        {
+            auto type = std::make_unique<ast::TypeChoice>();
+            nodes(type->choices);
+            result = std::move(type);
+        }
+        break;
+        case ast::NodeType::TypeArray:
+        {
+            auto type = std::make_unique<ast::TypeArray>();
+            type->elementType = node<ast::TypeExpression>();
+            result = std::move(type);
+        }
+        break;
+        case ast::NodeType::TypeSet:
+        {
+            auto type = std::make_unique<ast::TypeSet>();
+            type->elementType = node<ast::TypeExpression>();
+            result = std::move(type);
+        }
+        break;
+        case ast::NodeType::TypeDictionary:
+        {
+            auto type = std::make_unique<ast::TypeDictionary>();
+            type->keyType = node<ast::TypeExpression>();
+            type->valueType = node<ast::TypeExpression>();
+            result = std::move(type);
+        }
+        break;
+        case ast::NodeType::TypeFunction:
+        {
+            auto type = std::make_unique<ast::TypeFunction>();
+            type->returnType = node<ast::TypeExpression>();
+            nodes(type->argTypes);
+            result = std::move(type);
+        }
+        break;
+        case ast::NodeType::BoundType:
+        {
+            auto type = std::make_unique<ast::BoundType>();
+            type->boundTo = node<ast::TypeExpression>();
+            type->boundType = node<ast::TypeExpression>();
+            result = std::move(type);
+        }
+        break;
+        default:
+            throw DeserializeError("unknown node type " + std::to_string(tag));
+        }
+
+        result->token = std::move(nodeToken);
+        return result;
+    }
+}
+
+namespace ast
+{
+    void serialize(const Program &program, std::ostream &os)
+    {
+        Writer writer(os);
+        writer.node(&program);
+    }
+
+    std::unique_ptr<Program> deserialize(std::istream &is, const std::shared_ptr<std::string> &fileName)
+    {
+        try
+        {
+            Reader reader(is, fileName);
+            return reader.node<Program>();
+        }
+        catch (const DeserializeError &)
+        {
+            return nullptr;
+        }
+    }
+}
@@ -0,0 +1,31 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_AST_SERIALIZER_H
+#define GUARDIAN_OF_INCLUSION_AST_SERIALIZER_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "Ast.h"
+
+namespace ast
+{
+    /* write the program as a compact binary stream, the file names of the tokens
+     * are not written as they are restored from the location the program is loaded from
+     */
+    void serialize(const Program &program, std::ostream &os);
+
+    /* read back a program written by serialize, all tokens get fileName assigned,
+     * returns nullptr when the stream is truncated or malformed
+     */
+    std::unique_ptr<Program> deserialize(std::istream &is, const std::shared_ptr<std::string> &fileName);
+}
+
+#endif
@@ -0,0 +1,206 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Coroutine.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+/* thread sanitizer needs to be told about stack switches, otherwise it reports the
+ * frames of the coroutine as belonging to whichever thread happens to resume it
+ */
+#if defined(__SANITIZE_THREAD__)
+#define LUCI_TSAN_FIBERS
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define LUCI_TSAN_FIBERS
+#endif
+#endif
+
+#ifdef LUCI_TSAN_FIBERS
+extern "C"
+{
+    void *__tsan_get_current_fiber(void);
+    void *__tsan_create_fiber(unsigned flags);
+    void __tsan_destroy_fiber(void *fiber);
+    void __tsan_switch_to_fiber(void *fiber, unsigned flags);
+}
+#endif
+
+namespace
+{
+    thread_local coroutine::Coroutine *currentCoroutine = nullptr;
+}
+
+namespace coroutine
+{
+#ifdef _WIN32
+    struct Coroutine::Context
+    {
+        void *fiber = nullptr;
+        void *caller = nullptr;
+    };
+
+    Coroutine::Coroutine(TBody ibody, size_t stackSize) : body(std::move(ibody)), context(std::make_unique<Context>())
+    {
+        auto entry = [](LPVOID parameter)
+        { run(static_cast<Coroutine *>(parameter)); };
+        context->fiber = CreateFiberEx(0, stackSize, FIBER_FLAG_FLOAT_SWITCH, entry, this);
+        if (!context->fiber)
+            throw std::runtime_error("Failed to create the stack of a coroutine");
+    }
+
+    Coroutine::~Coroutine()
+    {
+        DeleteFiber(context->fiber);
+    }
+
+    void Coroutine::switchIn()
+    {
+        if (!IsThreadAFiber())
+            ConvertThreadToFiber(nullptr);
+        context->caller = GetCurrentFiber();
+        SwitchToFiber(context->fiber);
+    }
+
+    void Coroutine::switchOut()
+    {
+        SwitchToFiber(context->caller);
+    }
+#else
+    struct Coroutine::Context
+    {
+        ucontext_t context;
+        ucontext_t caller;
+        void *memory = nullptr;
+        size_t memorySize = 0;
+#ifdef LUCI_TSAN_FIBERS
+        void *fiber = nullptr;
+        void *callerFiber = nullptr;
+#endif
+    };
+
+    Coroutine::Coroutine(TBody ibody, size_t stackSize) : body(std::move(ibody)), context(std::make_unique<Context>())
+    {
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        stackSize = (stackSize + pageSize - 1) / pageSize * pageSize;
+
+        // the lowest page is kept inaccessible, so that a stack overflow faults instead of corrupting the heap
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+        flags |= MAP_NORESERVE;
+#endif
+        context->memorySize = stackSize + pageSize;
+        context->memory = mmap(nullptr, context->memorySize, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (context->memory == MAP_FAILED)
+            throw std::runtime_error("Failed to allocate the stack of a coroutine");
+        mprotect(context->memory, pageSize, PROT_NONE);
+
+        getcontext(&context->context);
+        context->context.uc_stack.ss_sp = static_cast<char *>(context->memory) + pageSize;
+        context->context.uc_stack.ss_size = stackSize;
+        context->context.uc_link = nullptr;
+
+        // makecontext only passes int arguments, so the pointer to this is split in two halves
+        auto entry = [](unsigned int high, unsigned int low)
+        { run(reinterpret_cast<Coroutine *>(static_cast<uintptr_t>((static_cast<uint64_t>(high) << 32) | low))); };
+        const uint64_t self = reinterpret_cast<uintptr_t>(this);
+        makecontext(&context->context, reinterpret_cast<void (*)()>(static_cast<void (*)(unsigned int, unsigned int)>(entry)), 2,
+                    static_cast<unsigned int>(self >> 32), static_cast<unsigned int>(self & 0xffffffffu));
+#ifdef LUCI_TSAN_FIBERS
+        context->fiber = __tsan_create_fiber(0);
+#endif
+    }
+
+    Coroutine::~Coroutine()
+    {
+#ifdef LUCI_TSAN_FIBERS
+        __tsan_destroy_fiber(context->fiber);
+#endif
+        munmap(context->memory, context->memorySize);
+    }
+
+    void Coroutine::switchIn()
+    {
+#ifdef LUCI_TSAN_FIBERS
+        context->callerFiber = __tsan_get_current_fiber();
+        __tsan_switch_to_fiber(context->fiber, 0);
+#endif
+        swapcontext(&context->caller, &context->context);
+    }
+
+    void Coroutine::switchOut()
+    {
+#ifdef LUCI_TSAN_FIBERS
+        __tsan_switch_to_fiber(context->callerFiber, 0);
+#endif
+        swapcontext(&context->context, &context->caller);
+    }
+#endif
+
+    void Coroutine::run(Coroutine *self)
+    {
+        try
+        {
+            self->body();
+        }
+        catch (...)
+        {
+            self->exception = std::current_exception();
+        }
+
+        // release whatever the body captured now, the coroutine itself may be kept alive much longer
+        self->body = nullptr;
+        self->finished = true;
+        self->switchOut();
+    }
+
+    bool Coroutine::resume()
+    {
+        if (finished)
+            return false;
+        if (running)
+            throw std::logic_error("Coroutine resumed while it is running");
+        if (!isOwnedByCallingThread())
+            throw std::logic_error("Coroutine resumed from another thread than the one that created it");
+
+        started = true;
+        running = true;
+        resumedFrom = currentCoroutine;
+        currentCoroutine = this;
+        switchIn();
+        currentCoroutine = resumedFrom;
+        running = false;
+
+        if (exception)
+            std::rethrow_exception(std::exchange(exception, nullptr));
+        return !finished;
+    }
+
+    void Coroutine::suspend()
+    {
+        auto self = currentCoroutine;
+        if (!self)
+            throw std::logic_error("Coroutine suspended outside of a coroutine");
+        self->switchOut();
+    }
+
+    Coroutine *Coroutine::current()
+    {
+        return currentCoroutine;
+    }
+}
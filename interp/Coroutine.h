@@ -0,0 +1,81 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_COROUTINE_H
+#define GUARDIAN_OF_INCLUSION_COROUTINE_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace coroutine
+{
+    typedef std::function<void()> TBody;
+
+    /* stackful coroutine running body on a stack of its own, so that the body can suspend
+     * from arbitrarily deep within the evaluator and continue later where it left off;
+     * switching is done with ucontext on POSIX systems and with fibers on Windows
+     *
+     * the stack memory is reserved up front but only committed by the system when touched,
+     * so a coroutine costs little more than the frames that are actually live on it
+     *
+     * a coroutine can only be resumed from the thread that created it: the frames of the body
+     * hold on to the thread_local state of that thread, such as the current interpreter, which
+     * another thread would not see.  Destroying a coroutine that did not finish releases its
+     * stack without unwinding it, so the body must be brought to completion first when its
+     * frames own resources
+     */
+    class Coroutine
+    {
+    public:
+        static const size_t defaultStackSize = 8 * 1024 * 1024;
+
+        explicit Coroutine(TBody body, size_t stackSize = defaultStackSize);
+        ~Coroutine();
+
+        Coroutine(const Coroutine &) = delete;
+        Coroutine &operator=(const Coroutine &) = delete;
+
+        /* run the body until it suspends or finishes, returns false once it finished; an
+         * exception escaping the body is rethrown from here, resuming from another thread than
+         * the one that created the coroutine throws std::logic_error
+         */
+        bool resume();
+
+        /* return control from the running coroutine to the one that resumed it */
+        static void suspend();
+
+        /* the coroutine running on the calling thread, nullptr when there is none */
+        static Coroutine *current();
+
+        bool isStarted() const { return started; }
+        bool isRunning() const { return running; }
+        bool isFinished() const { return finished; }
+        bool isOwnedByCallingThread() const { return owner == std::this_thread::get_id(); }
+
+    private:
+        struct Context;
+
+        static void run(Coroutine *self);
+        void switchIn();
+        void switchOut();
+
+        TBody body;
+        std::unique_ptr<Context> context;
+        std::exception_ptr exception;
+        Coroutine *resumedFrom = nullptr; /*< coroutine that was current when this one was resumed */
+        std::thread::id owner = std::this_thread::get_id(); /*< the only thread the coroutine runs on */
+        bool started = false;
+        bool running = false;
+        bool finished = false;
+    };
+}
+
+#endif
@@ -0,0 +1,222 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Luci.h"
+#include "ModuleCache.h"
+
+void testCallScriptFunction()
+{
+    luci::Engine engine;
+    auto script = engine.loadSource("let offset = 10; let score = fn(x : int) -> int { return x * 2 + offset; };");
+    if (script.error())
+        throw std::runtime_error("Expected the script to load, got " + script.error()->inspect());
+
+    auto score = script.function("score");
+    if (!score)
+        throw std::runtime_error("Expected to find function score");
+
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        auto result = score({std::make_shared<obj::Integer>(i)});
+        if (result->type != obj::ObjectType::Integer || static_cast<obj::Integer *>(result.get())->value != i * 2 + 10)
+            throw std::runtime_error("Expected " + std::to_string(i * 2 + 10) + " got " + result->inspect());
+    }
+
+    auto wrongType = score({std::make_shared<obj::String>("a")});
+    if (wrongType->type != obj::ObjectType::Error)
+        throw std::runtime_error("Expected a type error for an argument of the wrong type");
+
+    if (script.function("offset") || script.function("missing"))
+        throw std::runtime_error("Expected no function for a non-function or a missing name");
+}
+
+void testHostFunction()
+{
+    luci::Engine engine;
+    std::vector<int64_t> seen;
+    engine.registerFunction("report", [&seen](const std::vector<std::shared_ptr<obj::Object>> &arguments) -> std::shared_ptr<obj::Object>
+                            {
+                                if (arguments.size() != 1 || arguments[0]->type != obj::ObjectType::Integer)
+                                    throw std::runtime_error("report expects an int");
+                                seen.push_back(static_cast<obj::Integer *>(arguments[0].get())->value);
+                                return std::make_shared<obj::Integer>(static_cast<int64_t>(seen.size())); },
+                            "int", "int");
+
+    auto script = engine.loadSource("let run = fn(n : int) { let count = 0; for (i in range(n)) { count = report(i * i); } return count; };");
+    auto result = script.function("run")({std::make_shared<obj::Integer>(4)});
+    if (result->inspect() != "4" || seen != std::vector<int64_t>{0, 1, 4, 9})
+        throw std::runtime_error("Expected the host function to be called 4 times, got " + result->inspect());
+
+    auto failing = engine.loadSource("let f = fn() { return report(\"x\"); };").function("f")({});
+    if (failing->type != obj::ObjectType::Error)
+        throw std::runtime_error("Expected an exception of the host function to become an error");
+}
+
+void testLoadErrors()
+{
+    luci::Engine engine;
+    if (!engine.loadSource("let = ;").error())
+        throw std::runtime_error("Expected a parsing error");
+    if (!engine.loadSource("let a = 1 / 0;").error())
+        throw std::runtime_error("Expected a runtime error");
+    if (!engine.load("does_not_exist.luci").error())
+        throw std::runtime_error("Expected an error for a missing file");
+}
+
+#ifdef NATIVE_EXAMPLE_DIR
+void testNativeModule()
+{
+    // import looks for modules relative to the current directory
+    auto previousPath = std::filesystem::current_path();
+    std::filesystem::current_path(NATIVE_EXAMPLE_DIR);
+
+    luci::Engine engine;
+    auto script = engine.loadSource("import native_example;"
+                                    "let d = native_example.dot(array_double([1.0, 2.0, 3.0]), array_double([4.0, 5.0, 6.0]));"
+                                    "let acc = native_example.accumulator();"
+                                    "acc.add(1.0); acc.add(4.0);"
+                                    "let m = acc.mean();"
+                                    "let copied = clone(acc); copied.add(7.0);"
+                                    "let copiedMean = copied.mean();"
+                                    "let originalMean = acc.mean();");
+    std::filesystem::current_path(previousPath);
+
+    if (script.error())
+        throw std::runtime_error("Expected the native module to load, got " + script.error()->inspect());
+    if (script.get("d")->type != obj::ObjectType::Double || static_cast<obj::Double *>(script.get("d").get())->value != 32.0)
+        throw std::runtime_error("Expected dot to return 32, got " + script.get("d")->inspect());
+    if (script.get("m")->type != obj::ObjectType::Double || static_cast<obj::Double *>(script.get("m").get())->value != 2.5)
+        throw std::runtime_error("Expected mean to return 2.5, got " + script.get("m")->inspect());
+    if (script.get("copiedMean")->inspect() != "4.000000" || script.get("originalMean")->inspect() != "2.500000")
+        throw std::runtime_error("Expected a clone to copy the data of the native object, got " + script.get("copiedMean")->inspect() + " and " + script.get("originalMean")->inspect());
+    if (script.get("acc")->inspect() != "<accumulator>")
+        throw std::runtime_error("Expected a native object, got " + script.get("acc")->inspect());
+
+    if (!engine.loadSource("import native_missing;").error())
+        throw std::runtime_error("Expected an error for a missing native module");
+}
+#endif
+
+void testReloadReleasesProgram()
+{
+    const auto fileName = (std::filesystem::temp_directory_path() / "luci_embed_reload.luci").string();
+    std::ofstream(fileName) << "let version = 1;\n";
+
+    luci::Engine engine;
+    std::weak_ptr<const cache::LoadedProgram> firstProgram;
+    {
+        auto first = engine.load(fileName);
+        firstProgram = cache::loadProgram(fileName);
+
+        std::ofstream(fileName) << "let version = 2; // a longer second version\n";
+        auto second = engine.load(fileName);
+        if (first.get("version")->inspect() != "1" || second.get("version")->inspect() != "2")
+            throw std::runtime_error("Expected each script to run the version of the file it loaded");
+        if (firstProgram.expired())
+            throw std::runtime_error("Expected the superseded program to stay alive while its script exists");
+    }
+    std::filesystem::remove(fileName);
+    std::filesystem::remove_all(std::filesystem::temp_directory_path() / cache::cacheDirectoryName);
+
+    if (!firstProgram.expired())
+        throw std::runtime_error("Expected the superseded program to be released with its script");
+}
+
+void testBuiltinsPerEngine()
+{
+    // both engines run the same cached syntax tree, only the second one has the host function
+    const auto fileName = (std::filesystem::temp_directory_path() / "luci_embed_builtins.luci").string();
+    std::ofstream(fileName) << "let f = fn() { return greet(); };\n";
+
+    luci::Engine without;
+    luci::Engine with;
+    with.registerFunction("greet", [](const std::vector<std::shared_ptr<obj::Object>> &) -> std::shared_ptr<obj::Object>
+                          { return std::make_shared<obj::String>("hello"); },
+                          "", "str");
+
+    auto script = without.load(fileName);
+    auto missing = script.function("f")({});
+    auto found = with.load(fileName).function("f")({});
+
+    // a name remembered not to be a builtin is looked up again once the engine registers it
+    without.registerFunction("greet", [](const std::vector<std::shared_ptr<obj::Object>> &) -> std::shared_ptr<obj::Object>
+                             { return std::make_shared<obj::String>("hi"); },
+                             "", "str");
+    auto registeredLater = script.function("f")({});
+    std::filesystem::remove(fileName);
+    std::filesystem::remove_all(std::filesystem::temp_directory_path() / cache::cacheDirectoryName);
+
+    if (missing->type != obj::ObjectType::Error)
+        throw std::runtime_error("Expected an error for a host function registered in another engine");
+    if (found->type != obj::ObjectType::String || static_cast<obj::String *>(found.get())->value != "hello")
+        throw std::runtime_error("Expected the host function of the engine, got " + found->inspect());
+    if (registeredLater->type != obj::ObjectType::String || static_cast<obj::String *>(registeredLater.get())->value != "hi")
+        throw std::runtime_error("Expected the host function registered after the first call, got " + registeredLater->inspect());
+}
+
+void testThreadOutlivesEngine()
+{
+    std::promise<int64_t> reported;
+    std::weak_ptr<interp::Interpreter> interpreter;
+    {
+        luci::Engine engine;
+        interpreter = engine.interpreter().shared_from_this();
+        engine.registerFunction("report", [&reported](const std::vector<std::shared_ptr<obj::Object>> &arguments) -> std::shared_ptr<obj::Object>
+                                {
+                                    reported.set_value(static_cast<obj::Integer *>(arguments[0].get())->value);
+                                    return arguments[0]; },
+                                "int", "int");
+        auto script = engine.loadSource("import threading;"
+                                        "let worker = threading::thread(fn() { threading::sleep(0.2); report(len([1, 2, 3])); });"
+                                        "worker.start(); worker.detach();");
+        if (script.error())
+            throw std::runtime_error("Expected the script to load, got " + script.error()->inspect());
+    }
+
+    // the thread still runs in the interpreter of the engine that is gone
+    if (interpreter.expired())
+        throw std::runtime_error("Expected the running thread to keep the interpreter alive");
+    auto result = reported.get_future();
+    if (result.wait_for(std::chrono::seconds(5)) != std::future_status::ready || result.get() != 3)
+        throw std::runtime_error("Expected the detached thread to report 3 after the engine was destructed");
+    for (int i = 0; i < 500 && !interpreter.expired(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (!interpreter.expired())
+        throw std::runtime_error("Expected the interpreter to be released when the thread ended");
+}
+
+int main()
+{
+    try
+    {
+        testCallScriptFunction();
+        testHostFunction();
+        testLoadErrors();
+#ifdef NATIVE_EXAMPLE_DIR
+        testNativeModule();
+#endif
+        testReloadReleasesProgram();
+        testBuiltinsPerEngine();
+        testThreadOutlivesEngine();
+        std::cerr << "All tests passed" << std::endl;
+        return 0;
+    }
+    catch (std::runtime_error &e)
+    {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+    return 1;
+}
@@ -9,10 +9,12 @@
 #include <iostream>
 #include <sstream>
 #include <map>
+#include <thread>
 #include <vector>
 #include "Parser.h"
 #include "Object.h"
 #include "Evaluator.h"
+#include "Interpreter.h"
 
 void testEvalIntegerExpressions()
 {
@@ -28,11 +30,39 @@ void testEvalIntegerExpressions()
         throw std::runtime_error("Expected value 3 got something else");
 }
 
+void testIsolatedInterpreters()
+{
+    // each interpreter evaluates on its own thread and only sees its own arguments
+    std::vector<std::string> outcomes(2);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < outcomes.size(); ++i)
+        threads.emplace_back([i, &outcomes]()
+                             {
+                                 auto interpreter = std::make_shared<interp::Interpreter>();
+                                 interpreter->args = {"isolate" + std::to_string(i)};
+                                 interp::CurrentInterpreter current(interpreter.get());
+
+                                 auto parser = createParser(createLexer("arg()[0]", ""));
+                                 auto program = parser->parseProgram();
+                                 auto environment = std::make_shared<obj::Environment>();
+                                 outcomes[i] = eval(std::move(program), environment)->inspect(); });
+    for (auto &thread : threads)
+        thread.join();
+
+    if (outcomes[0] != "\"isolate0\"" || outcomes[1] != "\"isolate1\"")
+        throw std::runtime_error("Expected each interpreter to see its own arguments, got " + outcomes[0] + " and " + outcomes[1]);
+}
+
 int main()
 {
     try
     {
-        testEvalIntegerExpressions();
+        {
+            auto interpreter = std::make_shared<interp::Interpreter>();
+            interp::CurrentInterpreter current(interpreter.get());
+            testEvalIntegerExpressions();
+        }
+        testIsolatedInterpreters();
         std::cerr << "All tests passed" << std::endl;
         return 0;
     }
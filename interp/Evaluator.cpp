@@ -7,35 +7,51 @@
  *******************************************************************/
 
 #include "Evaluator.h"
+#include "Interpreter.h"
 #include "Version.h"
 #include "Typing.h"
 #include <cmath>
 #include <stdexcept>
 #include <iostream>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <filesystem>
 
 #include "Lexer.h"
 #include "Parser.h"
+#include "ModuleCache.h"
+#include "NativeModule.h"
+#include "Simd.h"
+#include "Sort.h"
 
 #include "Util.h"
 
 #include "builtin/Array.h"
+#include "builtin/Async.h"
+#include "builtin/Channel.h"
 #include "builtin/Dictionary.h"
 #include "builtin/Error.h"
 #include "builtin/ErrorType.h"
 #include "builtin/IO.h"
+#include "builtin/Iter.h"
 #include "builtin/Json.h"
 #include "builtin/Math.h"
+#include "builtin/NdArray.h"
+#include "builtin/Numeric.h"
 #include "builtin/OS.h"
+#include "builtin/Parallel.h"
+#include "builtin/Random.h"
 #include "builtin/Regex.h"
 #include "builtin/Set.h"
 #include "builtin/String.h"
+#include "builtin/Synchronization.h"
 #include "builtin/Freeze.h"
+#include "builtin/Generator.h"
 #include "builtin/Time.h"
 #include "builtin/Thread.h"
+#include "builtin/ThreadPool.h"
 #include "builtin/Threading.h"
 #include "builtin/Typing.h"
 #include "format/Format.h"
@@ -45,7 +61,21 @@ std::shared_ptr<obj::Object> evalFunctionWithArguments(obj::Function *functionOb
 
 obj::Object *evalInfixOperator(TokenType operator_t, obj::Object *left, obj::Object *right);
 
-std::shared_ptr<obj::Object> NullObject(new obj::Null());
+namespace
+{
+    /* the null object is never destructed and handed out through a non-owning reference, so that
+     * returning it does not touch a reference count shared by every thread of every interpreter
+     */
+    std::shared_ptr<obj::Object> makeNullObject()
+    {
+        auto null = new obj::Null();
+        ++null->frozen;
+        null->immortal = true;
+        return std::shared_ptr<obj::Object>(std::shared_ptr<obj::Object>(), null);
+    }
+}
+
+std::shared_ptr<obj::Object> NullObject = makeNullObject();
 
 namespace
 {
@@ -56,8 +86,6 @@ namespace
         return newEnvironment;
     }
 
-    std::vector<std::string> argsFromEnvironment;
-
     /* return a normalized index so it can be used in a non-zero length array/deque */
     size_t normalizedArrayIndex(int64_t userProvidedIndex, size_t arrayLength)
     {
@@ -89,6 +117,19 @@ namespace
             return x * tmp * tmp;
     }
 
+    /* the smallest int divided by -1 does not fit and traps, it wraps around like the other operations */
+    int64_t divide_int(int64_t x, int64_t divisor)
+    {
+        if (divisor == -1)
+            return static_cast<int64_t>(0 - static_cast<uint64_t>(x));
+        return x / divisor;
+    }
+
+    int64_t modulo_int(int64_t x, int64_t divisor)
+    {
+        return divisor == -1 ? 0 : x % divisor;
+    }
+
     bool isValueAssigned(const std::shared_ptr<obj::Object> &rhs)
     {
         switch (rhs->type)
@@ -112,10 +153,14 @@ namespace
         {
         case obj::ObjectType::Array:
             return static_cast<const obj::Array *>(obj)->value.size();
+        case obj::ObjectType::ArrayInt:
+            return static_cast<const obj::ArrayInt *>(obj)->value.size();
         case obj::ObjectType::ArrayDouble:
             return static_cast<const obj::ArrayDouble *>(obj)->value.size();
         case obj::ObjectType::ArrayComplex:
             return static_cast<const obj::ArrayComplex *>(obj)->value.size();
+        case obj::ObjectType::ArrayView:
+            return static_cast<const obj::ArrayView *>(obj)->length;
         }
         throw std::runtime_error("Trying to get length of non-array like type " + toString(obj->type));
     }
@@ -126,22 +171,60 @@ namespace
         {
         case obj::ObjectType::Array:
             return static_cast<const obj::Array *>(obj)->value[index];
+        case obj::ObjectType::ArrayInt:
+            return std::make_shared<obj::Integer>(static_cast<const obj::ArrayInt *>(obj)->value[index]);
         case obj::ObjectType::ArrayDouble:
             return std::make_shared<obj::Double>(static_cast<const obj::ArrayDouble *>(obj)->value[index]);
         case obj::ObjectType::ArrayComplex:
             return std::make_shared<obj::Complex>(static_cast<const obj::ArrayComplex *>(obj)->value[index]);
+        case obj::ObjectType::ArrayView:
+            return static_cast<const obj::ArrayView *>(obj)->element(index);
         }
         throw std::runtime_error("Trying to get element of non-array like type");
     }
 
-}
+    /* a view on the elements of an array-like object selected by a range, a view on a view refers
+     * to the underlying array; only ranges with a positive stride that do not mix negative and
+     * non-negative indices select elements at a fixed distance from each other
+     */
+    std::shared_ptr<obj::Object> makeArrayView(const std::shared_ptr<obj::Object> &arrayObj, const obj::Range *range, const Token &token)
+    {
+        std::shared_ptr<obj::Object> array = arrayObj;
+        size_t offset = 0;
+        size_t stride = 1;
+        if (arrayObj->type == obj::ObjectType::ArrayView)
+        {
+            auto view = static_cast<const obj::ArrayView *>(arrayObj.get());
+            array = view->array;
+            offset = view->offset;
+            stride = view->stride;
+        }
+
+        // the stride is checked before anything is derived from the range, the length and the last index are
+        // computed without overflow for any bounds so that they can be checked against the array afterwards
+        if (range->stride <= 0)
+            return std::make_shared<obj::Error>("View requires a range with a positive stride, got stride=" + std::to_string(range->stride), obj::ErrorType::ValueError, token);
+        if (range->lower >= range->upper)
+            return std::make_shared<obj::ArrayView>(array, offset, 0, stride);
+
+        const size_t arraySize = arrayLikeLength(arrayObj.get());
+        const uint64_t span = static_cast<uint64_t>(range->upper) - static_cast<uint64_t>(range->lower);
+        const uint64_t lastStep = (span - 1) / static_cast<uint64_t>(range->stride);
+        const int64_t length = static_cast<int64_t>(lastStep + 1);
+        const int64_t first = range->lower;
+        const int64_t last = static_cast<int64_t>(static_cast<uint64_t>(range->lower) + lastStep * static_cast<uint64_t>(range->stride));
+        if (first < 0 && last >= 0)
+            return std::make_shared<obj::Error>("View requires a range with only negative or only non-negative indices, got " + range->inspect(), obj::ErrorType::IndexError, token);
+        if (first < -static_cast<int64_t>(arraySize) || last >= static_cast<int64_t>(arraySize))
+            return std::make_shared<obj::Error>("Indexing error, range=" + range->inspect() + ", array size=" + std::to_string(arraySize), obj::ErrorType::IndexError, token);
+
+        const size_t start = normalizedArrayIndex(first, arraySize);
+        return std::make_shared<obj::ArrayView>(array, offset + start * stride, static_cast<size_t>(length), stride * static_cast<size_t>(range->stride));
+    }
 
-void initializeArg(int offset, int argc, char **argv)
-{
-    for (int i = offset; i < argc; ++i)
-        argsFromEnvironment.push_back(std::string(argv[i]));
 }
 
+
 namespace builtin
 {
     std::shared_ptr<obj::Object> exit(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
@@ -185,7 +268,7 @@ namespace builtin
             return std::make_shared<obj::Error>("arg: expected no arguments", obj::ErrorType::TypeError);
 
         std::vector<std::shared_ptr<obj::Object>> values;
-        for (const auto &argument : argsFromEnvironment)
+        for (const auto &argument : interp::Interpreter::current()->args)
             values.push_back(std::make_shared<obj::String>(argument));
         return std::make_shared<obj::Array>(obj::Array(values));
     }
@@ -494,21 +577,18 @@ namespace builtin
         return ioObject;
     }
 
-    std::shared_ptr<obj::Object> run_impl(const std::string &text, const std::string &fileName, const std::shared_ptr<obj::Environment> &environment)
+    std::shared_ptr<obj::Object> run_impl(const std::shared_ptr<const cache::LoadedProgram> &loadedProgram, const std::shared_ptr<obj::Environment> &environment)
     {
-        auto lexer = createLexer(text, fileName);
-        auto parser = createParser(std::move(lexer));
-        auto program = parser->parseProgram();
-
-        if (!parser->errorMsgs.empty())
+        if (!loadedProgram->errorMsgs.empty())
         {
             std::stringstream ss;
-            for (const auto &msg : parser->errorMsgs)
+            for (const auto &msg : loadedProgram->errorMsgs)
                 ss << msg << std::endl;
             return std::make_shared<obj::Error>("run: parsing errors encountered: " + ss.str(), obj::ErrorType::SyntaxError);
         }
 
-        return evalProgram(program.get(), environment);
+        environment->retainProgram(loadedProgram);
+        return evalProgram(loadedProgram->program.get(), environment);
     }
 
     std::shared_ptr<obj::Object> run(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
@@ -523,21 +603,11 @@ namespace builtin
         RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, String, "run: expected argument 1 to be a string");
 
         std::string fileToRun = static_cast<obj::String *>(evaluatedExpr1.get())->value;
-        std::string text;
-        std::string line;
-        std::ifstream inputf;
-        inputf.open(fileToRun);
-        if (inputf.is_open())
-        {
-            while (std::getline(inputf, line))
-                text += line + "\n";
-        }
-        else
-        {
+        auto loadedProgram = cache::loadProgram(fileToRun);
+        if (!loadedProgram)
             return std::make_shared<obj::Error>("run: " + fileToRun + " cannot be read", obj::ErrorType::OSError);
-        }
 
-        return run_impl(text, fileToRun, environment);
+        return run_impl(loadedProgram, environment);
     }
 
     std::shared_ptr<obj::Object> import(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
@@ -553,30 +623,21 @@ namespace builtin
             return std::make_shared<obj::Error>("run: expected argument 1 to be a string", obj::ErrorType::TypeError);
 
         std::string fileToRun = static_cast<obj::String *>(evaluatedExpr1.get())->value;
-        std::string text;
-        std::string line;
-        std::ifstream inputf;
-        inputf.open(fileToRun);
-        if (inputf.is_open())
-        {
-            while (std::getline(inputf, line))
-                text += line + "\n";
-        }
-        else
-        {
+        auto loadedProgram = cache::loadProgram(fileToRun);
+        if (!loadedProgram)
             return std::make_shared<obj::Error>("import: " + fileToRun + " cannot be read", obj::ErrorType::OSError);
-        }
 
         auto newEnvironment = makeNewEnvironment(nullptr);
         auto moduleObj = std::make_shared<obj::Module>();
         moduleObj->environment = newEnvironment;
-        auto runResult = run_impl(text, fileToRun, newEnvironment);
+        auto runResult = run_impl(loadedProgram, newEnvironment);
         if (runResult->type == obj::ObjectType::Error)
             return runResult;
+        // a module can be used from any thread
+        newEnvironment->markShared();
         return moduleObj;
     }
 
-    std::unordered_set<std::string> run_onceRegistry;
     std::shared_ptr<obj::Object> run_once(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
     {
         if (!arguments)
@@ -590,27 +651,24 @@ namespace builtin
             return std::make_shared<obj::Error>("run: expected argument 1 to be a string", obj::ErrorType::TypeError);
 
         std::string fileToRun = static_cast<obj::String *>(evaluatedExpr1.get())->value;
-        std::filesystem::path fileToRunPath = std::filesystem::canonical(std::filesystem::path(fileToRun));
-
-        if (run_onceRegistry.find(fileToRunPath.string()) != run_onceRegistry.end())
-            return NullObject;
-        run_onceRegistry.insert(fileToRunPath.string());
+        std::error_code ec;
+        std::filesystem::path fileToRunPath = std::filesystem::canonical(std::filesystem::path(fileToRun), ec);
+        if (ec)
+            return std::make_shared<obj::Error>("run: " + fileToRun + " cannot be read", obj::ErrorType::OSError);
 
-        std::string text;
-        std::string line;
-        std::ifstream inputf;
-        inputf.open(fileToRun);
-        if (inputf.is_open())
+        // consult the registry before loading, a file that already ran is never read nor parsed again
         {
-            while (std::getline(inputf, line))
-                text += line + "\n";
+            auto interpreter = interp::Interpreter::current();
+            std::lock_guard<std::mutex> lock(interpreter->runOnceMutex);
+            if (!interpreter->runOnceRegistry.insert(fileToRunPath.string()).second)
+                return NullObject;
         }
-        else
-        {
+
+        auto loadedProgram = cache::loadProgram(fileToRun);
+        if (!loadedProgram)
             return std::make_shared<obj::Error>("run: " + fileToRun + " cannot be read", obj::ErrorType::OSError);
-        }
 
-        return run_impl(text, fileToRun, environment);
+        return run_impl(loadedProgram, environment);
     }
 
     namespace
@@ -620,6 +678,7 @@ namespace builtin
             if (environment.outer)
                 collectContextNames(*environment.outer, names);
 
+            auto lock = environment.readLock();
             for (const auto &[key, value] : environment.store)
                 names.push_back(key);
         }
@@ -693,6 +752,22 @@ namespace builtin
                 }
             }
             break;
+            case obj::ObjectType::ArrayInt:
+            {
+                auto arrayInt = static_cast<obj::ArrayInt *>(evaluatedExpr.get());
+                values.reserve(arrayInt->value.size());
+                for (const auto &val : arrayInt->value)
+                    values.push_back(std::make_shared<obj::Integer>(val));
+            }
+            break;
+            case obj::ObjectType::ArrayView:
+            {
+                auto view = static_cast<obj::ArrayView *>(evaluatedExpr.get());
+                values.reserve(view->length);
+                for (size_t i = 0; i < view->length; ++i)
+                    values.push_back(view->element(i));
+            }
+            break;
             default:
                 return std::make_shared<obj::Error>("array: cannot convert first argument", obj::ErrorType::TypeError);
             };
@@ -701,6 +776,45 @@ namespace builtin
         return std::make_shared<obj::Array>(obj::Array(values));
     }
 
+    std::shared_ptr<obj::Object> array_int(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() > 1)
+            return std::make_shared<obj::Error>("array_int: expected at most 1 argument", obj::ErrorType::TypeError);
+
+        std::vector<int64_t> values;
+        if (arguments->size() == 1)
+        {
+            auto typeHintArray = std::make_unique<ast::TypeArray>();
+            typeHintArray->elementType = std::make_unique<ast::TypeIdentifier>("int");
+            auto evalExpr = evalExpression(arguments->front().get(), environment, typeHintArray.get());
+            if (evalExpr->type == obj::ObjectType::ArrayView)
+                evalExpr = evalExpr->clone();
+            if (evalExpr->type == obj::ObjectType::ArrayInt)
+                values = static_cast<obj::ArrayInt *>(evalExpr.get())->value;
+            else if (evalExpr->type == obj::ObjectType::Range)
+                values = static_cast<obj::Range *>(evalExpr.get())->values();
+            else if (evalExpr->type == obj::ObjectType::Array)
+            {
+                const auto &elements = static_cast<obj::Array *>(evalExpr.get())->value;
+                values.reserve(elements.size());
+                for (const auto &element : elements)
+                {
+                    if (element->type != obj::ObjectType::Integer)
+                        return std::make_shared<obj::Error>("array_int: cannot convert element of type " + obj::toString(element->type), obj::ErrorType::TypeError);
+                    values.push_back(static_cast<obj::Integer *>(element.get())->value);
+                }
+            }
+            else if (evalExpr->type == obj::ObjectType::Error)
+                return evalExpr;
+            else
+                return std::make_shared<obj::Error>("array_int: cannot convert argument", obj::ErrorType::TypeError);
+        }
+        return std::make_shared<obj::ArrayInt>(std::move(values));
+    }
+
     std::shared_ptr<obj::Object> array_double(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
     {
         if (!arguments)
@@ -715,12 +829,34 @@ namespace builtin
             auto typeHintArray = std::make_unique<ast::TypeArray>();
             typeHintArray->elementType = std::make_unique<ast::TypeIdentifier>("double");
             auto evalExpr = evalExpression(arguments->front().get(), environment, typeHintArray.get());
+            if (evalExpr->type == obj::ObjectType::ArrayView)
+                evalExpr = evalExpr->clone();
             if (evalExpr->type == obj::ObjectType::ArrayDouble)
                 values = static_cast<obj::ArrayDouble *>(evalExpr.get())->value;
+            else if (evalExpr->type == obj::ObjectType::ArrayInt)
+            {
+                const auto &elements = static_cast<obj::ArrayInt *>(evalExpr.get())->value;
+                values.assign(elements.begin(), elements.end());
+            }
+            else if (evalExpr->type == obj::ObjectType::Array)
+            {
+                // an array that was not constructed as a literal, e.g. by appending to it
+                const auto &elements = static_cast<obj::Array *>(evalExpr.get())->value;
+                values.reserve(elements.size());
+                for (const auto &element : elements)
+                {
+                    if (element->type == obj::ObjectType::Double)
+                        values.push_back(static_cast<obj::Double *>(element.get())->value);
+                    else if (element->type == obj::ObjectType::Integer)
+                        values.push_back(static_cast<double>(static_cast<obj::Integer *>(element.get())->value));
+                    else
+                        return std::make_shared<obj::Error>("array_double: cannot convert element of type " + obj::toString(element->type), obj::ErrorType::TypeError);
+                }
+            }
             else
                 return std::make_shared<obj::Error>("array_double: cannot convert argument", obj::ErrorType::TypeError);
         }
-        return std::make_shared<obj::ArrayDouble>(values);
+        return std::make_shared<obj::ArrayDouble>(std::move(values));
     }
 
     std::shared_ptr<obj::Object> array_complex(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
@@ -737,12 +873,37 @@ namespace builtin
             auto typeHintArray = std::make_unique<ast::TypeArray>();
             typeHintArray->elementType = std::make_unique<ast::TypeIdentifier>("complex");
             auto evalExpr = evalExpression(arguments->front().get(), environment, typeHintArray.get());
+            if (evalExpr->type == obj::ObjectType::ArrayView)
+                evalExpr = evalExpr->clone();
             if (evalExpr->type == obj::ObjectType::ArrayComplex)
                 values = static_cast<obj::ArrayComplex *>(evalExpr.get())->value;
+            else if (evalExpr->type == obj::ObjectType::ArrayInt)
+            {
+                const auto &elements = static_cast<obj::ArrayInt *>(evalExpr.get())->value;
+                values.reserve(elements.size());
+                for (const auto &element : elements)
+                    values.push_back(static_cast<double>(element));
+            }
+            else if (evalExpr->type == obj::ObjectType::Array)
+            {
+                const auto &elements = static_cast<obj::Array *>(evalExpr.get())->value;
+                values.reserve(elements.size());
+                for (const auto &element : elements)
+                {
+                    if (element->type == obj::ObjectType::Complex)
+                        values.push_back(static_cast<obj::Complex *>(element.get())->value);
+                    else if (element->type == obj::ObjectType::Double)
+                        values.push_back(static_cast<obj::Double *>(element.get())->value);
+                    else if (element->type == obj::ObjectType::Integer)
+                        values.push_back(static_cast<double>(static_cast<obj::Integer *>(element.get())->value));
+                    else
+                        return std::make_shared<obj::Error>("array_complex: cannot convert element of type " + obj::toString(element->type), obj::ErrorType::TypeError);
+                }
+            }
             else
                 return std::make_shared<obj::Error>("array_complex: cannot convert argument", obj::ErrorType::TypeError);
         }
-        return std::make_shared<obj::ArrayComplex>(values);
+        return std::make_shared<obj::ArrayComplex>(std::move(values));
     }
 
     std::shared_ptr<obj::Object> complex(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
@@ -858,10 +1019,16 @@ namespace builtin
             return std::make_shared<obj::Integer>(static_cast<obj::String *>(evaluatedExpr.get())->value.size());
         case obj::ObjectType::Array:
             return std::make_shared<obj::Integer>(static_cast<obj::Array *>(evaluatedExpr.get())->value.size());
+        case obj::ObjectType::ArrayInt:
+            return std::make_shared<obj::Integer>(static_cast<obj::ArrayInt *>(evaluatedExpr.get())->value.size());
         case obj::ObjectType::ArrayDouble:
             return std::make_shared<obj::Integer>(static_cast<obj::ArrayDouble *>(evaluatedExpr.get())->value.size());
         case obj::ObjectType::ArrayComplex:
             return std::make_shared<obj::Integer>(static_cast<obj::ArrayComplex *>(evaluatedExpr.get())->value.size());
+        case obj::ObjectType::ArrayView:
+            return std::make_shared<obj::Integer>(static_cast<obj::ArrayView *>(evaluatedExpr.get())->length);
+        case obj::ObjectType::NdArray:
+            return std::make_shared<obj::Integer>(static_cast<obj::NdArray *>(evaluatedExpr.get())->shape.front());
         case obj::ObjectType::Dictionary:
             return std::make_shared<obj::Integer>(static_cast<obj::Dictionary *>(evaluatedExpr.get())->value.size());
         case obj::ObjectType::Set:
@@ -1010,6 +1177,38 @@ namespace builtin
         return obj;
     }
 
+    std::shared_ptr<obj::Object> updateArrayInt(std::shared_ptr<obj::Object> obj, const std::vector<ast::Expression *> &arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        auto arrayObj = dynamic_cast<obj::ArrayInt *>(obj.get());
+        if (!arrayObj)
+            return std::make_shared<obj::Error>("Invalid argument 1 for array update: " + obj::toString(obj->type), obj::ErrorType::TypeError);
+
+        auto indexExpr = std::move(evalExpression(arguments.at(1), environment));
+        if (indexExpr->type == obj::ObjectType::Error)
+            return indexExpr;
+
+        if (indexExpr->type != obj::ObjectType::Integer)
+            return std::make_shared<obj::Error>("Invalid argument 1 for update: " + obj::toString(indexExpr->type), obj::ErrorType::TypeError);
+
+        auto intObj = static_cast<obj::Integer *>(indexExpr.get());
+        size_t arraySize = static_cast<int>(arrayObj->value.size());
+        size_t finalIndex = normalizedArrayIndex(intObj->value, arraySize);
+        if (finalIndex >= arraySize)
+            return std::make_shared<obj::Error>("Indexing error, index=" + std::to_string(intObj->value) + " transformed to " + std::to_string(finalIndex) + ", array size=" + std::to_string(arraySize), obj::ErrorType::IndexError);
+
+        auto validObj = std::move(evalExpression(arguments.at(2), environment));
+        if (validObj->type == obj::ObjectType::Error)
+            return validObj;
+
+        if (validObj->type != obj::ObjectType::Integer)
+        {
+            return std::make_shared<obj::Error>("Invalid argument 1 for update [int]: " + obj::toString(validObj->type), obj::ErrorType::ValueError);
+        }
+
+        arrayObj->value[finalIndex] = static_cast<obj::Integer *>(validObj.get())->value;
+        return obj;
+    }
+
     std::shared_ptr<obj::Object> updateArrayDouble(std::shared_ptr<obj::Object> obj, const std::vector<ast::Expression *> &arguments, const std::shared_ptr<obj::Environment> &environment)
     {
         auto arrayObj = dynamic_cast<obj::ArrayDouble *>(obj.get());
@@ -1075,6 +1274,41 @@ namespace builtin
         return obj;
     }
 
+    std::shared_ptr<obj::Object> updateNdArray(std::shared_ptr<obj::Object> obj, const std::vector<ast::Expression *> &arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        auto arrayObj = static_cast<obj::NdArray *>(obj.get());
+        if (arrayObj->shape.size() != 1)
+            return std::make_shared<obj::Error>("Invalid argument 1 for update: ndarray with " + std::to_string(arrayObj->shape.size()) + " dimensions, index the rows first", obj::ErrorType::TypeError);
+
+        auto indexExpr = std::move(evalExpression(arguments.at(1), environment));
+        if (indexExpr->type == obj::ObjectType::Error)
+            return indexExpr;
+
+        if (indexExpr->type != obj::ObjectType::Integer)
+            return std::make_shared<obj::Error>("Invalid argument 1 for update: " + obj::toString(indexExpr->type), obj::ErrorType::TypeError);
+
+        auto intObj = static_cast<obj::Integer *>(indexExpr.get());
+        size_t arraySize = arrayObj->shape.front();
+        size_t finalIndex = normalizedArrayIndex(intObj->value, arraySize);
+        if (finalIndex >= arraySize)
+            return std::make_shared<obj::Error>("Indexing error, index=" + std::to_string(intObj->value) + " transformed to " + std::to_string(finalIndex) + ", array size=" + std::to_string(arraySize), obj::ErrorType::IndexError);
+
+        auto validObj = std::move(evalExpression(arguments.at(2), environment));
+        if (validObj->type == obj::ObjectType::Error)
+            return validObj;
+
+        double value = 0.0;
+        if (validObj->type == obj::ObjectType::Double)
+            value = static_cast<obj::Double *>(validObj.get())->value;
+        else if (validObj->type == obj::ObjectType::Integer)
+            value = static_cast<double>(static_cast<obj::Integer *>(validObj.get())->value);
+        else
+            return std::make_shared<obj::Error>("Invalid argument 1 for update ndarray: " + obj::toString(validObj->type), obj::ErrorType::ValueError);
+
+        arrayObj->data->value[arrayObj->offset + finalIndex * arrayObj->strides.front()] = value;
+        return obj;
+    }
+
     std::shared_ptr<obj::Object> updateString(std::shared_ptr<obj::Object> obj, const std::vector<ast::Expression *> &arguments, const std::shared_ptr<obj::Environment> &environment)
     {
         auto stringObj = dynamic_cast<obj::String *>(obj.get());
@@ -1139,16 +1373,23 @@ namespace builtin
             return std::make_shared<obj::Error>("update: expected 3 arguments", obj::ErrorType::TypeError);
 
         auto evaluatedExpr = evalExpression(arguments.front(), environment);
+        if (evaluatedExpr->frozen > 0)
+            return std::make_shared<obj::Error>("update expects a non-frozen object", obj::ErrorType::TypeError);
+
         switch (evaluatedExpr->type)
         {
         case obj::ObjectType::Error:
             return evaluatedExpr;
         case obj::ObjectType::Array:
             return updateArray(evaluatedExpr, arguments, environment);
+        case obj::ObjectType::ArrayInt:
+            return updateArrayInt(evaluatedExpr, arguments, environment);
         case obj::ObjectType::ArrayDouble:
             return updateArrayDouble(evaluatedExpr, arguments, environment);
         case obj::ObjectType::ArrayComplex:
             return updateArrayComplex(evaluatedExpr, arguments, environment);
+        case obj::ObjectType::NdArray:
+            return updateNdArray(evaluatedExpr, arguments, environment);
         case obj::ObjectType::Dictionary:
             return updateDictionary(evaluatedExpr, arguments, environment);
         case obj::ObjectType::String:
@@ -1189,6 +1430,7 @@ namespace builtin
         switch (evaluatedExpr->type)
         {
         case obj::ObjectType::Array:
+        case obj::ObjectType::ArrayInt:
         case obj::ObjectType::ArrayDouble:
         case obj::ObjectType::ArrayComplex:
         {
@@ -1217,6 +1459,7 @@ namespace builtin
         case obj::ObjectType::Error:
             return evaluatedExpr;
         case obj::ObjectType::Array:
+        case obj::ObjectType::ArrayInt:
         case obj::ObjectType::ArrayDouble:
         case obj::ObjectType::ArrayComplex:
             break;
@@ -1259,6 +1502,11 @@ namespace builtin
                 values.push_back(arrayObj->value.at(i));
             return std::make_shared<obj::Array>(values);
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto arrayObj = static_cast<obj::ArrayInt *>(evaluatedExpr.get());
+            return std::make_shared<obj::ArrayInt>(std::vector<int64_t>(arrayObj->value.begin() + startValue, arrayObj->value.begin() + stopValue));
+        }
         case obj::ObjectType::ArrayDouble:
         {
             auto arrayObj = static_cast<obj::ArrayDouble *>(evaluatedExpr.get());
@@ -1281,6 +1529,45 @@ namespace builtin
         return std::make_shared<obj::Error>("Slicing general error", obj::ErrorType::TypeError);
     }
 
+    std::shared_ptr<obj::Object> view(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        /* a read-only view on the elements of an array selected by a range, the elements are not copied */
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1 && arguments->size() != 2)
+            return std::make_shared<obj::Error>("view: expected 1 or 2 arguments", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        switch (evaluatedExpr->type)
+        {
+        case obj::ObjectType::Error:
+            return evaluatedExpr;
+        case obj::ObjectType::Array:
+        case obj::ObjectType::ArrayInt:
+        case obj::ObjectType::ArrayDouble:
+        case obj::ObjectType::ArrayComplex:
+        case obj::ObjectType::ArrayView:
+            break;
+        default:
+            return std::make_shared<obj::Error>("Invalid argument for first argument for view: " + obj::toString(evaluatedExpr->type), obj::ErrorType::TypeError);
+        };
+
+        if (arguments->size() == 1)
+        {
+            obj::Range all(0, static_cast<int64_t>(arrayLikeLength(evaluatedExpr.get())), 1);
+            return makeArrayView(evaluatedExpr, &all, arguments->front()->token);
+        }
+
+        auto evaluatedRange = evalExpression(arguments->at(1).get(), environment);
+        if (evaluatedRange->type == obj::ObjectType::Error)
+            return evaluatedRange;
+        if (evaluatedRange->type != obj::ObjectType::Range)
+            return std::make_shared<obj::Error>("Invalid argument for second argument for view: " + obj::toString(evaluatedRange->type) + ", expected range", obj::ErrorType::TypeError);
+
+        return makeArrayView(evaluatedExpr, static_cast<obj::Range *>(evaluatedRange.get()), arguments->at(1)->token);
+    }
+
     std::shared_ptr<obj::Object> rotate(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
     {
         /* rotate an array in-place with given number of places, returns the array */
@@ -1336,6 +1623,7 @@ namespace builtin
         case obj::ObjectType::Error:
             return evaluatedExpr;
         case obj::ObjectType::Array:
+        case obj::ObjectType::ArrayInt:
         case obj::ObjectType::ArrayDouble:
         case obj::ObjectType::ArrayComplex:
             return array_reverse(evaluatedExpr, {});
@@ -1361,6 +1649,114 @@ namespace builtin
         throw std::runtime_error("Failed to compare objects");
     }
 
+    /* the expression of an argument written as key=expression, nullptr for any other argument */
+    ast::Expression *keyArgument(ast::Expression *expression)
+    {
+        auto infixExpr = dynamic_cast<ast::InfixExpression *>(expression);
+        if (!infixExpr || infixExpr->operator_t.type != TokenType::ASSIGN)
+            return nullptr;
+
+        auto identifier = dynamic_cast<ast::Identifier *>(infixExpr->left.get());
+        if (!identifier || identifier->value != "key")
+            return nullptr;
+        return infixExpr->right.get();
+    }
+
+    /* the stable order of the values; ints, doubles and strings are sorted by sorting::order, any other
+     * values are compared with isSmallerThan, which throws when they cannot be compared
+     */
+    std::vector<size_t> stableOrder(const std::vector<std::shared_ptr<obj::Object>> &values)
+    {
+        auto allOfType = [&values](obj::ObjectType type)
+        { return std::all_of(values.begin(), values.end(), [type](const std::shared_ptr<obj::Object> &value)
+                             { return value->type == type; }); };
+
+        if (allOfType(obj::ObjectType::Integer))
+        {
+            std::vector<int64_t> keys(values.size());
+            for (size_t i = 0; i < values.size(); ++i)
+                keys[i] = static_cast<obj::Integer *>(values[i].get())->value;
+            return sorting::order(keys);
+        }
+        if (allOfType(obj::ObjectType::Double))
+        {
+            std::vector<double> keys(values.size());
+            for (size_t i = 0; i < values.size(); ++i)
+                keys[i] = static_cast<obj::Double *>(values[i].get())->value;
+            return sorting::order(keys);
+        }
+        if (allOfType(obj::ObjectType::String))
+        {
+            std::vector<const std::string *> keys(values.size());
+            for (size_t i = 0; i < values.size(); ++i)
+                keys[i] = &static_cast<obj::String *>(values[i].get())->value;
+            return sorting::order(keys);
+        }
+
+        std::vector<size_t> ordering(values.size());
+        for (size_t i = 0; i < ordering.size(); ++i)
+            ordering[i] = i;
+        std::stable_sort(ordering.begin(), ordering.end(), [&values](size_t a, size_t b) -> bool
+                         { return isSmallerThan(values[a], values[b]); });
+        return ordering;
+    }
+
+    std::shared_ptr<obj::Object> elementObject(const std::shared_ptr<obj::Object> &value) { return value; }
+    std::shared_ptr<obj::Object> elementObject(int64_t value) { return std::make_shared<obj::Integer>(value); }
+    std::shared_ptr<obj::Object> elementObject(double value) { return std::make_shared<obj::Double>(value); }
+    std::shared_ptr<obj::Object> elementObject(const std::complex<double> &value) { return std::make_shared<obj::Complex>(value); }
+
+    /* sorts the values by the results of the key function, which is called once for every value; returns
+     * the error of the key function when it fails, the values stay unchanged then
+     */
+    template <typename T>
+    std::shared_ptr<obj::Object> sortByKey(std::vector<T> &values, obj::Function *keyFunction, const std::shared_ptr<obj::Environment> &environment)
+    {
+        std::vector<std::shared_ptr<obj::Object>> keys(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            keys[i] = evalFunctionWithArguments(keyFunction, {elementObject(values[i])}, environment);
+            if (keys[i]->type == obj::ObjectType::Error)
+                return keys[i];
+        }
+
+        const auto ordering = stableOrder(keys);
+        std::vector<T> sortedValues(values.size());
+        for (size_t i = 0; i < ordering.size(); ++i)
+            sortedValues[i] = std::move(values[ordering[i]]);
+        values = std::move(sortedValues);
+        return nullptr;
+    }
+
+    /* evaluates a key=function argument, returns an error when the key is not a function */
+    std::shared_ptr<obj::Object> evalKeyFunction(ast::Expression *keyExpr, const std::string &name, const std::shared_ptr<obj::Environment> &environment)
+    {
+        auto keyFunctionObj = evalExpression(keyExpr, environment);
+        if (keyFunctionObj->type == obj::ObjectType::Error)
+            return keyFunctionObj;
+        if (keyFunctionObj->type != obj::ObjectType::Function)
+            return std::make_shared<obj::Error>(name + ": expected key to be a function", obj::ErrorType::TypeError);
+        return keyFunctionObj;
+    }
+
+    /* sorts the values of an array object by key, the array object is changed in place */
+    std::shared_ptr<obj::Object> sortArrayByKey(obj::Object *arrayObj, obj::Function *keyFunction, const std::shared_ptr<obj::Environment> &environment)
+    {
+        switch (arrayObj->type)
+        {
+        case obj::ObjectType::Array:
+            return sortByKey(static_cast<obj::Array *>(arrayObj)->value, keyFunction, environment);
+        case obj::ObjectType::ArrayInt:
+            return sortByKey(static_cast<obj::ArrayInt *>(arrayObj)->value, keyFunction, environment);
+        case obj::ObjectType::ArrayDouble:
+            return sortByKey(static_cast<obj::ArrayDouble *>(arrayObj)->value, keyFunction, environment);
+        case obj::ObjectType::ArrayComplex:
+            return sortByKey(static_cast<obj::ArrayComplex *>(arrayObj)->value, keyFunction, environment);
+        default:
+            return std::make_shared<obj::Error>("Invalid argument for first argument for sort: " + obj::toString(arrayObj->type), obj::ErrorType::TypeError);
+        }
+    }
+
     std::shared_ptr<obj::Object> sort(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
     {
         if (!arguments)
@@ -1369,6 +1765,32 @@ namespace builtin
         if (arguments->size() > 2)
             return std::make_shared<obj::Error>("sort: expected 1 or 2 arguments", obj::ErrorType::TypeError);
 
+        if (arguments->size() == 2)
+        {
+            if (auto keyExpr = keyArgument(arguments->back().get()))
+            {
+                auto keyFunctionObj = evalKeyFunction(keyExpr, "sort", environment);
+                if (keyFunctionObj->type == obj::ObjectType::Error)
+                    return keyFunctionObj;
+
+                auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+                if (evaluatedExpr->type == obj::ObjectType::Error)
+                    return evaluatedExpr;
+
+                try
+                {
+                    auto keyError = sortArrayByKey(evaluatedExpr.get(), static_cast<obj::Function *>(keyFunctionObj.get()), environment);
+                    if (keyError)
+                        return keyError;
+                }
+                catch (const std::exception & /*e*/)
+                {
+                    return std::make_shared<obj::Boolean>(false);
+                }
+                return std::make_shared<obj::Boolean>(true);
+            }
+        }
+
         obj::Function *customComparator = nullptr;
         std::shared_ptr<obj::Object> customComparatorObj;
         if (arguments->size() == 2)
@@ -1392,13 +1814,13 @@ namespace builtin
                 // line below will deallocate a value when an exception is generated in isSmallerThan
                 // to the best understanding this is a bug in VC, either compiler or STL
                 // std::sort(arrayObj->value.begin(), arrayObj->value.end(), isSmallerThan);
-                std::vector<int> ordering(arrayObj->value.size());
+                std::vector<size_t> ordering(arrayObj->value.size());
                 for (size_t i = 0; i < ordering.size(); ++i)
                     ordering[i] = i;
 
                 if (customComparator)
                 {
-                    std::sort(ordering.begin(), ordering.end(), [environment, customComparator, arrayObj](const int &a, const int &b) -> bool
+                    std::sort(ordering.begin(), ordering.end(), [environment, customComparator, arrayObj](const size_t &a, const size_t &b) -> bool
                               {
                                 auto retValue = evalFunctionWithArguments(customComparator, {arrayObj->value[a], arrayObj->value[b]}, environment);
                                 if (retValue->type == obj::ObjectType::Boolean)
@@ -1407,8 +1829,7 @@ namespace builtin
                 }
                 else
                 {
-                    std::sort(ordering.begin(), ordering.end(), [arrayObj](const int &a, const int &b) -> bool
-                              { return isSmallerThan(arrayObj->value[a], arrayObj->value[b]); });
+                    ordering = stableOrder(arrayObj->value);
                 }
 
                 std::vector<std::shared_ptr<obj::Object>> temp;
@@ -1424,6 +1845,31 @@ namespace builtin
             }
             return std::make_shared<obj::Boolean>(true);
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto arrayObj = dynamic_cast<obj::ArrayInt *>(evaluatedExpr.get());
+            if (customComparator)
+            {
+                try
+                {
+                    std::sort(arrayObj->value.begin(), arrayObj->value.end(), [environment, customComparator, arrayObj](const int64_t &a, const int64_t &b) -> bool
+                              {
+                                auto retValue = evalFunctionWithArguments(customComparator, {std::make_shared<obj::Integer>(a), std::make_shared<obj::Integer>(b)}, environment);
+                                if (retValue->type == obj::ObjectType::Boolean)
+                                    return static_cast<obj::Boolean*>(retValue.get())->value;
+                                throw std::runtime_error("Invalid return type from comparator"); });
+                }
+                catch (std::exception & /*e*/)
+                {
+                    return std::make_shared<obj::Boolean>(false);
+                }
+            }
+            else
+            {
+                sorting::sort(arrayObj->value);
+            }
+            return std::make_shared<obj::Boolean>(true);
+        }
         case obj::ObjectType::ArrayDouble:
         {
             auto arrayObj = dynamic_cast<obj::ArrayDouble *>(evaluatedExpr.get());
@@ -1445,7 +1891,7 @@ namespace builtin
             }
             else
             {
-                std::sort(arrayObj->value.begin(), arrayObj->value.end());
+                sorting::sort(arrayObj->value);
             }
             return std::make_shared<obj::Boolean>(true);
         }
@@ -1483,6 +1929,50 @@ namespace builtin
         if (arguments->size() > 2)
             return std::make_shared<obj::Error>("sorted: expected 1 or 2 arguments", obj::ErrorType::TypeError);
 
+        if (arguments->size() == 2)
+        {
+            if (auto keyExpr = keyArgument(arguments->back().get()))
+            {
+                auto keyFunctionObj = evalKeyFunction(keyExpr, "sorted", environment);
+                if (keyFunctionObj->type == obj::ObjectType::Error)
+                    return keyFunctionObj;
+
+                auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+                if (evaluatedExpr->type == obj::ObjectType::Error)
+                    return evaluatedExpr;
+
+                std::shared_ptr<obj::Object> result;
+                switch (evaluatedExpr->type)
+                {
+                case obj::ObjectType::Array:
+                    result = std::make_shared<obj::Array>(static_cast<obj::Array *>(evaluatedExpr.get())->value);
+                    break;
+                case obj::ObjectType::ArrayInt:
+                    result = std::make_shared<obj::ArrayInt>(static_cast<obj::ArrayInt *>(evaluatedExpr.get())->value);
+                    break;
+                case obj::ObjectType::ArrayDouble:
+                    result = std::make_shared<obj::ArrayDouble>(static_cast<obj::ArrayDouble *>(evaluatedExpr.get())->value);
+                    break;
+                case obj::ObjectType::ArrayComplex:
+                    result = std::make_shared<obj::ArrayComplex>(static_cast<obj::ArrayComplex *>(evaluatedExpr.get())->value);
+                    break;
+                default:
+                    return std::make_shared<obj::Error>("Invalid argument for first argument for sorted: " + obj::toString(evaluatedExpr->type), obj::ErrorType::TypeError);
+                }
+
+                try
+                {
+                    auto keyError = sortArrayByKey(result.get(), static_cast<obj::Function *>(keyFunctionObj.get()), environment);
+                    if (keyError)
+                        return keyError;
+                }
+                catch (const std::exception & /*e*/)
+                {
+                }
+                return result;
+            }
+        }
+
         obj::Function *customComparator = nullptr;
         std::shared_ptr<obj::Object> customComparatorObj;
         if (arguments->size() == 2)
@@ -1509,13 +1999,13 @@ namespace builtin
                 // to the best understanding this is a bug in VC, either compiler or STL
                 // std::sort(arrayObj->value.begin(), arrayObj->value.end(), isSmallerThan);
 
-                std::vector<int> ordering(values.size());
+                std::vector<size_t> ordering(values.size());
                 for (size_t i = 0; i < ordering.size(); ++i)
                     ordering[i] = i;
 
                 if (customComparator)
                 {
-                    std::sort(ordering.begin(), ordering.end(), [environment, customComparator, arrayObj](const int &a, const int &b) -> bool
+                    std::sort(ordering.begin(), ordering.end(), [environment, customComparator, arrayObj](const size_t &a, const size_t &b) -> bool
                               {
                                 auto retValue = evalFunctionWithArguments(customComparator, {arrayObj->value[a], arrayObj->value[b]}, environment);
                                 if (retValue->type == obj::ObjectType::Boolean)
@@ -1524,14 +2014,13 @@ namespace builtin
                 }
                 else
                 {
-                    std::sort(ordering.begin(), ordering.end(), [values](const int &a, const int &b) -> bool
-                              { return isSmallerThan(values[a], values[b]); });
+                    ordering = stableOrder(values);
                 }
 
                 std::vector<std::shared_ptr<obj::Object>> temp;
                 temp.resize(ordering.size());
                 for (size_t i = 0; i < ordering.size(); ++i)
-                    temp[i] = std::move(arrayObj->value[ordering[i]]);
+                    temp[i] = values[ordering[i]];
 
                 values = std::move(temp);
             }
@@ -1541,11 +2030,18 @@ namespace builtin
             }
             return std::make_shared<obj::Array>(values);
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto arrayObj = dynamic_cast<obj::ArrayInt *>(evaluatedExpr.get());
+            std::vector<int64_t> values(arrayObj->value);
+            sorting::sort(values);
+            return std::make_shared<obj::ArrayInt>(std::move(values));
+        }
         case obj::ObjectType::ArrayDouble:
         {
             auto arrayObj = dynamic_cast<obj::ArrayDouble *>(evaluatedExpr.get());
             std::vector<double> values(arrayObj->value);
-            std::sort(values.begin(), values.end());
+            sorting::sort(values);
             return std::make_shared<obj::ArrayDouble>(values);
         }
         default:
@@ -1604,6 +2100,32 @@ namespace builtin
             }
             return std::make_shared<obj::Boolean>(false);
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto arrayObj = dynamic_cast<obj::ArrayInt *>(evaluatedExpr.get());
+            if (customComparator)
+            {
+                try
+                {
+                    const bool isSorted = std::is_sorted(arrayObj->value.begin(), arrayObj->value.end(), [environment, customComparator, arrayObj](const int64_t &a, const int64_t &b) -> bool
+                                                         {
+                                auto retValue = evalFunctionWithArguments(customComparator, {std::make_shared<obj::Integer>(a), std::make_shared<obj::Integer>(b)}, environment);
+                                if (retValue->type == obj::ObjectType::Boolean)
+                                    return static_cast<obj::Boolean*>(retValue.get())->value;
+                                throw std::runtime_error("Invalid return type from comparator"); });
+                    return std::make_shared<obj::Boolean>(isSorted);
+                }
+                catch (std::exception & /*e*/)
+                {
+                    return std::make_shared<obj::Boolean>(false);
+                }
+            }
+            else
+            {
+                const bool isSorted = std::is_sorted(arrayObj->value.begin(), arrayObj->value.end());
+                return std::make_shared<obj::Boolean>(isSorted);
+            }
+        }
         case obj::ObjectType::ArrayDouble:
         {
             auto arrayObj = dynamic_cast<obj::ArrayDouble *>(evaluatedExpr.get());
@@ -1672,6 +2194,7 @@ namespace builtin
         case obj::ObjectType::Error:
             return evaluatedExpr;
         case obj::ObjectType::Array:
+        case obj::ObjectType::ArrayInt:
         case obj::ObjectType::ArrayDouble:
         case obj::ObjectType::ArrayComplex:
             return array_reversed(evaluatedExpr, {});
@@ -1743,10 +2266,16 @@ namespace builtin
         {
         case obj::ObjectType::Array:
             return std::make_shared<obj::ArrayIterator<obj::Array>>(std::dynamic_pointer_cast<obj::Array>(obj), 0);
+        case obj::ObjectType::ArrayInt:
+            return std::make_shared<obj::ArrayIterator<obj::ArrayInt>>(std::dynamic_pointer_cast<obj::ArrayInt>(obj), 0);
         case obj::ObjectType::ArrayDouble:
             return std::make_shared<obj::ArrayIterator<obj::ArrayDouble>>(std::dynamic_pointer_cast<obj::ArrayDouble>(obj), 0);
         case obj::ObjectType::ArrayComplex:
             return std::make_shared<obj::ArrayIterator<obj::ArrayComplex>>(std::dynamic_pointer_cast<obj::ArrayComplex>(obj), 0);
+        case obj::ObjectType::ArrayView:
+            return std::make_shared<obj::ArrayViewIterator>(std::static_pointer_cast<obj::ArrayView>(obj), 0);
+        case obj::ObjectType::NdArray:
+            return std::make_shared<obj::NdArrayIterator>(std::static_pointer_cast<obj::NdArray>(obj), 0);
         case obj::ObjectType::Dictionary:
             return std::make_shared<obj::DictionaryIterator>(std::dynamic_pointer_cast<obj::Dictionary>(obj), static_cast<obj::Dictionary *>(obj.get())->value.begin());
         case obj::ObjectType::Set:
@@ -1755,6 +2284,10 @@ namespace builtin
             return std::make_shared<obj::StringIterator>(std::dynamic_pointer_cast<obj::String>(obj), 0);
         case obj::ObjectType::Range:
             return std::make_shared<obj::RangeIterator>(std::dynamic_pointer_cast<obj::Range>(obj), static_cast<obj::Range *>(obj.get())->lower);
+        case obj::ObjectType::Channel:
+            return std::make_shared<obj::ChannelIterator>(std::dynamic_pointer_cast<obj::Channel>(obj));
+        case obj::ObjectType::Iterator:
+            return obj;
         }
 
         return NullObject;
@@ -1773,212 +2306,183 @@ namespace builtin
 
 namespace
 {
-    std::unordered_map<std::string, std::shared_ptr<obj::Module>> builtinModules;
-
-    void fillBuiltinModules()
-    {
-        // ERROR-TYPE module
-        auto errorTypeBuiltinModule = builtin::makeModuleErrorType();
-        builtinModules.insert_or_assign("error_type", std::move(errorTypeBuiltinModule));
-
-        // MATH module
-        auto mathBuiltinModule = builtin::createMathModule();
-        builtinModules.insert_or_assign("math", std::move(mathBuiltinModule));
-
-        // JSON module
-        auto jsonBuiltinModule = builtin::createJsonModule();
-        builtinModules.insert_or_assign("json", std::move(jsonBuiltinModule));
-
-        // OS module
-        auto osBuiltinModule = builtin::makeModuleOS();
-        builtinModules.insert_or_assign("os", std::move(osBuiltinModule));
-
-        // OS module
-        auto regexBuiltinModule = builtin::createRegexModule();
-        builtinModules.insert_or_assign("regex", std::move(regexBuiltinModule));
-
-        auto timeBuiltinModule = builtin::createTimeModule();
-        builtinModules.insert_or_assign("time", std::move(timeBuiltinModule));
-
-        auto threadingBuiltinModule = builtin::createThreadingModule();
-        builtinModules.insert_or_assign("threading", std::move(threadingBuiltinModule));
-
-        auto typingBuiltinModule = builtin::createTypingModule();
-        builtinModules.insert_or_assign("typing", std::move(typingBuiltinModule));
-    }
-
-    std::unordered_map<obj::ObjectType, std::shared_ptr<obj::BuiltinType>> builtinTypes;
-
-    void fillBuiltinTypes()
-    {
-        // ERROR
-        auto errorBuiltinType = builtin::makeBuiltinTypeError();
-        builtinTypes.insert_or_assign(errorBuiltinType->builtinObjectType, std::move(errorBuiltinType));
-
-        // ARRAY
-        auto arrayBuiltinTypes = builtin::makeBuiltinTypeArrays();
-        for (const auto &arrayBuiltinType : arrayBuiltinTypes)
-        {
-            builtinTypes.insert_or_assign(arrayBuiltinType->builtinObjectType, std::move(arrayBuiltinType));
-        }
-
-        // DICTIONARY
-        auto dictionaryBuiltinType = builtin::makeBuiltinTypeDictionary();
-        builtinTypes.insert_or_assign(dictionaryBuiltinType->builtinObjectType, std::move(dictionaryBuiltinType));
-
-        // IO
-        auto ioBuiltinType = builtin::makeBuiltinTypeIo();
-        builtinTypes.insert_or_assign(ioBuiltinType->builtinObjectType, std::move(ioBuiltinType));
-
-        //  SET
-        auto setBuiltinType = builtin::makeBuiltinTypeSet();
-        builtinTypes.insert_or_assign(setBuiltinType->builtinObjectType, std::move(setBuiltinType));
-
-        // STRING
-        auto stringBuiltinType = builtin::makeBuiltinTypeString();
-        builtinTypes.insert_or_assign(stringBuiltinType->builtinObjectType, std::move(stringBuiltinType));
-
-        // THREAD
-        auto threadBuiltinType = builtin::makeBuiltinTypeThread();
-        builtinTypes.insert_or_assign(threadBuiltinType->builtinObjectType, std::move(threadBuiltinType));
-    }
-
-    std::unordered_map<std::string, std::shared_ptr<obj::Object>> builtins;
+    void fillBuiltinModules(interp::Interpreter &interpreter)
+    {
+        auto &builtinModules = interpreter.builtinModules;
+        builtinModules.try_emplace("async", &builtin::createAsyncModule);
+        builtinModules.try_emplace("error_type", &builtin::makeModuleErrorType);
+        builtinModules.try_emplace("iter", &builtin::createIterModule);
+        builtinModules.try_emplace("math", &builtin::createMathModule);
+        builtinModules.try_emplace("json", &builtin::createJsonModule);
+        builtinModules.try_emplace("numeric", &builtin::createNumericModule);
+        builtinModules.try_emplace("os", &builtin::makeModuleOS);
+        builtinModules.try_emplace("random", &builtin::createRandomModule);
+        builtinModules.try_emplace("regex", &builtin::createRegexModule);
+        builtinModules.try_emplace("time", &builtin::createTimeModule);
+        builtinModules.try_emplace("threading", &builtin::createThreadingModule);
+        builtinModules.try_emplace("typing", &builtin::createTypingModule);
+    }
+
+    void fillBuiltinTypes(interp::Interpreter &interpreter)
+    {
+        auto &builtinTypes = interpreter.builtinTypes;
+        builtinTypes.try_emplace(obj::ObjectType::Error, &builtin::makeBuiltinTypeError);
+        for (const auto &arrayType : {obj::ObjectType::Array, obj::ObjectType::ArrayInt, obj::ObjectType::ArrayDouble, obj::ObjectType::ArrayComplex})
+            builtinTypes.try_emplace(arrayType, [arrayType]()
+                                     { return builtin::makeBuiltinTypeArray(arrayType); });
+        builtinTypes.try_emplace(obj::ObjectType::NdArray, &builtin::makeBuiltinTypeNdArray);
+        builtinTypes.try_emplace(obj::ObjectType::Dictionary, &builtin::makeBuiltinTypeDictionary);
+        builtinTypes.try_emplace(obj::ObjectType::IOObject, &builtin::makeBuiltinTypeIo);
+        builtinTypes.try_emplace(obj::ObjectType::Set, &builtin::makeBuiltinTypeSet);
+        builtinTypes.try_emplace(obj::ObjectType::String, &builtin::makeBuiltinTypeString);
+        builtinTypes.try_emplace(obj::ObjectType::Thread, &builtin::makeBuiltinTypeThread);
+        builtinTypes.try_emplace(obj::ObjectType::ThreadPool, &builtin::makeBuiltinTypeThreadPool);
+        builtinTypes.try_emplace(obj::ObjectType::Future, &builtin::makeBuiltinTypeFuture);
+        builtinTypes.try_emplace(obj::ObjectType::Channel, &builtin::makeBuiltinTypeChannel);
+        builtinTypes.try_emplace(obj::ObjectType::Mutex, &builtin::makeBuiltinTypeMutex);
+        builtinTypes.try_emplace(obj::ObjectType::RwLock, &builtin::makeBuiltinTypeRwLock);
+        builtinTypes.try_emplace(obj::ObjectType::LockGuard, &builtin::makeBuiltinTypeLockGuard);
+        builtinTypes.try_emplace(obj::ObjectType::Condition, &builtin::makeBuiltinTypeCondition);
+        builtinTypes.try_emplace(obj::ObjectType::Barrier, &builtin::makeBuiltinTypeBarrier);
+        builtinTypes.try_emplace(obj::ObjectType::AtomicInt, &builtin::makeBuiltinTypeAtomicInt);
+    }
+
+    struct BuiltinDefinition
+    {
+        const char *name;
+        obj::TBuiltinFunction function;
+        const char *argTypes;
+        const char *returnType;
+    };
 
-    void fillBuiltins()
+    void fillBuiltins(interp::Interpreter &interpreter)
     {
-        builtins = std::unordered_map<std::string, std::shared_ptr<obj::Object>>{
+        const std::vector<BuiltinDefinition> builtinDefinitions{
             // all objects - debugging of addresses
-            {"address", builtin::makeBuiltInFunctionObj(&builtin::address, "all", "int")},
+            {"address", &builtin::address, "all", "int"},
             // all objects - debugging of types
-            {"internal_type_str", builtin::makeBuiltInFunctionObj(&builtin::internal_type_str, "all", "str")},
+            {"internal_type_str", &builtin::internal_type_str, "all", "str"},
 
             // dictionary and set support
-            {"lookup_hashable", builtin::makeBuiltInFunctionObj(&builtin::lookup_hashable, "all", "bool")},
-            {"lookup_hash", builtin::makeBuiltInFunctionObj(&builtin::lookup_hash, "all", "int")},
-            {"lookup_equal", builtin::makeBuiltInFunctionObj(&builtin::lookup_equal, "all, all", "bool")},
+            {"lookup_hashable", &builtin::lookup_hashable, "all", "bool"},
+            {"lookup_hash", &builtin::lookup_hash, "all", "int"},
+            {"lookup_equal", &builtin::lookup_equal, "all, all", "bool"},
 
             // iteration and for-loop support
-            //{"iter", builtin::makeBuiltInFunctionObj(&builtin::iter, "all", "iter")},
-            //{"iterable", builtin::makeBuiltInFunctionObj(&builtin::iterable, "all", "bool")},
+            //{"iter", &builtin::iter, "all", "iter"},
+            //{"iterable", &builtin::iterable, "all", "bool"},
 
             // querying for frozen objects
-            {"frozen", builtin::makeBuiltInFunctionObj(&builtin::frozen, "all", "bool")},
-            {"freeze", builtin::makeBuiltInFunctionObj(&builtin::freeze, "all", "all")},
-            {"defrost", builtin::makeBuiltInFunctionObj(&builtin::defrost, "all", "all")},
-            {"freezer", builtin::makeBuiltInFunctionObj(&builtin::freezer, "all", "freezer")},
+            {"frozen", &builtin::frozen, "all", "bool"},
+            {"freeze", &builtin::freeze, "all", "all"},
+            {"defrost", &builtin::defrost, "all", "all"},
+            {"freezer", &builtin::freezer, "all", "freezer"},
+            {"freeze_deep", &builtin::freeze_deep, "all", "all"},
+            {"share", &builtin::share, "all", "all"},
 
             // type system
-            {"type_str", builtin::makeBuiltInFunctionObj(&builtin::type_str, "all", "str")},
-            //{"comparable", builtin::makeBuiltInFunctionObj(&builtin::comparable, "[all]", "bool")},
-            //{"orderable", builtin::makeBuiltInFunctionObj(&builtin::orderable, "[all]", "bool")},
+            {"type_str", &builtin::type_str, "all", "str"},
+            //{"comparable", &builtin::comparable, "[all]", "bool"},
+            //{"orderable", &builtin::orderable, "[all]", "bool"},
 
             // errors
-            {"error", builtin::makeBuiltInFunctionObj(&builtin::error, "str, int", "error")},
+            {"error", &builtin::error, "str, int", "error"},
 
             // duplicating objects
-            {"clone", builtin::makeBuiltInFunctionObj(&builtin::clone, "all", "all")},
+            {"clone", &builtin::clone, "all", "all"},
 
             // documentation
-            {"doc", builtin::makeBuiltInFunctionObj(&builtin::doc, "all", "str")}, /*< extract documentation from functions and properties */
+            {"doc", &builtin::doc, "all", "str"}, /*< extract documentation from functions and properties */
 
             // communication with outside world
-            {"print", builtin::makeBuiltInFunctionObj(&builtin::print, "all", "null")},       /*< print to console on stdout*/
-            {"eprint", builtin::makeBuiltInFunctionObj(&builtin::eprint, "all", "null")},     /*< print to console on stderr*/
-            {"input_line", builtin::makeBuiltInFunctionObj(&builtin::input_line, "", "str")}, /*< grab input from stdin */
-            {"version", builtin::makeBuiltInFunctionObj(&builtin::version, "", "[int]")},     /*< request version as array */
-            {"arg", builtin::makeBuiltInFunctionObj(&builtin::arg, "", "[str]")},             /*< command line args as array */
-            {"format", builtin::makeBuiltInFunctionObj(&builtin::format, "str, all", "str")}, /*< format a string */
+            {"print", &builtin::print, "all", "null"},       /*< print to console on stdout*/
+            {"eprint", &builtin::eprint, "all", "null"},     /*< print to console on stderr*/
+            {"input_line", &builtin::input_line, "", "str"}, /*< grab input from stdin */
+            {"version", &builtin::version, "", "[int]"},     /*< request version as array */
+            {"arg", &builtin::arg, "", "[str]"},             /*< command line args as array */
+            {"format", &builtin::format, "str, all", "str"}, /*< format a string */
 
             // interpreter control
-            {"run", builtin::makeBuiltInFunctionObj(&builtin::run, "str", "null")},
-            {"run_once", builtin::makeBuiltInFunctionObj(&builtin::run_once, "str", "null")},
-            {"exit", builtin::makeBuiltInFunctionObj(&builtin::exit, "int", "null")}, /*< exiting the interpreter */
+            {"run", &builtin::run, "str", "null"},
+            {"run_once", &builtin::run_once, "str", "null"},
+            {"exit", &builtin::exit, "int", "null"}, /*< exiting the interpreter */
 
             // module control
-            {"import", builtin::makeBuiltInFunctionObj(&builtin::import, "str", "module")},
+            {"import", &builtin::import, "str", "module"},
 
             // environment control/query
-            {"scope_names", builtin::makeBuiltInFunctionObj(&builtin::scope_names, "", "[str]")},
+            {"scope_names", &builtin::scope_names, "", "[str]"},
 
             // creation of non-trivial empty builtins and to account for empty sets
             // which have no literal
-            {"array", builtin::makeBuiltInFunctionObj(&builtin::array, "", "[all]")},
-            {"array_double", builtin::makeBuiltInFunctionObj(&builtin::array_double, "", "[double]")},
-            {"array_complex", builtin::makeBuiltInFunctionObj(&builtin::array_complex, "", "[complex]")},
-            {"complex", builtin::makeBuiltInFunctionObj(&builtin::complex, "", "complex")},
-            {"dict", builtin::makeBuiltInFunctionObj(&builtin::dict, "", "{all:all}")},
-            {"set", builtin::makeBuiltInFunctionObj(&builtin::set, "", "{all}")},
+            {"array", &builtin::array, "", "[all]"},
+            {"array_int", &builtin::array_int, "", "[int]"},
+            {"array_double", &builtin::array_double, "", "[double]"},
+            {"array_complex", &builtin::array_complex, "", "[complex]"},
+            {"complex", &builtin::complex, "", "complex"},
+            {"dict", &builtin::dict, "", "{all:all}"},
+            {"set", &builtin::set, "", "{all}"},
 
             // arrays
-            {"append", builtin::makeBuiltInFunctionObj(&builtin::append, "[all], all", "[all]")},
-            {"slice", builtin::makeBuiltInFunctionObj(&builtin::slice, "[all], int, int", "[all]")},
-            {"update", builtin::makeBuiltInFunctionObj(&builtin::update, "[all],int, all", "[all]")},
-            {"rotate", builtin::makeBuiltInFunctionObj(&builtin::rotate, "[all],int", "[all]")},
-            {"reverse", builtin::makeBuiltInFunctionObj(&builtin::reverse, "[all]", "[all]")},
-            {"sort", builtin::makeBuiltInFunctionObj(&builtin::sort, "[all]", "<bool>")},
-            {"reversed", builtin::makeBuiltInFunctionObj(&builtin::reversed, "[all]", "[all]")},
-            {"rotated", builtin::makeBuiltInFunctionObj(&builtin::rotated, "[all], int", "[all]")},
-            {"sorted", builtin::makeBuiltInFunctionObj(&builtin::sorted, "[all]", "[all]")},
-            {"is_sorted", builtin::makeBuiltInFunctionObj(&builtin::is_sorted, "[all]", "bool")},
+            {"append", &builtin::append, "[all], all", "[all]"},
+            {"slice", &builtin::slice, "[all], int, int", "[all]"},
+            {"view", &builtin::view, "[all], range", "[all]"},
+            {"ndarray", &builtin::ndarray, "all, [int]", "ndarray"},
+            {"update", &builtin::update, "[all],int, all", "[all]"},
+            {"rotate", &builtin::rotate, "[all],int", "[all]"},
+            {"reverse", &builtin::reverse, "[all]", "[all]"},
+            {"sort", &builtin::sort, "[all]", "<bool>"},
+            {"reversed", &builtin::reversed, "[all]", "[all]"},
+            {"rotated", &builtin::rotated, "[all], int", "[all]"},
+            {"sorted", &builtin::sorted, "[all]", "[all]"},
+            {"is_sorted", &builtin::is_sorted, "[all]", "bool"},
 
             // ranges
-            {"range", builtin::makeBuiltInFunctionObj(&builtin::range, "int,int", "range")},
+            {"range", &builtin::range, "int,int", "range"},
+
+            // parallel execution on the shared pool of worker threads
+            {"parallel_map", &builtin::parallel_map, "all, all, int", "[all]"},
+            {"parallel_for", &builtin::parallel_for, "range, all", "null"},
 
             // arrays/dictionary/string
-            {"len", builtin::makeBuiltInFunctionObj(&builtin::len, "<[all],{all:all},str>", "int")},
+            {"len", &builtin::len, "<[all],{all:all},str>", "int"},
 
             // dictionary
-            {"values", builtin::makeBuiltInFunctionObj(&builtin::values, "{all:all}", "[all]")},
-            {"keys", builtin::makeBuiltInFunctionObj(&builtin::keys, "{all:all}", "[all]")},
+            {"values", &builtin::values, "{all:all}", "[all]"},
+            {"keys", &builtin::keys, "{all:all}", "[all]"},
 
             // string functions
-            {"to_bool", builtin::makeBuiltInFunctionObj(&builtin::to_bool, "str", "bool")},
-            {"to_int", builtin::makeBuiltInFunctionObj(&builtin::to_int, "str", "int")},
-            {"to_double", builtin::makeBuiltInFunctionObj(&builtin::to_double, "str", "double")},
+            {"to_bool", &builtin::to_bool, "str", "bool"},
+            {"to_int", &builtin::to_int, "str", "int"},
+            {"to_double", &builtin::to_double, "str", "double"},
 
             // io functions
-            {"open", builtin::makeBuiltInFunctionObj(&builtin::open, "str", "io")},
+            {"open", &builtin::open, "str", "io"},
         };
-    }
 
-    void clearBuiltinModules()
-    {
-        builtinModules.clear();
-    }
-
-    void clearBuiltinTypes()
-    {
-        builtinTypes.clear();
-    }
-
-    void clearBuiltins()
-    {
-        builtins.clear();
+        for (const auto &definition : builtinDefinitions)
+            interpreter.builtins.try_emplace(definition.name, [definition]()
+                                 { return builtin::makeBuiltInFunctionObj(definition.function, definition.argTypes, definition.returnType); });
     }
-}
 
-void initialize()
-{
-    fillBuiltins();
-    fillBuiltinTypes();
-    fillBuiltinModules();
 }
 
-void finalize()
+void initialize(interp::Interpreter &interpreter)
 {
-    clearBuiltinModules();
-    clearBuiltinTypes();
-    clearBuiltins();
-
-    NullObject.reset();
+    fillBuiltins(interpreter);
+    fillBuiltinTypes(interpreter);
+    fillBuiltinModules(interpreter);
 }
 
 std::shared_ptr<obj::Object> getBuiltin(const std::string &name)
 {
+    auto interpreter = interp::Interpreter::current();
+    if (!interpreter)
+        return nullptr;
+    auto &builtins = interpreter->builtins;
     auto foundBuiltin = builtins.find(name);
     if (foundBuiltin != builtins.end())
-        return foundBuiltin->second;
+        return foundBuiltin->second.get();
     return nullptr;
 }
 
@@ -1991,18 +2495,25 @@ std::shared_ptr<obj::Object> evalUserObjectDestructors(const std::shared_ptr<obj
     if (!environment)
         throw std::runtime_error("Unexpected NULL environment");
 
-    for (const auto &[varName, tokenSharedObj] : environment->store)
+    // collect first, the destructors are evaluated without holding the lock of a shared environment
+    std::vector<obj::UserObject *> userObjects;
     {
-        if (tokenSharedObj.obj.use_count() == 1 && tokenSharedObj.obj->type == obj::ObjectType::UserObject)
+        auto lock = environment->readLock();
+        for (const auto &[varName, tokenSharedObj] : environment->store)
         {
-            auto userObj = static_cast<obj::UserObject *>(tokenSharedObj.obj.get());
-            auto retValue = userObj->evalAndResetDestructor(environment);
-
-            if (retValue->type == obj::ObjectType::Error || retValue->type == obj::ObjectType::Exit)
-                return retValue;
+            if (tokenSharedObj.obj.use_count() == 1 && tokenSharedObj.obj->type == obj::ObjectType::UserObject)
+                userObjects.push_back(static_cast<obj::UserObject *>(tokenSharedObj.obj.get()));
         }
     }
 
+    for (auto userObj : userObjects)
+    {
+        auto retValue = userObj->evalAndResetDestructor(environment);
+
+        if (retValue->type == obj::ObjectType::Error || retValue->type == obj::ObjectType::Exit)
+            return retValue;
+    }
+
     return NullObject;
 }
 
@@ -2041,7 +2552,8 @@ std::shared_ptr<obj::Object> evalArrayIndexExpression(obj::Array *arrayExpr, std
         auto rangeLiteral = static_cast<obj::Range *>(evaluatedIndex.get());
         std::vector<std::shared_ptr<obj::Object>> ret;
 
-        for (const auto &index : rangeLiteral->values())
+        ret.reserve(rangeLiteral->length());
+        for (int64_t index = rangeLiteral->lower; index < rangeLiteral->upper; index += rangeLiteral->stride)
         {
             size_t finalIndex = normalizedArrayIndex(index, arraySize);
             if (finalIndex >= arraySize)
@@ -2055,6 +2567,45 @@ std::shared_ptr<obj::Object> evalArrayIndexExpression(obj::Array *arrayExpr, std
     };
 }
 
+std::shared_ptr<obj::Object> evalArrayIntIndexExpression(obj::ArrayInt *arrayExpr, std::shared_ptr<obj::Object> evaluatedIndex, ast::IndexExpression *indexExpr)
+{
+    if (!arrayExpr)
+        return std::make_shared<obj::Error>("NULL array", obj::ErrorType::TypeError, indexExpr->token);
+
+    if (arrayExpr->value.empty())
+        return std::make_shared<obj::Error>("Attempting index in empty array", obj::ErrorType::IndexError, indexExpr->token);
+
+    size_t arraySize = static_cast<int>(arrayExpr->value.size());
+    switch (evaluatedIndex->type)
+    {
+    case obj::ObjectType::Integer:
+    {
+        auto intLiteral = static_cast<obj::Integer *>(evaluatedIndex.get());
+        size_t finalIndex = normalizedArrayIndex(intLiteral->value, arraySize);
+        if (finalIndex >= arraySize)
+            return std::make_shared<obj::Error>("Indexing error, index=" + std::to_string(intLiteral->value) + " transformed to " + std::to_string(finalIndex) + ", array size=" + std::to_string(arraySize), obj::ErrorType::IndexError, indexExpr->token);
+        return std::make_shared<obj::Integer>(arrayExpr->value[finalIndex]);
+    }
+    case obj::ObjectType::Range:
+    {
+        auto rangeLiteral = static_cast<obj::Range *>(evaluatedIndex.get());
+        std::vector<int64_t> ret;
+
+        ret.reserve(rangeLiteral->length());
+        for (int64_t index = rangeLiteral->lower; index < rangeLiteral->upper; index += rangeLiteral->stride)
+        {
+            size_t finalIndex = normalizedArrayIndex(index, arraySize);
+            if (finalIndex >= arraySize)
+                return std::make_shared<obj::Error>("Indexing error, index=" + std::to_string(index) + " transformed to " + std::to_string(finalIndex) + ", array size=" + std::to_string(arraySize), obj::ErrorType::IndexError, indexExpr->token);
+            ret.push_back(arrayExpr->value[finalIndex]);
+        }
+        return std::make_shared<obj::ArrayInt>(std::move(ret));
+    }
+    default:
+        return std::make_shared<obj::Error>("Indexing in array must be done with Integer or Range but found " + toString(evaluatedIndex->type), obj::ErrorType::TypeError, indexExpr->token);
+    };
+}
+
 std::shared_ptr<obj::Object> evalArrayDoubleIndexExpression(obj::ArrayDouble *arrayExpr, std::shared_ptr<obj::Object> evaluatedIndex, ast::IndexExpression *indexExpr)
 {
     if (!arrayExpr)
@@ -2079,7 +2630,8 @@ std::shared_ptr<obj::Object> evalArrayDoubleIndexExpression(obj::ArrayDouble *ar
         auto rangeLiteral = static_cast<obj::Range *>(evaluatedIndex.get());
         std::vector<double> ret;
 
-        for (const auto &index : rangeLiteral->values())
+        ret.reserve(rangeLiteral->length());
+        for (int64_t index = rangeLiteral->lower; index < rangeLiteral->upper; index += rangeLiteral->stride)
         {
             size_t finalIndex = normalizedArrayIndex(index, arraySize);
             if (finalIndex >= arraySize)
@@ -2117,7 +2669,8 @@ std::shared_ptr<obj::Object> evalArrayComplexIndexExpression(obj::ArrayComplex *
         auto rangeLiteral = static_cast<obj::Range *>(evaluatedIndex.get());
         std::vector<std::complex<double>> ret;
 
-        for (const auto &index : rangeLiteral->values())
+        ret.reserve(rangeLiteral->length());
+        for (int64_t index = rangeLiteral->lower; index < rangeLiteral->upper; index += rangeLiteral->stride)
         {
             size_t finalIndex = normalizedArrayIndex(index, arraySize);
             if (finalIndex >= arraySize)
@@ -2131,6 +2684,45 @@ std::shared_ptr<obj::Object> evalArrayComplexIndexExpression(obj::ArrayComplex *
     };
 }
 
+std::shared_ptr<obj::Object> evalArrayViewIndexExpression(const std::shared_ptr<obj::Object> &viewObj, std::shared_ptr<obj::Object> evaluatedIndex, ast::IndexExpression *indexExpr)
+{
+    auto view = static_cast<obj::ArrayView *>(viewObj.get());
+    switch (evaluatedIndex->type)
+    {
+    case obj::ObjectType::Integer:
+    {
+        if (view->length == 0)
+            return std::make_shared<obj::Error>("Attempting index in empty array", obj::ErrorType::IndexError, indexExpr->token);
+
+        auto intLiteral = static_cast<obj::Integer *>(evaluatedIndex.get());
+        size_t finalIndex = normalizedArrayIndex(intLiteral->value, view->length);
+        if (finalIndex >= view->length)
+            return std::make_shared<obj::Error>("Indexing error, index=" + std::to_string(intLiteral->value) + " transformed to " + std::to_string(finalIndex) + ", array size=" + std::to_string(view->length), obj::ErrorType::IndexError, indexExpr->token);
+        return view->element(finalIndex);
+    }
+    case obj::ObjectType::Range:
+        return makeArrayView(viewObj, static_cast<obj::Range *>(evaluatedIndex.get()), indexExpr->token);
+    default:
+        return std::make_shared<obj::Error>("Indexing in array must be done with Integer or Range but found " + toString(evaluatedIndex->type), obj::ErrorType::TypeError, indexExpr->token);
+    };
+}
+
+std::shared_ptr<obj::Object> evalNdArrayIndexExpression(obj::NdArray *arrayObj, std::shared_ptr<obj::Object> evaluatedIndex, ast::IndexExpression *indexExpr)
+{
+    if (evaluatedIndex->type != obj::ObjectType::Integer)
+        return std::make_shared<obj::Error>("Indexing in ndarray must be done with Integer but found " + toString(evaluatedIndex->type), obj::ErrorType::TypeError, indexExpr->token);
+
+    size_t arraySize = arrayObj->shape.front();
+    if (arraySize == 0)
+        return std::make_shared<obj::Error>("Attempting index in empty array", obj::ErrorType::IndexError, indexExpr->token);
+
+    auto intLiteral = static_cast<obj::Integer *>(evaluatedIndex.get());
+    size_t finalIndex = normalizedArrayIndex(intLiteral->value, arraySize);
+    if (finalIndex >= arraySize)
+        return std::make_shared<obj::Error>("Indexing error, index=" + std::to_string(intLiteral->value) + " transformed to " + std::to_string(finalIndex) + ", array size=" + std::to_string(arraySize), obj::ErrorType::IndexError, indexExpr->token);
+    return arrayObj->at(finalIndex);
+}
+
 std::shared_ptr<obj::Object> evalStringIndexExpression(obj::String *stringLiteral, std::shared_ptr<obj::Object> evaluatedIndex, ast::IndexExpression *indexExpr)
 {
     if (stringLiteral->value.empty())
@@ -2152,7 +2744,8 @@ std::shared_ptr<obj::Object> evalStringIndexExpression(obj::String *stringLitera
         auto rangeLiteral = static_cast<obj::Range *>(evaluatedIndex.get());
         std::string ret;
 
-        for (const auto &index : rangeLiteral->values())
+        ret.reserve(rangeLiteral->length());
+        for (int64_t index = rangeLiteral->lower; index < rangeLiteral->upper; index += rangeLiteral->stride)
         {
             size_t finalIndex = normalizedArrayIndex(index, stringSize);
             if (finalIndex >= stringSize)
@@ -2180,19 +2773,20 @@ std::shared_ptr<obj::Object> evalRangeIndexExpression(obj::Range *rangeLiteral,
         size_t finalIndex = normalizedArrayIndex(intLiteral->value, rangeSize);
         if (finalIndex >= rangeSize)
             return std::make_shared<obj::Error>("Indexing error, index=" + std::to_string(intLiteral->value) + " transformed to " + std::to_string(finalIndex) + ", range size=" + std::to_string(rangeSize), obj::ErrorType::IndexError, indexExpr->token);
-        return std::make_shared<obj::Integer>(rangeLiteral->values()[finalIndex]);
+        return std::make_shared<obj::Integer>(rangeLiteral->lower + static_cast<int64_t>(finalIndex) * rangeLiteral->stride);
     }
     case obj::ObjectType::Range:
     {
         auto rangeIndexer = static_cast<obj::Range *>(evaluatedIndex.get());
         std::vector<std::shared_ptr<obj::Object>> ret;
 
-        for (const auto &index : rangeIndexer->values())
+        ret.reserve(rangeIndexer->length());
+        for (int64_t index = rangeIndexer->lower; index < rangeIndexer->upper; index += rangeIndexer->stride)
         {
             size_t finalIndex = normalizedArrayIndex(index, rangeSize);
             if (finalIndex >= rangeSize)
                 return std::make_shared<obj::Error>("Indexing error, index=" + std::to_string(index) + " transformed to " + std::to_string(finalIndex) + ", range size=" + std::to_string(rangeSize), obj::ErrorType::IndexError, indexExpr->token);
-            ret.push_back(std::make_shared<obj::Integer>(rangeLiteral->values()[finalIndex]));
+            ret.push_back(std::make_shared<obj::Integer>(rangeLiteral->lower + static_cast<int64_t>(finalIndex) * rangeLiteral->stride));
         }
         return std::make_shared<obj::Array>(ret);
     }
@@ -2212,24 +2806,24 @@ std::shared_ptr<obj::Object> evalDictionaryIndexExpression(obj::Dictionary *dict
     return foundIt->second;
 }
 
-std::shared_ptr<obj::Object> evalIndexExpression(ast::IndexExpression *indexExpr, const std::shared_ptr<obj::Environment> &environment)
+std::shared_ptr<obj::Object> evalIndexedObject(const std::shared_ptr<obj::Object> &evaluatedExpr, const std::shared_ptr<obj::Object> &evaluatedIndex, ast::IndexExpression *indexExpr)
 {
-    std::shared_ptr<obj::Object> evaluatedIndex = std::move(evalExpression(indexExpr->index.get(), environment));
-    if (evaluatedIndex->type == obj::ObjectType::Error)
-        return evaluatedIndex;
-
-    std::shared_ptr<obj::Object> evaluatedExpr = std::move(evalExpression(indexExpr->expression.get(), environment));
-
     switch (evaluatedExpr->type)
     {
     case obj::ObjectType::Error:
         return evaluatedExpr;
     case obj::ObjectType::Array:
         return evalArrayIndexExpression(static_cast<obj::Array *>(evaluatedExpr.get()), evaluatedIndex, indexExpr);
+    case obj::ObjectType::ArrayInt:
+        return evalArrayIntIndexExpression(static_cast<obj::ArrayInt *>(evaluatedExpr.get()), evaluatedIndex, indexExpr);
     case obj::ObjectType::ArrayDouble:
         return evalArrayDoubleIndexExpression(static_cast<obj::ArrayDouble *>(evaluatedExpr.get()), evaluatedIndex, indexExpr);
     case obj::ObjectType::ArrayComplex:
         return evalArrayComplexIndexExpression(static_cast<obj::ArrayComplex *>(evaluatedExpr.get()), evaluatedIndex, indexExpr);
+    case obj::ObjectType::ArrayView:
+        return evalArrayViewIndexExpression(evaluatedExpr, evaluatedIndex, indexExpr);
+    case obj::ObjectType::NdArray:
+        return evalNdArrayIndexExpression(static_cast<obj::NdArray *>(evaluatedExpr.get()), evaluatedIndex, indexExpr);
     case obj::ObjectType::Dictionary:
         return evalDictionaryIndexExpression(static_cast<obj::Dictionary *>(evaluatedExpr.get()), evaluatedIndex, indexExpr);
     case obj::ObjectType::String:
@@ -2241,6 +2835,16 @@ std::shared_ptr<obj::Object> evalIndexExpression(ast::IndexExpression *indexExpr
     };
 }
 
+std::shared_ptr<obj::Object> evalIndexExpression(ast::IndexExpression *indexExpr, const std::shared_ptr<obj::Environment> &environment)
+{
+    std::shared_ptr<obj::Object> evaluatedIndex = std::move(evalExpression(indexExpr->index.get(), environment));
+    if (evaluatedIndex->type == obj::ObjectType::Error)
+        return evaluatedIndex;
+
+    std::shared_ptr<obj::Object> evaluatedExpr = std::move(evalExpression(indexExpr->expression.get(), environment));
+    return evalIndexedObject(evaluatedExpr, evaluatedIndex, indexExpr);
+}
+
 std::shared_ptr<obj::Object> evalMemberExpression(ast::MemberExpression *memberExpression, const std::shared_ptr<obj::Environment> &environment)
 {
     auto expr = evalExpression(memberExpression->expr.get(), environment);
@@ -2257,19 +2861,32 @@ std::shared_ptr<obj::Object> evalMemberExpression(ast::MemberExpression *memberE
     }
 
     auto exprType = expr->type;
-    auto builtinTypeIt = builtinTypes.find(exprType);
-    if (builtinTypeIt != builtinTypes.end())
+    obj::BuiltinType *builtinType = nullptr;
+    if (exprType == obj::ObjectType::NativeObject)
+    {
+        // types of native modules bring their own members
+        builtinType = static_cast<obj::NativeObject *>(expr.get())->nativeType.get();
+    }
+    else
+    {
+        auto &builtinTypes = interp::Interpreter::current()->builtinTypes;
+        auto builtinTypeIt = builtinTypes.find(exprType);
+        if (builtinTypeIt != builtinTypes.end())
+            builtinType = builtinTypeIt->second.get().get();
+    }
+
+    if (builtinType)
     {
         /* Functions have precedence over properties
          * when looking for a name.
          */
-        auto memberFunctionIt = builtinTypeIt->second->functions.find(memberExpression->value.value);
-        if (memberFunctionIt != builtinTypeIt->second->functions.end())
+        auto memberFunctionIt = builtinType->functions.find(memberExpression->value.value);
+        if (memberFunctionIt != builtinType->functions.end())
         {
             return std::make_shared<obj::BoundBuiltinTypeFunction>(expr, memberFunctionIt->second.function, memberFunctionIt->second.functionType);
         }
-        auto propertyIt = builtinTypeIt->second->properties.find(memberExpression->value.value);
-        if (propertyIt != builtinTypeIt->second->properties.end())
+        auto propertyIt = builtinType->properties.find(memberExpression->value.value);
+        if (propertyIt != builtinType->properties.end())
         {
             return std::make_shared<obj::BoundBuiltinTypeProperty>(expr, &propertyIt->second);
         }
@@ -2433,9 +3050,11 @@ obj::Object *evalIntegerInfixOperator(TokenType operator_t, obj::Integer *left,
     case TokenType::SLASH:
         if (right->value == 0)
             return new obj::Error("Division by 0", obj::ErrorType::ValueError);
-        return new obj::Integer(left->value / right->value);
+        return new obj::Integer(divide_int(left->value, right->value));
     case TokenType::PERCENT:
-        return new obj::Integer(left->value % right->value);
+        if (right->value == 0)
+            return new obj::Error("Modulo by 0", obj::ErrorType::ValueError);
+        return new obj::Integer(modulo_int(left->value, right->value));
     case TokenType::DOUBLEASTERISK:
         return new obj::Integer(pow_int(left->value, right->value));
     case TokenType::GT:
@@ -2630,6 +3249,11 @@ bool arrayEq(const obj::Array *left, const obj::Array *right)
     return true;
 }
 
+bool arrayEq(const obj::ArrayInt *left, const obj::ArrayInt *right)
+{
+    return left->value == right->value;
+}
+
 bool arrayEq(const obj::ArrayDouble *left, const obj::ArrayDouble *right)
 {
     const size_t leftSize = left->value.size();
@@ -2715,6 +3339,19 @@ obj::Object *evalArrayInfixOperator(TokenType operator_t, obj::Object *left, obj
     return new obj::Error("Cannot use operator " + toString(operator_t) + " on Array types", obj::ErrorType::TypeError);
 }
 
+obj::Object *evalArrayIntInfixOperator(TokenType operator_t, obj::Object *left, obj::Object *right)
+{
+    auto leftArr = static_cast<obj::ArrayInt *>(left);
+    auto rightArr = static_cast<obj::ArrayInt *>(right);
+
+    if (operator_t == TokenType::EQ)
+        return new obj::Boolean(arrayEq(leftArr, rightArr));
+    if (operator_t == TokenType::N_EQ)
+        return new obj::Boolean(!arrayEq(leftArr, rightArr));
+
+    return new obj::Error("Cannot use operator " + toString(operator_t) + " on Array types", obj::ErrorType::TypeError);
+}
+
 obj::Object *evalArrayDoubleInfixOperator(TokenType operator_t, obj::Object *left, obj::Object *right)
 {
     auto leftArr = dynamic_cast<obj::ArrayDouble *>(left);
@@ -2741,6 +3378,200 @@ obj::Object *evalArrayComplexInfixOperator(TokenType operator_t, obj::Object *le
     return new obj::Error("Cannot use operator " + toString(operator_t) + " on Array types", obj::ErrorType::TypeError);
 }
 
+bool toElementwiseOperation(TokenType operator_t, simd::Operation &operation)
+{
+    switch (operator_t)
+    {
+    case TokenType::PLUS:
+    case TokenType::PLUSASSIGN:
+        operation = simd::Operation::Add;
+        return true;
+    case TokenType::MINUS:
+    case TokenType::MINUSASSIGN:
+        operation = simd::Operation::Subtract;
+        return true;
+    case TokenType::ASTERISK:
+    case TokenType::ASTERISKASSIGN:
+        operation = simd::Operation::Multiply;
+        return true;
+    case TokenType::SLASH:
+    case TokenType::SLASHASSIGN:
+        operation = simd::Operation::Divide;
+        return true;
+    }
+    return false;
+}
+
+bool isRealScalar(const obj::Object *obj)
+{
+    return obj->type == obj::ObjectType::Integer || obj->type == obj::ObjectType::Double;
+}
+
+double toRealScalar(const obj::Object *obj)
+{
+    if (obj->type == obj::ObjectType::Integer)
+        return static_cast<double>(static_cast<const obj::Integer *>(obj)->value);
+    return static_cast<const obj::Double *>(obj)->value;
+}
+
+std::vector<std::complex<double>> toComplexValues(const obj::ArrayDouble *arr)
+{
+    return std::vector<std::complex<double>>(arr->value.begin(), arr->value.end());
+}
+
+std::vector<double> toDoubleValues(const obj::ArrayInt *arr)
+{
+    return std::vector<double>(arr->value.begin(), arr->value.end());
+}
+
+bool isIntegerOperand(const obj::Object *obj)
+{
+    return obj->type == obj::ObjectType::ArrayInt || obj->type == obj::ObjectType::Integer;
+}
+
+obj::Object *makeLengthMismatchError(TokenType operator_t, size_t leftSize, size_t rightSize)
+{
+    return new obj::Error("Cannot use operator " + toString(operator_t) + " on arrays of length " + std::to_string(leftSize) + " and " + std::to_string(rightSize), obj::ErrorType::ValueError);
+}
+
+/* elementwise operators on array_int and int operands, the result is an array_int and division
+ * rounds towards zero as it does for ints
+ */
+obj::Object *evalArrayIntElementwiseInfixOperator(TokenType operator_t, simd::Operation operation, obj::Object *left, obj::Object *right)
+{
+    const std::vector<int64_t> *leftValues = left->type == obj::ObjectType::ArrayInt ? &static_cast<obj::ArrayInt *>(left)->value : nullptr;
+    const std::vector<int64_t> *rightValues = right->type == obj::ObjectType::ArrayInt ? &static_cast<obj::ArrayInt *>(right)->value : nullptr;
+
+    if (operation == simd::Operation::Divide)
+    {
+        const bool divisionByZero = rightValues ? std::find(rightValues->begin(), rightValues->end(), 0) != rightValues->end()
+                                                : static_cast<obj::Integer *>(right)->value == 0;
+        if (divisionByZero)
+            return new obj::Error("Division by 0", obj::ErrorType::ValueError);
+    }
+
+    if (leftValues && rightValues)
+    {
+        if (leftValues->size() != rightValues->size())
+            return makeLengthMismatchError(operator_t, leftValues->size(), rightValues->size());
+
+        std::vector<int64_t> result(leftValues->size());
+        simd::apply(operation, leftValues->data(), rightValues->data(), result.data(), result.size());
+        return new obj::ArrayInt(std::move(result));
+    }
+    if (leftValues)
+    {
+        std::vector<int64_t> result(leftValues->size());
+        simd::apply(operation, leftValues->data(), static_cast<obj::Integer *>(right)->value, result.data(), result.size());
+        return new obj::ArrayInt(std::move(result));
+    }
+    std::vector<int64_t> result(rightValues->size());
+    simd::apply(operation, static_cast<obj::Integer *>(left)->value, rightValues->data(), result.data(), result.size());
+    return new obj::ArrayInt(std::move(result));
+}
+
+/* elementwise +, -, * and / with at least one array_int, array_double or array_complex operand, the
+ * other operand is an array of the same length or an int, double or complex scalar.  An array_int
+ * stays an array_int with an int or another array_int, with any other operand it is promoted like
+ * an array_double is promoted to array_complex.  Returns nullptr when the operator or the operands
+ * do not qualify
+ */
+obj::Object *evalElementwiseInfixOperator(TokenType operator_t, obj::Object *left, obj::Object *right)
+{
+    simd::Operation operation;
+    if (!toElementwiseOperation(operator_t, operation))
+        return nullptr;
+
+    std::unique_ptr<obj::ArrayDouble> leftIntPromoted, rightIntPromoted;
+    if (left->type == obj::ObjectType::ArrayInt || right->type == obj::ObjectType::ArrayInt)
+    {
+        if (isIntegerOperand(left) && isIntegerOperand(right))
+            return evalArrayIntElementwiseInfixOperator(operator_t, operation, left, right);
+
+        if (left->type == obj::ObjectType::ArrayInt)
+            left = (leftIntPromoted = std::make_unique<obj::ArrayDouble>(toDoubleValues(static_cast<obj::ArrayInt *>(left)))).get();
+        if (right->type == obj::ObjectType::ArrayInt)
+            right = (rightIntPromoted = std::make_unique<obj::ArrayDouble>(toDoubleValues(static_cast<obj::ArrayInt *>(right)))).get();
+    }
+
+    const bool leftIsArray = left->type == obj::ObjectType::ArrayDouble || left->type == obj::ObjectType::ArrayComplex;
+    const bool rightIsArray = right->type == obj::ObjectType::ArrayDouble || right->type == obj::ObjectType::ArrayComplex;
+    const bool leftIsScalar = isRealScalar(left) || left->type == obj::ObjectType::Complex;
+    const bool rightIsScalar = isRealScalar(right) || right->type == obj::ObjectType::Complex;
+    if (!(leftIsArray && (rightIsArray || rightIsScalar)) && !(leftIsScalar && rightIsArray))
+        return nullptr;
+
+    const bool isComplex = left->type == obj::ObjectType::ArrayComplex || left->type == obj::ObjectType::Complex ||
+                           right->type == obj::ObjectType::ArrayComplex || right->type == obj::ObjectType::Complex;
+    if (!isComplex)
+    {
+        if (leftIsArray && rightIsArray)
+        {
+            const auto &leftValues = static_cast<obj::ArrayDouble *>(left)->value;
+            const auto &rightValues = static_cast<obj::ArrayDouble *>(right)->value;
+            if (leftValues.size() != rightValues.size())
+                return makeLengthMismatchError(operator_t, leftValues.size(), rightValues.size());
+
+            std::vector<double> result(leftValues.size());
+            simd::apply(operation, leftValues.data(), rightValues.data(), result.data(), result.size());
+            return new obj::ArrayDouble(std::move(result));
+        }
+        if (leftIsArray)
+        {
+            const auto &leftValues = static_cast<obj::ArrayDouble *>(left)->value;
+            std::vector<double> result(leftValues.size());
+            simd::apply(operation, leftValues.data(), toRealScalar(right), result.data(), result.size());
+            return new obj::ArrayDouble(std::move(result));
+        }
+        const auto &rightValues = static_cast<obj::ArrayDouble *>(right)->value;
+        std::vector<double> result(rightValues.size());
+        simd::apply(operation, toRealScalar(left), rightValues.data(), result.data(), result.size());
+        return new obj::ArrayDouble(std::move(result));
+    }
+
+    // array_double operands of a complex operation are promoted, the scalars are converted
+    std::vector<std::complex<double>> leftPromoted, rightPromoted;
+    const std::vector<std::complex<double>> *leftValues = nullptr;
+    const std::vector<std::complex<double>> *rightValues = nullptr;
+    std::complex<double> leftScalar, rightScalar;
+    if (left->type == obj::ObjectType::ArrayComplex)
+        leftValues = &static_cast<obj::ArrayComplex *>(left)->value;
+    else if (left->type == obj::ObjectType::ArrayDouble)
+        leftValues = &(leftPromoted = toComplexValues(static_cast<obj::ArrayDouble *>(left)));
+    else if (left->type == obj::ObjectType::Complex)
+        leftScalar = static_cast<obj::Complex *>(left)->value;
+    else
+        leftScalar = toRealScalar(left);
+
+    if (right->type == obj::ObjectType::ArrayComplex)
+        rightValues = &static_cast<obj::ArrayComplex *>(right)->value;
+    else if (right->type == obj::ObjectType::ArrayDouble)
+        rightValues = &(rightPromoted = toComplexValues(static_cast<obj::ArrayDouble *>(right)));
+    else if (right->type == obj::ObjectType::Complex)
+        rightScalar = static_cast<obj::Complex *>(right)->value;
+    else
+        rightScalar = toRealScalar(right);
+
+    if (leftValues && rightValues)
+    {
+        if (leftValues->size() != rightValues->size())
+            return makeLengthMismatchError(operator_t, leftValues->size(), rightValues->size());
+
+        std::vector<std::complex<double>> result(leftValues->size());
+        simd::apply(operation, leftValues->data(), rightValues->data(), result.data(), result.size());
+        return new obj::ArrayComplex(std::move(result));
+    }
+    if (leftValues)
+    {
+        std::vector<std::complex<double>> result(leftValues->size());
+        simd::apply(operation, leftValues->data(), rightScalar, result.data(), result.size());
+        return new obj::ArrayComplex(std::move(result));
+    }
+    std::vector<std::complex<double>> result(rightValues->size());
+    simd::apply(operation, leftScalar, rightValues->data(), result.data(), result.size());
+    return new obj::ArrayComplex(std::move(result));
+}
+
 obj::Object *evalDictionaryInfixOperator(TokenType operator_t, obj::Object *left, obj::Object *right)
 {
     auto leftDict = dynamic_cast<obj::Dictionary *>(left);
@@ -2827,7 +3658,10 @@ bool evalOpInteger(obj::Integer *integer, TokenType operator_t, const std::share
     }
     case TokenType::SLASHASSIGN:
     {
-        integer->value /= rightValue->value;
+        // division by 0 is reported by the infix operator
+        if (rightValue->value == 0)
+            return false;
+        integer->value = divide_int(integer->value, rightValue->value);
         return true;
     }
     case TokenType::ASTERISKASSIGN:
@@ -2871,6 +3705,93 @@ bool evalOpDouble(obj::Double *doubleObj, TokenType operator_t, const std::share
     return false;
 }
 
+bool evalOpArrayInt(obj::ArrayInt *arrayObj, TokenType operator_t, const std::shared_ptr<obj::Object> &right)
+{
+    simd::Operation operation;
+    if (!toElementwiseOperation(operator_t, operation))
+        return false;
+
+    auto &values = arrayObj->value;
+    if (right->type == obj::ObjectType::ArrayInt)
+    {
+        const auto &rightValues = static_cast<obj::ArrayInt *>(right.get())->value;
+        if (rightValues.size() != values.size())
+            return false;
+        if (operation == simd::Operation::Divide && std::find(rightValues.begin(), rightValues.end(), 0) != rightValues.end())
+            return false;
+        simd::apply(operation, values.data(), rightValues.data(), values.data(), values.size());
+        return true;
+    }
+    if (right->type == obj::ObjectType::Integer)
+    {
+        const int64_t rightValue = static_cast<obj::Integer *>(right.get())->value;
+        if (operation == simd::Operation::Divide && rightValue == 0)
+            return false;
+        simd::apply(operation, values.data(), rightValue, values.data(), values.size());
+        return true;
+    }
+    return false;
+}
+
+bool evalOpArrayDouble(obj::ArrayDouble *arrayObj, TokenType operator_t, const std::shared_ptr<obj::Object> &right)
+{
+    simd::Operation operation;
+    if (!toElementwiseOperation(operator_t, operation))
+        return false;
+
+    auto &values = arrayObj->value;
+    if (right->type == obj::ObjectType::ArrayDouble)
+    {
+        const auto &rightValues = static_cast<obj::ArrayDouble *>(right.get())->value;
+        if (rightValues.size() != values.size())
+            return false;
+        simd::apply(operation, values.data(), rightValues.data(), values.data(), values.size());
+        return true;
+    }
+    if (isRealScalar(right.get()))
+    {
+        simd::apply(operation, values.data(), toRealScalar(right.get()), values.data(), values.size());
+        return true;
+    }
+    return false;
+}
+
+bool evalOpArrayComplex(obj::ArrayComplex *arrayObj, TokenType operator_t, const std::shared_ptr<obj::Object> &right)
+{
+    simd::Operation operation;
+    if (!toElementwiseOperation(operator_t, operation))
+        return false;
+
+    auto &values = arrayObj->value;
+    if (right->type == obj::ObjectType::ArrayComplex)
+    {
+        const auto &rightValues = static_cast<obj::ArrayComplex *>(right.get())->value;
+        if (rightValues.size() != values.size())
+            return false;
+        simd::apply(operation, values.data(), rightValues.data(), values.data(), values.size());
+        return true;
+    }
+    if (right->type == obj::ObjectType::ArrayDouble)
+    {
+        const auto rightValues = toComplexValues(static_cast<obj::ArrayDouble *>(right.get()));
+        if (rightValues.size() != values.size())
+            return false;
+        simd::apply(operation, values.data(), rightValues.data(), values.data(), values.size());
+        return true;
+    }
+    if (right->type == obj::ObjectType::Complex)
+    {
+        simd::apply(operation, values.data(), static_cast<obj::Complex *>(right.get())->value, values.data(), values.size());
+        return true;
+    }
+    if (isRealScalar(right.get()))
+    {
+        simd::apply(operation, values.data(), std::complex<double>(toRealScalar(right.get())), values.data(), values.size());
+        return true;
+    }
+    return false;
+}
+
 bool evalOpAssignmentOperatorObject(obj::Object *object, TokenType operator_t, const std::shared_ptr<obj::Object> &right)
 {
     bool succeeded = false;
@@ -2880,6 +3801,14 @@ bool evalOpAssignmentOperatorObject(obj::Object *object, TokenType operator_t, c
         return evalOpInteger(static_cast<obj::Integer *>(object), operator_t, right);
     case obj::ObjectType::Double:
         return evalOpDouble(static_cast<obj::Double *>(object), operator_t, right);
+    case obj::ObjectType::ArrayInt:
+        return evalOpArrayInt(static_cast<obj::ArrayInt *>(object), operator_t, right);
+    case obj::ObjectType::ArrayDouble:
+        return evalOpArrayDouble(static_cast<obj::ArrayDouble *>(object), operator_t, right);
+    case obj::ObjectType::ArrayComplex:
+        return evalOpArrayComplex(static_cast<obj::ArrayComplex *>(object), operator_t, right);
+    case obj::ObjectType::NdArray:
+        return builtin::evalOpNdArray(static_cast<obj::NdArray *>(object), operator_t, right);
     default:
         return false;
     }
@@ -2891,6 +3820,8 @@ std::shared_ptr<obj::Object> evalOpAssignmentOperator(ast::Identifier *identifie
     auto identifierObj = environment->get(identifier->value);
     if (identifierObj->type == obj::ObjectType::Error)
         return identifierObj;
+    if (identifierObj->frozen > 0)
+        return std::make_shared<obj::Error>("Cannot use operator " + toString(operator_t) + " on frozen object", obj::ErrorType::TypeError);
 
     bool succeeded = evalOpAssignmentOperatorObject(identifierObj.get(), operator_t, right);
     if (!succeeded)
@@ -2920,16 +3851,24 @@ std::shared_ptr<obj::Object> evalMemberAssignmentExpression(ast::MemberExpressio
         return rhv;
 
     obj::TPropertyObj *property = nullptr;
+    obj::Object *owner = nullptr;
     if (objPropToAssignInto->type == obj::ObjectType::BoundBuiltinTypeProperty)
         property = static_cast<obj::BoundBuiltinTypeProperty *>(objPropToAssignInto.get())->property;
     else if (objPropToAssignInto->type == obj::ObjectType::BoundUserTypeProperty)
-        property = static_cast<obj::BoundUserTypeProperty *>(objPropToAssignInto.get())->property;
+    {
+        auto boundProperty = static_cast<obj::BoundUserTypeProperty *>(objPropToAssignInto.get());
+        property = boundProperty->property;
+        owner = boundProperty->boundTo.get();
+    }
 
     if (property)
     {
         if (property->constant)
             return std::make_shared<obj::Error>("Cannot update const member " + memberExpr->value.text(), obj::ErrorType::TypeError, memberExpr->token);
 
+        if (owner && owner->frozen > 0)
+            return std::make_shared<obj::Error>("Cannot update member " + memberExpr->value.text() + " of frozen object", obj::ErrorType::TypeError, memberExpr->token);
+
         if (!typing::isCompatibleType(property->type, rhv.get(), property->obj.get()))
             return std::make_shared<obj::Error>("Incompatible type " + property->type->text() + " for " + rhv->inspect(), obj::ErrorType::TypeError);
 
@@ -2946,11 +3885,79 @@ std::shared_ptr<obj::Object> evalIndexOpAssignmentExpression(ast::IndexExpressio
 {
     /* Before passing in the rightExpr make sure we are passing in an obj with the proper value.
      */
-    std::shared_ptr<obj::Object> objToAssignInto = std::move(evalIndexExpression(indexExpr, environment));
+    std::shared_ptr<obj::Object> evaluatedIndex = std::move(evalExpression(indexExpr->index.get(), environment));
+    if (evaluatedIndex->type == obj::ObjectType::Error)
+        return evaluatedIndex;
+    std::shared_ptr<obj::Object> container = std::move(evalExpression(indexExpr->expression.get(), environment));
+
+    // the elements of array_int, array_double, array_complex and ndarray are values, the element (or the elements
+    // selected by a range) is updated as a copy and stored back
+    const bool isValueArray = container->type == obj::ObjectType::ArrayInt || container->type == obj::ObjectType::ArrayDouble ||
+                              container->type == obj::ObjectType::ArrayComplex || container->type == obj::ObjectType::NdArray;
+    if (isValueArray && container->frozen > 0)
+        return std::make_shared<obj::Error>("Cannot use operator " + toString(operator_t) + " on frozen object", obj::ErrorType::TypeError);
+
+    std::shared_ptr<obj::Object> objToAssignInto = std::move(evalIndexedObject(container, evaluatedIndex, indexExpr));
+    if (objToAssignInto->type == obj::ObjectType::Error)
+        return objToAssignInto;
+    if (objToAssignInto->frozen > 0)
+        return std::make_shared<obj::Error>("Cannot use operator " + toString(operator_t) + " on frozen object", obj::ErrorType::TypeError);
     std::shared_ptr<obj::Object> rhv = std::move(evalExpression(rightExpr, environment));
     bool succeeded = evalOpAssignmentOperatorObject(objToAssignInto.get(), operator_t, rhv);
     if (!succeeded)
         return std::make_shared<obj::Error>("Cannot use operator " + toString(operator_t) + " on type" + obj::toString(objToAssignInto->type), obj::ErrorType::TypeError);
+
+    if (isValueArray && evaluatedIndex->type == obj::ObjectType::Integer)
+    {
+        const int64_t index = static_cast<obj::Integer *>(evaluatedIndex.get())->value;
+        if (container->type == obj::ObjectType::ArrayInt)
+        {
+            auto &values = static_cast<obj::ArrayInt *>(container.get())->value;
+            values[normalizedArrayIndex(index, values.size())] = static_cast<obj::Integer *>(objToAssignInto.get())->value;
+        }
+        else if (container->type == obj::ObjectType::NdArray)
+        {
+            // the rows of an ndarray with more dimensions share its elements and are already updated
+            auto arrayObj = static_cast<obj::NdArray *>(container.get());
+            if (objToAssignInto->type == obj::ObjectType::Double)
+                arrayObj->data->value[arrayObj->offset + normalizedArrayIndex(index, arrayObj->shape.front()) * arrayObj->strides.front()] = static_cast<obj::Double *>(objToAssignInto.get())->value;
+        }
+        else if (container->type == obj::ObjectType::ArrayDouble)
+        {
+            auto &values = static_cast<obj::ArrayDouble *>(container.get())->value;
+            values[normalizedArrayIndex(index, values.size())] = static_cast<obj::Double *>(objToAssignInto.get())->value;
+        }
+    }
+    else if (isValueArray && evaluatedIndex->type == obj::ObjectType::Range)
+    {
+        // indexing with a range gave a copy of the selected elements, which are stored back one by one
+        const auto indices = static_cast<obj::Range *>(evaluatedIndex.get())->values();
+        if (container->type == obj::ObjectType::ArrayInt && objToAssignInto->type == obj::ObjectType::ArrayInt)
+        {
+            auto &values = static_cast<obj::ArrayInt *>(container.get())->value;
+            const auto &updated = static_cast<obj::ArrayInt *>(objToAssignInto.get())->value;
+            for (size_t i = 0; i < indices.size(); ++i)
+                values[normalizedArrayIndex(indices[i], values.size())] = updated[i];
+        }
+        else if (container->type == obj::ObjectType::ArrayDouble && objToAssignInto->type == obj::ObjectType::ArrayDouble)
+        {
+            auto &values = static_cast<obj::ArrayDouble *>(container.get())->value;
+            const auto &updated = static_cast<obj::ArrayDouble *>(objToAssignInto.get())->value;
+            for (size_t i = 0; i < indices.size(); ++i)
+                values[normalizedArrayIndex(indices[i], values.size())] = updated[i];
+        }
+        else if (container->type == obj::ObjectType::ArrayComplex && objToAssignInto->type == obj::ObjectType::ArrayComplex)
+        {
+            auto &values = static_cast<obj::ArrayComplex *>(container.get())->value;
+            const auto &updated = static_cast<obj::ArrayComplex *>(objToAssignInto.get())->value;
+            for (size_t i = 0; i < indices.size(); ++i)
+                values[normalizedArrayIndex(indices[i], values.size())] = updated[i];
+        }
+        else
+            return std::make_shared<obj::Error>("Cannot use operator " + toString(operator_t) + " on a range of type " + obj::toString(container->type), obj::ErrorType::TypeError);
+    }
+    else if (isValueArray)
+        return std::make_shared<obj::Error>("Cannot use operator " + toString(operator_t) + " on type " + obj::toString(container->type) + " indexed by " + obj::toString(evaluatedIndex->type), obj::ErrorType::TypeError);
     return objToAssignInto;
 }
 
@@ -2961,6 +3968,23 @@ obj::Object *evalInfixOperator(TokenType operator_t, obj::Object *left, obj::Obj
     if (!right)
         return new obj::Error(toString(operator_t) + " has no right-hand object", obj::ErrorType::TypeError);
 
+    // a view takes part in an operator like a copy of its elements would
+    if (left->type == obj::ObjectType::ArrayView || right->type == obj::ObjectType::ArrayView)
+    {
+        auto leftCopy = left->type == obj::ObjectType::ArrayView ? left->clone() : nullptr;
+        auto rightCopy = right->type == obj::ObjectType::ArrayView ? right->clone() : nullptr;
+        return evalInfixOperator(operator_t, leftCopy ? leftCopy.get() : left, rightCopy ? rightCopy.get() : right);
+    }
+
+    if (left->type == obj::ObjectType::NdArray || right->type == obj::ObjectType::NdArray)
+    {
+        if (auto ndarrayResult = builtin::evalNdArrayInfixOperator(operator_t, left, right))
+            return ndarrayResult;
+    }
+
+    if (auto elementwiseResult = evalElementwiseInfixOperator(operator_t, left, right))
+        return elementwiseResult;
+
     switch (left->type)
     {
     case obj::ObjectType::Integer:
@@ -3007,6 +4031,14 @@ obj::Object *evalInfixOperator(TokenType operator_t, obj::Object *left, obj::Obj
             return evalAnyArrayInfixOperator(operator_t, left, right);
         break;
     }
+    case obj::ObjectType::ArrayInt:
+    {
+        if (right->type == obj::ObjectType::ArrayInt)
+            return evalArrayIntInfixOperator(operator_t, left, right);
+        else
+            return evalAnyArrayInfixOperator(operator_t, left, right);
+        break;
+    }
     case obj::ObjectType::ArrayDouble:
     {
         if (right->type == obj::ObjectType::ArrayDouble)
@@ -3018,7 +4050,7 @@ obj::Object *evalInfixOperator(TokenType operator_t, obj::Object *left, obj::Obj
     case obj::ObjectType::ArrayComplex:
     {
         if (right->type == obj::ObjectType::ArrayComplex)
-            return evalArrayDoubleInfixOperator(operator_t, left, right);
+            return evalArrayComplexInfixOperator(operator_t, left, right);
         else
             return evalAnyArrayInfixOperator(operator_t, left, right);
         break;
@@ -3146,6 +4178,8 @@ std::shared_ptr<obj::Object> evalForExpression(const ast::ForExpression *forExpr
         std::shared_ptr<obj::Object> iteratorValue = iter->next();
         if (iteratorValue->type == obj::ObjectType::Error)
             return addTokenInCaseOfError(iteratorValue, forExpr->statement->token);
+        if (iteratorValue->type == obj::ObjectType::Exit)
+            return iteratorValue;
 
         if (!typing::isCompatibleType(forExpr->iterType.get(), iteratorValue.get(), nullptr))
         {
@@ -3197,15 +4231,42 @@ evalFunction(ast::Expression *functionExpression, const std::shared_ptr<obj::Env
     else
         functionName = functionExpression->text();
 
+    auto &builtins = interp::Interpreter::current()->builtins;
     auto builtInFn = builtins.find(functionName);
     if (builtInFn != builtins.end())
-        return builtInFn->second;
+        return builtInFn->second.get();
 
     return environment->get(functionName);
 }
 
+std::shared_ptr<obj::Object> evalHostFunction(obj::Builtin *builtin, std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+{
+    std::vector<std::shared_ptr<obj::Object>> evaluatedArgs;
+    evaluatedArgs.reserve(arguments->size());
+    for (const auto &argument : *arguments)
+    {
+        auto evaluatedArg = unwrap(evalExpression(argument.get(), environment));
+        if (evaluatedArg->type == obj::ObjectType::Error)
+            return evaluatedArg;
+        evaluatedArgs.push_back(std::move(evaluatedArg));
+    }
+
+    // exceptions of the host do not cross into the evaluation, they are turned into an error
+    try
+    {
+        auto returnValue = builtin->hostFunction(evaluatedArgs);
+        return returnValue ? returnValue : NullObject;
+    }
+    catch (const std::exception &e)
+    {
+        return std::make_shared<obj::Error>(std::string("host function failed: ") + e.what(), obj::ErrorType::UndefinedError);
+    }
+}
+
 std::shared_ptr<obj::Object> evalBuiltin(obj::Builtin *builtin, std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
 {
+    if (builtin->hostFunction)
+        return evalHostFunction(builtin, arguments, environment);
     return builtin->function(arguments, environment);
 }
 
@@ -3262,6 +4323,28 @@ std::shared_ptr<obj::Object> evalDestructor(obj::Function *functionObj, obj::Use
     return returnValue;
 }
 
+/* calling a generator function does not run its body, it returns a generator that runs
+ * the body in the environment with the bound arguments as values are asked for
+ */
+std::shared_ptr<obj::Object> evalGeneratorFunction(obj::Function *functionObj, const std::shared_ptr<obj::Environment> &functionEnvironment)
+{
+    auto generator = std::make_shared<obj::Generator>([body = functionObj->body, functionEnvironment]()
+                                                      {
+        auto retValue = evalStatement(body, functionEnvironment);
+        auto desRetValue = evalUserObjectDestructors(functionEnvironment);
+        if (desRetValue->type == obj::ObjectType::Error || desRetValue->type == obj::ObjectType::Exit)
+            return desRetValue;
+        return retValue; });
+    generator->self = generator;
+
+    if (!typing::isCompatibleType(functionObj->returnType, generator.get(), nullptr))
+    {
+        std::string expectedTypeStr = functionObj->returnType->text();
+        return std::make_shared<obj::Error>("Incompatible return type, expected " + expectedTypeStr + " but got iterator", obj::ErrorType::TypeError);
+    }
+    return generator;
+}
+
 std::shared_ptr<obj::Object> evalBoundUserTypeFunction(obj::BoundUserTypeFunction *boundUserTypeFunc, ast::CallExpression *callExpr, const std::shared_ptr<obj::Environment> &environment)
 {
     const auto &userObj(boundUserTypeFunc->boundTo);
@@ -3298,6 +4381,9 @@ std::shared_ptr<obj::Object> evalBoundUserTypeFunction(obj::BoundUserTypeFunctio
         }
     }
 
+    if (functionObj->isGenerator)
+        return evalGeneratorFunction(functionObj.get(), functionEnvironment);
+
     auto returnValue = unwrapMemberValue(unwrapReturnValue(evalStatement(functionObj->body, std::move(functionEnvironment))));
     if (returnValue->type == obj::ObjectType::Error)
         return returnValue;
@@ -3342,6 +4428,9 @@ std::shared_ptr<obj::Object> evalFunctionWithArguments(obj::Function *functionOb
         ++argumentIndex;
     }
 
+    if (functionObj->isGenerator)
+        return evalGeneratorFunction(functionObj, functionEnvironment);
+
     //
     // check here the return type of the return value!
     //
@@ -3393,6 +4482,9 @@ std::shared_ptr<obj::Object> evalCallExpression(ast::CallExpression *callExpr, c
             ++argumentIndex;
         }
 
+        if (functionObj->isGenerator)
+            return addTokenInCaseOfError(evalGeneratorFunction(functionObj, functionEnvironment), callExpr->token);
+
         //
         // check here the return type of the return value!
         //
@@ -3479,6 +4571,7 @@ std::shared_ptr<obj::Object> evalFunctionLiteral(ast::FunctionLiteral *funcLiter
     function->doc = funcLiteral->doc;
     function->returnType = funcLiteral->returnType.get();
     function->body = funcLiteral->body.get();
+    function->isGenerator = funcLiteral->isGenerator;
     function->environment = environment;
     return function;
 }
@@ -3511,26 +4604,17 @@ std::shared_ptr<obj::Object> evalTypeLiteral(ast::TypeLiteral *typeLiteral, cons
 
 std::shared_ptr<obj::Object> evalIdentifier(ast::Identifier *identifier, const std::shared_ptr<obj::Environment> &environment)
 {
-    switch (identifier->markedAsBuiltin)
-    {
-    case ast::MarkedAsBuiltin::Unknown:
+    // the syntax tree is shared between interpreters, which each have their own builtins, so a name is only
+    // known not to be a builtin for the version of the builtins it was looked up in
+    auto interpreter = interp::Interpreter::current();
+    if (identifier->notBuiltin.version.load(std::memory_order_relaxed) != interpreter->builtinsVersion)
     {
-        auto builtInFn = builtins.find(identifier->value);
-        if (builtInFn != builtins.end())
-        {
-            identifier->markedAsBuiltin = ast::MarkedAsBuiltin::True;
-            return builtInFn->second;
-        }
-        identifier->markedAsBuiltin = ast::MarkedAsBuiltin::False;
-        return addTokenInCaseOfError(environment->get(identifier->value), identifier->token);
-    }
-    case ast::MarkedAsBuiltin::True:
-        return builtins.at(identifier->value);
-
-    case ast::MarkedAsBuiltin::False:
-        return addTokenInCaseOfError(environment->get(identifier->value), identifier->token);
+        auto builtInFn = interpreter->builtins.find(identifier->value);
+        if (builtInFn != interpreter->builtins.end())
+            return builtInFn->second.get();
+        identifier->notBuiltin.version.store(interpreter->builtinsVersion, std::memory_order_relaxed);
     }
-    return std::make_shared<obj::Error>("Cannot evaluate identifier", obj::ErrorType::TypeError, identifier->token);
+    return addTokenInCaseOfError(environment->get(identifier->value), identifier->token);
 }
 
 std::vector<std::shared_ptr<obj::Object>> objectsFromArrayLiteral(ast::Expression *expression, const std::shared_ptr<obj::Environment> &environment)
@@ -3621,6 +4705,33 @@ std::shared_ptr<obj::Object> evalExpression(ast::Expression *expression, const s
                         }
                         return std::make_shared<obj::Error>("Trying to build an array of wrong type", obj::ErrorType::TypeError);
                     }
+                    else if (typeIdentifier->value == "int")
+                    {
+                        // a type declaration of [int], the elements are read directly from integer literals
+                        // and evaluated otherwise, for example [1+1] still gives an ArrayInt
+                        if (expression->type == ast::NodeType::ArrayLiteral)
+                        {
+                            auto arrayExpr = static_cast<ast::ArrayLiteral *>(expression);
+                            std::vector<int64_t> intValues;
+                            intValues.reserve(arrayExpr->elements.size());
+                            for (const auto &element : arrayExpr->elements)
+                            {
+                                if (element->type == ast::NodeType::IntegerLiteral)
+                                {
+                                    intValues.push_back(static_cast<ast::IntegerLiteral *>(element.get())->value);
+                                    continue;
+                                }
+                                auto object = evalExpression(element.get(), environment);
+                                if (object->type == obj::ObjectType::Error)
+                                    return object;
+                                if (object->type != obj::ObjectType::Integer)
+                                    return std::make_shared<obj::Error>("Trying to build an array of wrong type", obj::ErrorType::TypeError);
+                                intValues.push_back(static_cast<obj::Integer *>(object.get())->value);
+                            }
+                            return std::make_shared<obj::ArrayInt>(std::move(intValues));
+                        }
+                        return std::make_shared<obj::Error>("Trying to build an array of wrong type", obj::ErrorType::TypeError);
+                    }
                     else if (typeIdentifier->value == "complex")
                     {
                         // a type declaration of [double], we can accept a ArrayComplex
@@ -3839,7 +4950,9 @@ std::shared_ptr<obj::Object> evalLetStatement(ast::LetStatement *statement, cons
         retValue = environment->add(statement->name.tokenLiteral(), std::move(exprValue), statement->constant, statement->valueType.get());
     }
 
-    retValue->declaredType = statement->valueType.get();
+    // immortal objects are read by other threads and never written to
+    if (!retValue->immortal)
+        retValue->declaredType = statement->valueType.get();
     if (retValue->type == obj::ObjectType::Error)
         return addTokenInCaseOfError(retValue, statement->token);
 
@@ -3853,7 +4966,7 @@ modulePathToModuleName(const std::vector<std::string> &modulePath)
 }
 
 std::string
-modulePathToModuleFileName(const std::filesystem::path &currentPath, std::vector<std::string> &modulePath)
+modulePathToModuleFileName(const std::filesystem::path &currentPath, std::vector<std::string> &modulePath, const std::string &extension = ".luci")
 {
     if (modulePath.empty())
         return std::string();
@@ -3862,7 +4975,7 @@ modulePathToModuleFileName(const std::filesystem::path &currentPath, std::vector
     for (int i = 0; i < (static_cast<int>(modulePath.size()) - 1); ++i)
         constructedPath /= modulePath[i];
 
-    constructedPath /= modulePath.back() + ".luci";
+    constructedPath /= modulePath.back() + extension;
     return constructedPath.generic_string();
 }
 
@@ -3873,10 +4986,11 @@ std::shared_ptr<obj::Object> evalImportStatement(ast::ImportStatement *statement
     if (statement && environment)
     {
         std::shared_ptr<obj::Module> moduleObj;
-        std::string moduleText;
+        std::shared_ptr<const cache::LoadedProgram> moduleProgram;
 
         auto modulePath = statement->name.path;
         auto localModuleName = modulePathToModuleName(modulePath);
+        auto &builtinModules = interp::Interpreter::current()->builtinModules;
         if (builtinModules.find(modulePath.front()) != builtinModules.end())
         {
             if (logModuleActivity)
@@ -3884,7 +4998,7 @@ std::shared_ptr<obj::Object> evalImportStatement(ast::ImportStatement *statement
 
             // check if the full path exists by walking through the module hierarchy
             auto modulePathToWalk = modulePath;
-            moduleObj = builtinModules.at(modulePath.front());
+            moduleObj = builtinModules.at(modulePath.front()).get();
             for (int modIdx = 1; modIdx < static_cast<int>(modulePath.size()); ++modIdx)
             {
                 if (moduleObj->environment->has(modulePath.at(modIdx)))
@@ -3906,31 +5020,36 @@ std::shared_ptr<obj::Object> evalImportStatement(ast::ImportStatement *statement
                 log.push_back("localModuleName=" + localModuleName);
                 log.push_back("fileName=" + fileName);
             }
-            std::string text;
-            std::string line;
-            std::ifstream inputf;
-            inputf.open(fileName);
-            if (inputf.is_open())
+            moduleProgram = cache::loadProgram(fileName);
+            if (moduleProgram)
             {
-                while (std::getline(inputf, line))
-                    text += line + "\n";
+                auto newEnvironment = makeNewEnvironment(nullptr);
+                moduleObj = std::make_shared<obj::Module>();
+                moduleObj->environment = newEnvironment;
+                moduleObj->fileName = fileName;
+                moduleObj->state = obj::ModuleState::Unknown;
             }
             else
             {
-                if (logModuleActivity)
+                // without a source file the module may be a shared library that registers itself
+                auto nativeFileName = modulePathToModuleFileName(std::filesystem::current_path(), modulePath, native::moduleFileExtension);
+                if (!std::filesystem::exists(nativeFileName))
                 {
-                    log.push_back("fileName not found");
-                    std::cerr << util::join(log, "\n") << std::endl;
+                    if (logModuleActivity)
+                    {
+                        log.push_back("fileName not found");
+                        std::cerr << util::join(log, "\n") << std::endl;
+                    }
+                    return std::make_shared<obj::Error>("import: " + util::join(modulePath, "::") + " failed to import, file " + fileName + " not found", obj::ErrorType::ImportError);
                 }
-                return std::make_shared<obj::Error>("import: " + util::join(modulePath, "::") + " failed to import, file " + fileName + " not found", obj::ErrorType::ImportError);
-            }
 
-            auto newEnvironment = makeNewEnvironment(nullptr);
-            moduleObj = std::make_shared<obj::Module>();
-            moduleObj->environment = newEnvironment;
-            moduleObj->fileName = fileName;
-            moduleObj->state = obj::ModuleState::Unknown;
-            moduleText = std::move(text);
+                if (logModuleActivity)
+                    log.push_back("nativeFileName=" + nativeFileName);
+                auto nativeModule = native::loadModule(nativeFileName);
+                if (nativeModule->type == obj::ObjectType::Error)
+                    return nativeModule;
+                moduleObj = std::static_pointer_cast<obj::Module>(nativeModule);
+            }
         }
 
         std::shared_ptr<obj::Environment> whereToAddModule = environment;
@@ -4008,7 +5127,9 @@ std::shared_ptr<obj::Object> evalImportStatement(ast::ImportStatement *statement
                 return NullObject;
             case obj::ModuleState::Defined:
             {
-                auto runResult = builtin::run_impl(moduleText, moduleObj->fileName, moduleObj->environment);
+                // a native module has been filled by its entry point already
+                const bool isNativeModule = !moduleProgram && moduleObj->state == obj::ModuleState::Loaded;
+                auto runResult = moduleProgram ? builtin::run_impl(moduleProgram, moduleObj->environment) : (isNativeModule ? NullObject : nullptr);
                 if (!runResult)
                 {
                     if (logModuleActivity)
@@ -4028,12 +5149,18 @@ std::shared_ptr<obj::Object> evalImportStatement(ast::ImportStatement *statement
                     return runResult;
                 }
                 moduleObj->state = obj::ModuleState::Loaded;
+                moduleObj->environment->markShared();
 
                 // transfer all previously loaded sub modules into the moduleObj, any conflicts become fatal errors
                 // conflicts may arise when a module has a submodule named foo but also a variable foo
                 // the submodule may succesfully load but later when then loading the parent module becomes a conflict
                 log.push_back(localModuleName + " was a module in Defined state");
-                for (const auto &[name, obj] : existingModule->environment->store)
+                auto definedModuleEntries = [&existingModule]()
+                {
+                    auto lock = existingModule->environment->readLock();
+                    return std::vector<std::pair<std::string, obj::Environment::TTokenSharedObj>>(existingModule->environment->store.begin(), existingModule->environment->store.end());
+                }();
+                for (const auto &[name, obj] : definedModuleEntries)
                 {
                     if (logModuleActivity)
                         log.push_back(" " + name + ":" + obj::toString(obj.obj->type) + " object in defined module");
@@ -4079,7 +5206,7 @@ std::shared_ptr<obj::Object> evalImportStatement(ast::ImportStatement *statement
             if (moduleObj->state == obj::ModuleState::Unknown)
             {
                 // for modules that are builtin, the state will be loaded/defined, so no need to execute the code for them
-                auto runResult = builtin::run_impl(moduleText, moduleObj->fileName, moduleObj->environment);
+                auto runResult = builtin::run_impl(moduleProgram, moduleObj->environment);
                 if (runResult->type == obj::ObjectType::Error)
                 {
                     if (logModuleActivity)
@@ -4089,6 +5216,8 @@ std::shared_ptr<obj::Object> evalImportStatement(ast::ImportStatement *statement
                     }
                     return runResult;
                 }
+                // a module can be used from any thread
+                moduleObj->environment->markShared();
             }
             moduleObj->state = obj::ModuleState::Loaded;
             if (logModuleActivity)
@@ -4135,6 +5264,16 @@ std::shared_ptr<obj::Object> evalStatement(ast::Statement *statement, const std:
         return addTokenInCaseOfError(evalExpression(static_cast<ast::ExpressionStatement *>(statement)->expression.get(), environment), statement->token);
     case ast::NodeType::ReturnStatement:
         return std::make_shared<obj::ReturnValue>(evalExpression(static_cast<ast::ReturnStatement *>(statement)->returnValue.get(), environment));
+    case ast::NodeType::YieldStatement:
+    {
+        auto value = unwrap(evalExpression(static_cast<ast::YieldStatement *>(statement)->value.get(), environment));
+        if (value->type == obj::ObjectType::Error)
+            return value;
+        // the body continues after the yield, so values must not alias the variables it keeps modifying
+        if (isValueAssigned(value))
+            return builtin::yieldValue(value->clone());
+        return builtin::yieldValue(value);
+    }
     case ast::NodeType::BreakStatement:
         return std::make_shared<obj::BreakValue>();
     case ast::NodeType::ContinueStatement:
@@ -25,30 +25,31 @@ std::shared_ptr<obj::Object> unwrap(const std::shared_ptr<obj::Object> &object);
 
 std::shared_ptr<obj::Object> evalFunctionWithArguments(obj::Function *functionObj, const std::vector<std::shared_ptr<obj::Object>> &evaluatedArgs, const std::shared_ptr<obj::Environment> &environment);
 
-/* initialize the internal structures from the outside environment
- * so that the interpreter can return arg when requested
- */
-void initializeArg(int offset, int argc, char **argv);
-
-/* perform initialization tasks, such as populating the
- * internal types and built-in functions
- */
-void initialize();
+namespace interp
+{
+    struct Interpreter;
+}
 
-/* perform finalization tasks, such as clearing the
+/* perform initialization tasks of an interpreter, such as populating its
  * internal types and built-in functions
  */
-void finalize();
+void initialize(interp::Interpreter &interpreter);
 
-/* for typing support builtins are exposed */
+/* for typing support builtins are exposed, looked up in the current interpreter */
 std::shared_ptr<obj::Object> getBuiltin(const std::string &name);
 
-/* shared NullObject that can be pointed to instead of being re-allocated all the time*/
+/* shared NullObject that can be pointed to instead of being re-allocated all the time,
+ * it is immortal and shared by all interpreters of the process
+ */
 extern std::shared_ptr<obj::Object> NullObject;
 
 namespace builtin
 {
     std::shared_ptr<obj::Object> makeBuiltInFunctionObj(obj::TBuiltinFunction fn, const std::string &argTypeStr, const std::string &returnTypeStr);
+
+    /* iterator over the elements of obj as used by the for loop, iterators are returned as is,
+     * returns NullObject when obj cannot be iterated over */
+    std::shared_ptr<obj::Object> iter_impl(const std::shared_ptr<obj::Object> &obj);
 }
 
 #define RETURN_TYPE_ERROR_ON_MISMATCH(expr, expectedType, msg) \
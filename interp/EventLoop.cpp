@@ -0,0 +1,171 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "EventLoop.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace event
+{
+    EventLoop::EventLoop()
+    {
+#ifdef __linux__
+        pollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (pollFd < 0 || wakeupFd < 0)
+            throw std::runtime_error("Failed to create the event loop");
+
+        epoll_event wakeupEvent{};
+        wakeupEvent.events = EPOLLIN;
+        wakeupEvent.data.fd = wakeupFd;
+        epoll_ctl(pollFd, EPOLL_CTL_ADD, wakeupFd, &wakeupEvent);
+#endif
+    }
+
+    EventLoop::~EventLoop()
+    {
+#ifdef __linux__
+        close(wakeupFd);
+        close(pollFd);
+#endif
+    }
+
+    const std::shared_ptr<EventLoop> &EventLoop::current()
+    {
+        thread_local std::shared_ptr<EventLoop> loop = std::make_shared<EventLoop>();
+        return loop;
+    }
+
+    void EventLoop::callLater(double seconds, TCallback callback)
+    {
+        auto delay = std::chrono::duration_cast<TClock::duration>(std::chrono::duration<double>(std::max(0.0, seconds)));
+        timers.push(Timer{TClock::now() + delay, nextTimerSequence++, std::move(callback)});
+    }
+
+    void EventLoop::post(TCallback callback)
+    {
+        {
+            std::lock_guard<std::mutex> lock(postedMutex);
+            posted.push_back(std::move(callback));
+        }
+#ifdef __linux__
+        uint64_t one = 1;
+        [[maybe_unused]] auto written = write(wakeupFd, &one, sizeof(one));
+#else
+        postedCondition.notify_one();
+#endif
+    }
+
+    bool EventLoop::watchReadable(int fd, TCallback callback)
+    {
+#ifdef __linux__
+        epoll_event readEvent{};
+        readEvent.events = EPOLLIN;
+        readEvent.data.fd = fd;
+        if (epoll_ctl(pollFd, EPOLL_CTL_ADD, fd, &readEvent) != 0)
+            return false;
+        watchers.insert_or_assign(fd, std::move(callback));
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void EventLoop::unwatch(int fd)
+    {
+#ifdef __linux__
+        if (watchers.erase(fd) > 0)
+            epoll_ctl(pollFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    }
+
+    std::vector<TCallback> EventLoop::takePosted()
+    {
+        std::lock_guard<std::mutex> lock(postedMutex);
+        std::vector<TCallback> callbacks;
+        callbacks.swap(posted);
+        return callbacks;
+    }
+
+    bool EventLoop::runDueTimers()
+    {
+        bool ranTimer = false;
+        const auto now = TClock::now();
+        while (!timers.empty() && timers.top().due <= now)
+        {
+            auto callback = std::move(const_cast<Timer &>(timers.top()).callback);
+            timers.pop();
+            callback();
+            ranTimer = true;
+        }
+        return ranTimer;
+    }
+
+    void EventLoop::wait(int timeoutMs)
+    {
+#ifdef __linux__
+        epoll_event events[64];
+        int nrEvents = epoll_wait(pollFd, events, 64, timeoutMs);
+        for (int i = 0; i < nrEvents; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == wakeupFd)
+            {
+                uint64_t count = 0;
+                [[maybe_unused]] auto nrRead = read(wakeupFd, &count, sizeof(count));
+                continue;
+            }
+            // copied as the callback is allowed to unwatch its own file descriptor
+            auto watcherIt = watchers.find(fd);
+            if (watcherIt == watchers.end())
+                continue;
+            auto callback = watcherIt->second;
+            callback();
+        }
+#else
+        std::unique_lock<std::mutex> lock(postedMutex);
+        if (timeoutMs < 0)
+            postedCondition.wait(lock, [this]()
+                                 { return !posted.empty(); });
+        else
+            postedCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]()
+                                     { return !posted.empty(); });
+#endif
+    }
+
+    void EventLoop::runOnce()
+    {
+        bool ranCallback = false;
+        for (auto &callback : takePosted())
+        {
+            callback();
+            ranCallback = true;
+        }
+        ranCallback = runDueTimers() || ranCallback;
+
+        // only wait when nothing ran, as the callbacks may have completed what the caller waits for
+        int timeoutMs = -1;
+        if (ranCallback)
+            timeoutMs = 0;
+        else if (!timers.empty())
+        {
+            auto untilDue = std::chrono::duration_cast<std::chrono::milliseconds>(timers.top().due - TClock::now()).count();
+            timeoutMs = static_cast<int>(std::max<int64_t>(0, untilDue + 1));
+        }
+
+        wait(timeoutMs);
+        runDueTimers();
+    }
+}
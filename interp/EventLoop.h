@@ -0,0 +1,89 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_EVENT_LOOP_H
+#define GUARDIAN_OF_INCLUSION_EVENT_LOOP_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace event
+{
+    typedef std::function<void()> TCallback;
+
+    /* single threaded event loop multiplexing timers, readable file descriptors and callbacks
+     * posted from other threads; on Linux the waiting is done with epoll, elsewhere only
+     * timers and posted callbacks are supported and file descriptors cannot be watched
+     *
+     * every thread has its own loop, which only runs while that thread calls runOnce
+     */
+    class EventLoop
+    {
+    public:
+        EventLoop();
+        ~EventLoop();
+
+        EventLoop(const EventLoop &) = delete;
+        EventLoop &operator=(const EventLoop &) = delete;
+
+        /* the loop of the calling thread, created on first use */
+        static const std::shared_ptr<EventLoop> &current();
+
+        /* call callback from the loop after the given number of seconds */
+        void callLater(double seconds, TCallback callback);
+
+        /* call callback from the loop as soon as possible, can be called from any thread */
+        void post(TCallback callback);
+
+        /* call callback from the loop each time fd is readable until unwatch is called,
+         * returns false when watching file descriptors is not supported on the platform
+         */
+        bool watchReadable(int fd, TCallback callback);
+        void unwatch(int fd);
+
+        /* run the callbacks that are due, waiting for the first one to become due when none are */
+        void runOnce();
+
+    private:
+        typedef std::chrono::steady_clock TClock;
+
+        struct Timer
+        {
+            TClock::time_point due;
+            uint64_t sequence; /*< keeps timers with the same due time in order of creation */
+            TCallback callback;
+            bool operator>(const Timer &other) const
+            {
+                return due > other.due || (due == other.due && sequence > other.sequence);
+            }
+        };
+
+        std::vector<TCallback> takePosted();
+        bool runDueTimers();
+        void wait(int timeoutMs);
+
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+        uint64_t nextTimerSequence = 0;
+        std::unordered_map<int, TCallback> watchers;
+
+        std::mutex postedMutex;
+        std::condition_variable postedCondition;
+        std::vector<TCallback> posted;
+
+        int pollFd = -1;   /*< epoll instance */
+        int wakeupFd = -1; /*< eventfd signalled by post */
+    };
+}
+
+#endif
@@ -0,0 +1,325 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Fft.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+
+namespace
+{
+    const double pi = 3.14159265358979323846;
+
+    /* below this length of the shorter input a convolution is computed directly */
+    const size_t directConvolutionLength = 64;
+
+    bool isPowerOfTwo(size_t n)
+    {
+        return n > 0 && (n & (n - 1)) == 0;
+    }
+
+    size_t nextPowerOfTwo(size_t n)
+    {
+        size_t m = 1;
+        while (m < n)
+            m <<= 1;
+        return m;
+    }
+
+    /* the twiddle factors of a real transform of length n, run as a complex transform of length n / 2 */
+    struct RealPlan
+    {
+        std::shared_ptr<const fft::Plan> half;
+        std::vector<std::complex<double>> twiddles; /*< exp(-2 pi i k / n) for k <= n / 2 */
+
+        explicit RealPlan(size_t n) : half(fft::plan(n / 2))
+        {
+            twiddles.reserve(n / 2 + 1);
+            for (size_t k = 0; k <= n / 2; ++k)
+                twiddles.push_back(std::polar(1.0, -2.0 * pi * static_cast<double>(k) / static_cast<double>(n)));
+        }
+    };
+
+    /* the number of plans of each kind that are kept, so that transforming many different lengths does
+     * not keep the tables of all of them; a plan that is still in use stays alive through its shared_ptr
+     */
+    const size_t maxCachedPlans = 16;
+
+    template <typename TPlan>
+    using TCachedPlans = std::list<std::pair<size_t, std::shared_ptr<const TPlan>>>;
+
+    /* moves the plan for length n to the front of plans, nullptr when there is none */
+    template <typename TPlan>
+    std::shared_ptr<const TPlan> findPlan(TCachedPlans<TPlan> &plans, size_t n)
+    {
+        auto planIt = std::find_if(plans.begin(), plans.end(), [n](const auto &cached)
+                                   { return cached.first == n; });
+        if (planIt == plans.end())
+            return nullptr;
+        plans.splice(plans.begin(), plans, planIt);
+        return plans.front().second;
+    }
+
+    /* the plans used last are kept, most recently used first.  Plans are built outside of the lock, a plan
+     * may need the plan of another length; when two threads build the same plan the one stored first is kept
+     */
+    template <typename TPlan>
+    std::shared_ptr<const TPlan> cachedPlan(size_t n)
+    {
+        static std::mutex mutex;
+        static TCachedPlans<TPlan> plans;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (auto plan = findPlan(plans, n))
+                return plan;
+        }
+        auto newPlan = std::make_shared<const TPlan>(n);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto plan = findPlan(plans, n))
+            return plan;
+        plans.emplace_front(n, newPlan);
+        if (plans.size() > maxCachedPlans)
+            plans.pop_back();
+        return newPlan;
+    }
+
+    /* a * b without the checks for infinities of the operator of std::complex */
+    inline std::complex<double> multiply(const std::complex<double> &a, const std::complex<double> &b)
+    {
+        return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+    }
+
+    void scale(std::complex<double> *data, size_t n)
+    {
+        simd::apply(simd::Operation::Multiply, data, std::complex<double>(1.0 / static_cast<double>(n)), data, n);
+    }
+
+    void conjugate(std::complex<double> *data, size_t n)
+    {
+        for (size_t k = 0; k < n; ++k)
+            data[k] = std::conj(data[k]);
+    }
+
+    template <typename T>
+    void convolveDirect(const T *lhs, size_t nl, const T *rhs, size_t nr, T *out)
+    {
+        std::fill(out, out + nl + nr - 1, T(0));
+        for (size_t i = 0; i < nl; ++i)
+            for (size_t j = 0; j < nr; ++j)
+                out[i + j] += lhs[i] * rhs[j];
+    }
+}
+
+namespace fft
+{
+    Plan::Plan(size_t in) : n(in)
+    {
+        if (n == 0)
+            return;
+        if (isPowerOfTwo(n))
+        {
+            size_t bits = 0;
+            while ((static_cast<size_t>(1) << bits) < n)
+                ++bits;
+            bitReversed.resize(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                size_t reversed = 0;
+                for (size_t b = 0; b < bits; ++b)
+                    reversed |= ((i >> b) & 1) << (bits - 1 - b);
+                bitReversed[i] = reversed;
+            }
+            // the factors of each stage are stored one after the other, so that a stage reads them in order
+            twiddles.reserve(n - 1);
+            for (size_t length = 2; length <= n; length <<= 1)
+            {
+                for (size_t k = 0; k < length / 2; ++k)
+                    twiddles.push_back(std::polar(1.0, -2.0 * pi * static_cast<double>(k) / static_cast<double>(length)));
+            }
+            return;
+        }
+
+        // exp(-2 pi i jk / n) = chirp[j] chirp[k] conj(chirp[j - k]), which makes the transform a convolution with the conjugate chirp
+        chirp.reserve(n);
+        for (size_t k = 0; k < n; ++k)
+        {
+            // k^2 modulo 2n keeps the angle small and exact for large k
+            const size_t square = static_cast<size_t>((static_cast<unsigned long long>(k) * k) % (2 * static_cast<unsigned long long>(n)));
+            chirp.push_back(std::polar(1.0, -pi * static_cast<double>(square) / static_cast<double>(n)));
+        }
+
+        padded = plan(nextPowerOfTwo(2 * n - 1));
+        const size_t m = padded->size();
+        chirpSpectrum.assign(m, std::complex<double>(0.0));
+        chirpSpectrum[0] = std::conj(chirp[0]);
+        for (size_t k = 1; k < n; ++k)
+            chirpSpectrum[k] = chirpSpectrum[m - k] = std::conj(chirp[k]);
+        padded->forward(chirpSpectrum.data());
+    }
+
+    void Plan::forward(std::complex<double> *data) const
+    {
+        if (n <= 1)
+            return;
+        if (!bitReversed.empty())
+            radix2(data, false);
+        else
+            bluestein(data);
+    }
+
+    void Plan::inverse(std::complex<double> *data) const
+    {
+        if (n <= 1)
+            return;
+        if (!bitReversed.empty())
+            radix2(data, true);
+        else
+        {
+            // the inverse transform is the conjugate of the forward transform of the conjugate
+            conjugate(data, n);
+            bluestein(data);
+            conjugate(data, n);
+        }
+        scale(data, n);
+    }
+
+    void Plan::radix2(std::complex<double> *data, bool inverse) const
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (i < bitReversed[i])
+                std::swap(data[i], data[bitReversed[i]]);
+        }
+
+        // the inverse transform uses the conjugate factors
+        const double sign = inverse ? -1.0 : 1.0;
+        for (size_t length = 2; length <= n; length <<= 1)
+        {
+            const size_t half = length / 2;
+            const std::complex<double> *stageTwiddles = twiddles.data() + half - 1;
+            for (size_t start = 0; start < n; start += length)
+            {
+                std::complex<double> *lower = data + start;
+                std::complex<double> *upper = lower + half;
+                for (size_t k = 0; k < half; ++k)
+                {
+                    const std::complex<double> twiddle(stageTwiddles[k].real(), sign * stageTwiddles[k].imag());
+                    const auto v = multiply(upper[k], twiddle);
+                    upper[k] = lower[k] - v;
+                    lower[k] += v;
+                }
+            }
+        }
+    }
+
+    void Plan::bluestein(std::complex<double> *data) const
+    {
+        const size_t m = padded->size();
+        std::vector<std::complex<double>> work(m, std::complex<double>(0.0));
+        simd::apply(simd::Operation::Multiply, data, chirp.data(), work.data(), n);
+        padded->forward(work.data());
+        simd::apply(simd::Operation::Multiply, work.data(), chirpSpectrum.data(), work.data(), m);
+        padded->inverse(work.data());
+        simd::apply(simd::Operation::Multiply, work.data(), chirp.data(), data, n);
+    }
+
+    std::shared_ptr<const Plan> plan(size_t n)
+    {
+        return cachedPlan<Plan>(n);
+    }
+
+    void realForward(const double *values, size_t n, std::complex<double> *out)
+    {
+        if (n % 2 == 1)
+        {
+            std::vector<std::complex<double>> work(values, values + n);
+            plan(n)->forward(work.data());
+            std::copy(work.begin(), work.begin() + n / 2 + 1, out);
+            return;
+        }
+        if (n == 0)
+            return;
+
+        // the even and odd values are the real and imaginary parts of a transform of half the length
+        const size_t half = n / 2;
+        auto realPlan = cachedPlan<RealPlan>(n);
+        std::vector<std::complex<double>> work(half);
+        for (size_t k = 0; k < half; ++k)
+            work[k] = std::complex<double>(values[2 * k], values[2 * k + 1]);
+        realPlan->half->forward(work.data());
+
+        for (size_t k = 0; k <= half; ++k)
+        {
+            const auto z = work[k % half];
+            const auto zc = std::conj(work[(half - k) % half]);
+            const auto even = 0.5 * (z + zc);
+            const auto odd = multiply(z - zc, std::complex<double>(0.0, -0.5));
+            out[k] = even + multiply(realPlan->twiddles[k], odd);
+        }
+    }
+
+    void convolve(const double *lhs, size_t nl, const double *rhs, size_t nr, double *out)
+    {
+        if (nl == 0 || nr == 0)
+            return;
+        if (std::min(nl, nr) <= directConvolutionLength)
+        {
+            convolveDirect(lhs, nl, rhs, nr, out);
+            return;
+        }
+
+        // both real inputs go into one complex transform, lhs as the real and rhs as the imaginary part
+        const size_t length = nl + nr - 1;
+        auto padded = plan(nextPowerOfTwo(length));
+        const size_t m = padded->size();
+        std::vector<std::complex<double>> work(m, std::complex<double>(0.0));
+        for (size_t k = 0; k < nl; ++k)
+            work[k].real(lhs[k]);
+        for (size_t k = 0; k < nr; ++k)
+            work[k].imag(rhs[k]);
+        padded->forward(work.data());
+
+        // with Z the transform of lhs + i rhs, the product of the transforms is (Z[k]^2 - conj(Z[m - k])^2) / 4i
+        std::vector<std::complex<double>> product(m);
+        for (size_t k = 0; k < m; ++k)
+        {
+            const auto z = work[k];
+            const auto zc = std::conj(work[(m - k) % m]);
+            product[k] = multiply(multiply(z, z) - multiply(zc, zc), std::complex<double>(0.0, -0.25));
+        }
+        padded->inverse(product.data());
+        for (size_t k = 0; k < length; ++k)
+            out[k] = product[k].real();
+    }
+
+    void convolve(const std::complex<double> *lhs, size_t nl, const std::complex<double> *rhs, size_t nr, std::complex<double> *out)
+    {
+        if (nl == 0 || nr == 0)
+            return;
+        if (std::min(nl, nr) <= directConvolutionLength)
+        {
+            convolveDirect(lhs, nl, rhs, nr, out);
+            return;
+        }
+
+        const size_t length = nl + nr - 1;
+        auto padded = plan(nextPowerOfTwo(length));
+        const size_t m = padded->size();
+        std::vector<std::complex<double>> lhsSpectrum(m, std::complex<double>(0.0));
+        std::vector<std::complex<double>> rhsSpectrum(m, std::complex<double>(0.0));
+        std::copy(lhs, lhs + nl, lhsSpectrum.begin());
+        std::copy(rhs, rhs + nr, rhsSpectrum.begin());
+        padded->forward(lhsSpectrum.data());
+        padded->forward(rhsSpectrum.data());
+        simd::apply(simd::Operation::Multiply, lhsSpectrum.data(), rhsSpectrum.data(), lhsSpectrum.data(), m);
+        padded->inverse(lhsSpectrum.data());
+        std::copy(lhsSpectrum.begin(), lhsSpectrum.begin() + length, out);
+    }
+}
@@ -0,0 +1,65 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_FFT_H
+#define GUARDIAN_OF_INCLUSION_FFT_H
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/* discrete Fourier transforms on contiguous arrays, as used by the numeric module.  A transform of a
+ * power of two length runs the iterative radix-2 algorithm in place, any other length is turned into
+ * a convolution of a power of two length (Bluestein's algorithm).  The bit reversal permutation, the
+ * twiddle factors and the chirp of a length are computed once and shared by the later transforms of
+ * that length, from any thread; only the plans of the lengths used most recently are kept.
+ */
+namespace fft
+{
+    class Plan
+    {
+    public:
+        explicit Plan(size_t n);
+
+        size_t size() const { return n; }
+
+        /* data[k] = sum_j data[j] exp(-2 pi i jk / n) */
+        void forward(std::complex<double> *data) const;
+        /* data[k] = 1/n sum_j data[j] exp(2 pi i jk / n), the inverse of forward */
+        void inverse(std::complex<double> *data) const;
+
+    private:
+        void radix2(std::complex<double> *data, bool inverse) const;
+        void bluestein(std::complex<double> *data) const;
+
+        size_t n;
+        std::vector<size_t> bitReversed;
+        std::vector<std::complex<double>> twiddles; /*< exp(-2 pi i k / length) for k < length / 2, for each length of a stage */
+
+        std::vector<std::complex<double>> chirp;         /*< exp(-pi i k^2 / n) for k < n */
+        std::vector<std::complex<double>> chirpSpectrum; /*< transform of the conjugate chirp padded to the length of padded */
+        std::shared_ptr<const Plan> padded;
+    };
+
+    /* the plan for transforms of length n */
+    std::shared_ptr<const Plan> plan(size_t n);
+
+    /* out[k] for k <= n / 2 of the transform of the n real values, the other half of the transform is
+     * the complex conjugate of the first; an even length runs as a complex transform of half the length
+     */
+    void realForward(const double *values, size_t n, std::complex<double> *out);
+
+    /* out[k] = sum_j lhs[j] rhs[k - j] for k < nl + nr - 1, computed directly for short inputs and
+     * through transforms otherwise
+     */
+    void convolve(const double *lhs, size_t nl, const double *rhs, size_t nr, double *out);
+    void convolve(const std::complex<double> *lhs, size_t nl, const std::complex<double> *rhs, size_t nr, std::complex<double> *out);
+}
+
+#endif
@@ -16,6 +16,8 @@
 #include "Lexer.h"
 #include "Parser.h"
 #include "Evaluator.h"
+#include "Interpreter.h"
+#include "ModuleCache.h"
 #include "Util.h"
 #include "Version.h"
 
@@ -130,7 +132,10 @@ try
 
     std::string fileToRun = "";
 
-    initialize();
+    auto startupStart = std::chrono::high_resolution_clock::now();
+    auto interpreter = std::make_shared<interp::Interpreter>();
+    interp::CurrentInterpreter currentInterpreter(interpreter.get());
+    std::chrono::duration<double, std::milli> startupTime = std::chrono::high_resolution_clock::now() - startupStart;
     auto environment = std::make_shared<obj::Environment>();
     int offset = 0;
     int returnValue = 2;
@@ -169,7 +174,8 @@ try
         }
     }
 
-    initializeArg(offset, argc, argv);
+    for (int i = offset; i < argc; ++i)
+        interpreter->args.push_back(std::string(argv[i]));
 
     if (!fileToRun.empty())
     {
@@ -245,7 +251,7 @@ try
     }
 
     environment.reset();
-    finalize();
+    interpreter.reset();
 
     if (showStatistics)
     {
@@ -254,6 +260,9 @@ try
         std::cout << " user objects wrongly destructed: " << obj::UserObject::userInstancesWronglyDestructed << std::endl;
         std::cout << "Environment statistics:" << std::endl;
         std::cout << " created: " << obj::Environment::instancesConstructed << ", destructed: " << obj::Environment::instancesDestructed << std::endl;
+        std::cout << "Module cache statistics:" << std::endl;
+        std::cout << " hits: " << cache::hits << ", misses: " << cache::misses << ", reused in process: " << cache::reuses << std::endl;
+        std::cout << "Startup time: " << startupTime.count() << "ms" << std::endl;
         std::cout << "Usertime: " << cumulativeTime << "ms" << std::endl;
     }
 
@@ -0,0 +1,62 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Interpreter.h"
+#include "Evaluator.h"
+
+#include <atomic>
+
+namespace
+{
+    thread_local interp::Interpreter *currentInterpreter = nullptr;
+
+    // version 0 is left for an identifier that has not been looked up yet
+    std::atomic<uint64_t> lastBuiltinsVersion{0};
+}
+
+namespace interp
+{
+    Interpreter::Interpreter()
+    {
+        initialize(*this);
+        builtinsChanged();
+    }
+
+    Interpreter::~Interpreter()
+    {
+        // modules are torn down first, their objects may still refer to the builtin types
+        builtinModules.clear();
+        builtinTypes.clear();
+        builtins.clear();
+    }
+
+    void Interpreter::builtinsChanged()
+    {
+        builtinsVersion = lastBuiltinsVersion.fetch_add(1) + 1;
+    }
+
+    Interpreter *Interpreter::current()
+    {
+        return currentInterpreter;
+    }
+
+    std::shared_ptr<Interpreter> Interpreter::currentShared()
+    {
+        return currentInterpreter ? currentInterpreter->shared_from_this() : nullptr;
+    }
+
+    CurrentInterpreter::CurrentInterpreter(Interpreter *interpreter) : previous(currentInterpreter)
+    {
+        currentInterpreter = interpreter;
+    }
+
+    CurrentInterpreter::~CurrentInterpreter()
+    {
+        currentInterpreter = previous;
+    }
+}
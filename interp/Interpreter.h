@@ -0,0 +1,105 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_INTERPRETER_H
+#define GUARDIAN_OF_INCLUSION_INTERPRETER_H
+
+#include "Object.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace interp
+{
+    /* builtin modules, types and functions are only constructed when they are first
+     * referred to, so that the start-up of the interpreter does not pay for building
+     * all function tables and parsing all of their type strings
+     */
+    template <typename T>
+    class LazyBuiltin
+    {
+    public:
+        LazyBuiltin(std::function<std::shared_ptr<T>()> ifactory) : factory(std::move(ifactory)){};
+
+        const std::shared_ptr<T> &get()
+        {
+            std::call_once(constructed, [this]()
+                           { instance = factory(); });
+            return instance;
+        }
+
+    private:
+        std::function<std::shared_ptr<T>()> factory;
+        std::shared_ptr<T> instance;
+        std::once_flag constructed;
+    };
+
+    /* the state of one interpreter: its builtin functions, types and modules, the arguments it was
+     * started with and the files it ran once.  Several interpreters can live in the same process,
+     * each evaluating on its own threads; they share no mutable state and exchange data by message
+     * passing of serialized values or of objects made immortal with share()
+     *
+     * an interpreter is owned by a shared_ptr: the threads and tasks started from its code hold on
+     * to it, so that it outlives them when its owner lets go of it first
+     */
+    struct Interpreter : public std::enable_shared_from_this<Interpreter>
+    {
+        Interpreter();
+        ~Interpreter();
+
+        Interpreter(const Interpreter &) = delete;
+        Interpreter &operator=(const Interpreter &) = delete;
+
+        std::unordered_map<std::string, LazyBuiltin<obj::Object>> builtins;
+
+        /* identifies the builtins of this interpreter as they are now: unique across all interpreters of the
+         * process and renewed by every change to builtins, so that the syntax tree, which is shared between
+         * interpreters, can remember in which builtins a name was not found
+         */
+        uint64_t builtinsVersion;
+
+        /* gives builtins a new version after a change */
+        void builtinsChanged();
+        std::unordered_map<obj::ObjectType, LazyBuiltin<obj::BuiltinType>> builtinTypes;
+        std::unordered_map<std::string, LazyBuiltin<obj::Module>> builtinModules;
+
+        std::vector<std::string> args; /*< the command line arguments returned by arg() */
+
+        std::mutex runOnceMutex;
+        std::unordered_set<std::string> runOnceRegistry; /*< canonical paths of the files already run by run_once */
+
+        /* the interpreter evaluating code on the calling thread, nullptr when there is none */
+        static Interpreter *current();
+
+        /* the current interpreter for a thread or task to hold on to, nullptr when there is none */
+        static std::shared_ptr<Interpreter> currentShared();
+    };
+
+    /* makes an interpreter the current one of the calling thread for as long as it exists,
+     * threads and tasks started from code enter the interpreter of the code that started them
+     */
+    class CurrentInterpreter
+    {
+    public:
+        explicit CurrentInterpreter(Interpreter *interpreter);
+        ~CurrentInterpreter();
+
+        CurrentInterpreter(const CurrentInterpreter &) = delete;
+        CurrentInterpreter &operator=(const CurrentInterpreter &) = delete;
+
+    private:
+        Interpreter *previous;
+    };
+}
+
+#endif
@@ -69,6 +69,7 @@ namespace
         {TokenType::IF, "if"},
         {TokenType::ELSE, "else"},
         {TokenType::RETURN, "return"},
+        {TokenType::YIELD, "yield"},
         {TokenType::TRUE, "true"},
         {TokenType::FALSE, "false"},
         {TokenType::NULL_T, "null"},
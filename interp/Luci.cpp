@@ -0,0 +1,114 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Luci.h"
+#include "Evaluator.h"
+#include "Typing.h"
+
+#include <sstream>
+
+namespace luci
+{
+    std::shared_ptr<obj::Object> Function::operator()(const std::vector<std::shared_ptr<obj::Object>> &arguments) const
+    {
+        if (!function)
+            return std::make_shared<obj::Error>("call of an empty function", obj::ErrorType::TypeError);
+
+        interp::CurrentInterpreter current(interpreter);
+        return evalFunctionWithArguments(function.get(), arguments, function->environment);
+    }
+
+    std::shared_ptr<obj::Object> Script::get(const std::string &name) const
+    {
+        if (!environment || !environment->has(name))
+            return nullptr;
+        return environment->get(name);
+    }
+
+    Function Script::function(const std::string &name) const
+    {
+        Function function;
+        auto object = get(name);
+        if (object && object->type == obj::ObjectType::Function)
+        {
+            function.interpreter = interpreter;
+            function.function = std::static_pointer_cast<obj::Function>(object);
+        }
+        return function;
+    }
+
+    Engine::Engine(const std::vector<std::string> &args) : state(std::make_shared<interp::Interpreter>())
+    {
+        state->args = args;
+    }
+
+    Engine::~Engine()
+    {
+    }
+
+    Script Engine::load(const std::string &fileName)
+    {
+        auto program = cache::loadProgram(fileName);
+        if (!program)
+        {
+            Script script;
+            script.loadError = std::make_shared<obj::Error>("load: " + fileName + " cannot be read", obj::ErrorType::OSError);
+            return script;
+        }
+        return run(std::move(program));
+    }
+
+    Script Engine::loadSource(const std::string &text, const std::string &fileName)
+    {
+        auto program = std::make_shared<cache::LoadedProgram>();
+        auto parser = createParser(createLexer(text, fileName));
+        program->program = parser->parseProgram();
+        program->errorMsgs = parser->errorMsgs;
+        return run(std::move(program));
+    }
+
+    Script Engine::run(std::shared_ptr<const cache::LoadedProgram> program)
+    {
+        Script script;
+        script.interpreter = state.get();
+        script.program = std::move(program);
+
+        if (!script.program->errorMsgs.empty())
+        {
+            std::stringstream ss;
+            for (const auto &msg : script.program->errorMsgs)
+                ss << msg << std::endl;
+            script.loadError = std::make_shared<obj::Error>("load: parsing errors encountered: " + ss.str(), obj::ErrorType::SyntaxError);
+            return script;
+        }
+
+        interp::CurrentInterpreter current(state.get());
+        script.environment = std::make_shared<obj::Environment>();
+        script.environment->retainProgram(script.program);
+        auto result = evalProgram(script.program->program.get(), script.environment);
+        if (result && result->type == obj::ObjectType::Error)
+            script.loadError = result;
+
+        // the functions of the script can be called from any thread of the host
+        script.environment->markShared();
+        return script;
+    }
+
+    void Engine::registerFunction(const std::string &name, obj::THostFunction function, const std::string &argTypes, const std::string &returnType)
+    {
+        auto builtin = std::make_shared<obj::Builtin>();
+        builtin->hostFunction = std::move(function);
+        builtin->declaredType = typing::makeFunctionType(argTypes, returnType);
+
+        // a host function replaces a builtin of the same name
+        state->builtins.erase(name);
+        state->builtins.try_emplace(name, [builtin]()
+                                    { return builtin; });
+        state->builtinsChanged();
+    }
+}
@@ -0,0 +1,111 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_LUCI_H
+#define GUARDIAN_OF_INCLUSION_LUCI_H
+
+/* embedding API of the interpreter, provided by the libluci library
+ *
+ *   luci::Engine engine;
+ *   engine.registerFunction("limit", [](const auto &arguments) { return std::make_shared<obj::Integer>(10); });
+ *   auto script = engine.load("rules.luci");
+ *   auto score = script.function("score");
+ *   auto result = score({std::make_shared<obj::Integer>(3)});
+ *
+ * a script is lexed, parsed and run once when it is loaded, calling one of its functions afterwards
+ * evaluates the body of the function directly. Errors are reported the way the interpreter does,
+ * as an obj::Error object.
+ */
+
+#include "Interpreter.h"
+#include "ModuleCache.h"
+#include "Object.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace luci
+{
+    /* a function of a loaded script, it can be called any number of times and from any thread */
+    class Function
+    {
+    public:
+        Function() = default;
+
+        explicit operator bool() const { return static_cast<bool>(function); }
+
+        /* call the function with arguments constructed by the host, the arguments are passed by
+         * reference as they are for any call in the language; returns the return value of the
+         * function or an obj::Error
+         */
+        std::shared_ptr<obj::Object> operator()(const std::vector<std::shared_ptr<obj::Object>> &arguments) const;
+
+    private:
+        friend class Script;
+        interp::Interpreter *interpreter = nullptr;
+        std::shared_ptr<obj::Function> function;
+    };
+
+    /* a script loaded by an engine, the names it defines at the top level stay available;
+     * a script and its functions are not to be used after the engine is destructed
+     */
+    class Script
+    {
+    public:
+        /* the error of loading or running the script, nullptr when it succeeded */
+        const std::shared_ptr<obj::Object> &error() const { return loadError; }
+
+        /* the object bound to name at the top level of the script, nullptr when there is none */
+        std::shared_ptr<obj::Object> get(const std::string &name) const;
+
+        /* the function bound to name at the top level of the script, empty when there is none */
+        Function function(const std::string &name) const;
+
+    private:
+        friend class Engine;
+        interp::Interpreter *interpreter = nullptr;
+        std::shared_ptr<const cache::LoadedProgram> program; /*< functions of the script refer into its syntax tree */
+        std::shared_ptr<obj::Environment> environment;
+        std::shared_ptr<obj::Object> loadError;
+    };
+
+    /* an interpreter embedded in a host, several engines can be used in the same process; threads and
+     * tasks started by its scripts keep the interpreter and its host functions alive until they end,
+     * also when the engine is destructed before them
+     */
+    class Engine
+    {
+    public:
+        explicit Engine(const std::vector<std::string> &args = {});
+        ~Engine();
+
+        Engine(const Engine &) = delete;
+        Engine &operator=(const Engine &) = delete;
+
+        /* load and run the script in fileName, through the same cache of parsed programs as import */
+        Script load(const std::string &fileName);
+
+        /* load and run a script given as text, fileName is only used in error messages */
+        Script loadSource(const std::string &text, const std::string &fileName = "");
+
+        /* make a native function of the host available as a builtin function to all scripts loaded
+         * afterwards, the types are only used for type checking in the same notation as in the language
+         */
+        void registerFunction(const std::string &name, obj::THostFunction function, const std::string &argTypes = "all", const std::string &returnType = "all");
+
+        interp::Interpreter &interpreter() { return *state; }
+
+    private:
+        Script run(std::shared_ptr<const cache::LoadedProgram> program);
+
+        std::shared_ptr<interp::Interpreter> state;
+    };
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "ModuleCache.h"
+#include "AstSerializer.h"
+#include "Lexer.h"
+#include "Version.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+
+namespace
+{
+    const char cacheMagic[8] = {'L', 'U', 'C', 'I', 'A', 'S', 'T', '\0'};
+
+    /* bump whenever the layout written by ast::serialize changes */
+    const uint32_t cacheFormatVersion = 2;
+
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t formatVersion;
+        uint32_t pointerSize;
+        uint64_t majorVersion;
+        uint64_t minorVersion;
+        uint64_t patchVersion;
+        uint64_t contentHash;
+        uint64_t contentSize;
+    };
+
+    CacheHeader makeHeader(const std::string &text)
+    {
+        CacheHeader header;
+        std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+        header.formatVersion = cacheFormatVersion;
+        header.pointerSize = static_cast<uint32_t>(sizeof(void *));
+        header.majorVersion = majorVersion;
+        header.minorVersion = minorVersion;
+        header.patchVersion = patchVersion;
+        header.contentHash = cache::contentHash(text);
+        header.contentSize = text.size();
+        return header;
+    }
+
+    bool matchingHeader(const CacheHeader &a, const CacheHeader &b)
+    {
+        return std::memcmp(a.magic, b.magic, sizeof(a.magic)) == 0 &&
+               a.formatVersion == b.formatVersion &&
+               a.pointerSize == b.pointerSize &&
+               a.majorVersion == b.majorVersion &&
+               a.minorVersion == b.minorVersion &&
+               a.patchVersion == b.patchVersion &&
+               a.contentHash == b.contentHash &&
+               a.contentSize == b.contentSize;
+    }
+
+    bool cacheEnabled()
+    {
+        static const bool enabled = std::getenv("LUCI_NO_CACHE") == nullptr;
+        return enabled;
+    }
+
+    std::filesystem::path cacheFileName(const std::string &fileName)
+    {
+        std::filesystem::path sourcePath(fileName);
+        return sourcePath.parent_path() / cache::cacheDirectoryName / (sourcePath.filename().string() + ".lcc");
+    }
+
+    std::unique_ptr<ast::Program> readCache(const std::filesystem::path &cachePath, const CacheHeader &expectedHeader, const std::string &fileName)
+    {
+        std::ifstream inputf(cachePath, std::ios::binary);
+        if (!inputf.is_open())
+            return nullptr;
+
+        CacheHeader header;
+        inputf.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!inputf || !matchingHeader(header, expectedHeader))
+            return nullptr;
+
+        return ast::deserialize(inputf, std::make_shared<std::string>(fileName));
+    }
+
+    /* write to a temporary file first and move it in place, so that concurrently running
+     * interpreters never observe a partially written cache file; failures are ignored as
+     * the cache is merely an optimization (e.g. for read-only installations)
+     */
+    void writeCache(const std::filesystem::path &cachePath, const CacheHeader &header, const ast::Program &program)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(cachePath.parent_path(), ec);
+        if (ec)
+            return;
+
+        thread_local std::mt19937_64 generator{std::random_device{}()};
+        auto tmpPath = cachePath;
+        tmpPath += "." + std::to_string(generator()) + ".tmp";
+        {
+            std::ofstream outputf(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!outputf.is_open())
+                return;
+            outputf.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            ast::serialize(program, outputf);
+            if (!outputf)
+            {
+                outputf.close();
+                std::filesystem::remove(tmpPath, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tmpPath, cachePath, ec);
+        if (ec)
+            std::filesystem::remove(tmpPath, ec);
+    }
+
+    struct CachedProgram
+    {
+        std::filesystem::file_time_type lastWriteTime;
+        std::uintmax_t fileSize = 0;
+        std::shared_ptr<const cache::LoadedProgram> loaded;
+    };
+
+    std::mutex loadedProgramsMutex;
+    std::unordered_map<std::string, CachedProgram> loadedPrograms;
+}
+
+namespace cache
+{
+    const std::string cacheDirectoryName = "__lucicache__";
+
+    std::atomic<size_t> hits = 0;
+    std::atomic<size_t> misses = 0;
+    std::atomic<size_t> reuses = 0;
+
+    uint64_t contentHash(const std::string &text)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : text)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::unique_ptr<ast::Program> parseProgram(const std::string &text, const std::string &fileName, std::vector<ParserError> &errorMsgs)
+    {
+        const bool useCache = cacheEnabled() && !fileName.empty();
+
+        std::filesystem::path cachePath;
+        CacheHeader header;
+        if (useCache)
+        {
+            cachePath = cacheFileName(fileName);
+            header = makeHeader(text);
+            auto program = readCache(cachePath, header, fileName);
+            if (program)
+            {
+                ++hits;
+                return program;
+            }
+            ++misses;
+        }
+
+        auto lexer = createLexer(text, fileName);
+        auto parser = createParser(std::move(lexer));
+        auto program = parser->parseProgram();
+        errorMsgs = parser->errorMsgs;
+
+        if (useCache && program && errorMsgs.empty())
+            writeCache(cachePath, header, *program);
+
+        return program;
+    }
+
+    std::shared_ptr<const LoadedProgram> loadProgram(const std::string &fileName)
+    {
+        std::error_code ec;
+        auto canonicalPath = std::filesystem::canonical(std::filesystem::path(fileName), ec);
+        if (ec)
+            return nullptr;
+        auto lastWriteTime = std::filesystem::last_write_time(canonicalPath, ec);
+        if (ec)
+            return nullptr;
+        auto fileSize = std::filesystem::file_size(canonicalPath, ec);
+        if (ec)
+            return nullptr;
+
+        const std::string key = canonicalPath.string();
+        {
+            std::lock_guard<std::mutex> lock(loadedProgramsMutex);
+            auto cachedIt = loadedPrograms.find(key);
+            if (cachedIt != loadedPrograms.end() && cachedIt->second.lastWriteTime == lastWriteTime && cachedIt->second.fileSize == fileSize)
+            {
+                ++reuses;
+                return cachedIt->second.loaded;
+            }
+        }
+
+        std::string text;
+        std::string line;
+        std::ifstream inputf;
+        inputf.open(fileName);
+        if (!inputf.is_open())
+            return nullptr;
+        while (std::getline(inputf, line))
+            text += line + "\n";
+
+        auto loaded = std::make_shared<LoadedProgram>();
+        loaded->program = parseProgram(text, fileName, loaded->errorMsgs);
+
+        // a superseded program is released by the cache, the environments it ran in keep it alive for as
+        // long as they need it
+        std::lock_guard<std::mutex> lock(loadedProgramsMutex);
+        loadedPrograms.insert_or_assign(key, CachedProgram{lastWriteTime, fileSize, loaded});
+        return loaded;
+    }
+}
@@ -0,0 +1,66 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_MODULE_CACHE_H
+#define GUARDIAN_OF_INCLUSION_MODULE_CACHE_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Ast.h"
+#include "Parser.h"
+
+namespace cache
+{
+    /* name of the directory, next to the source file, in which compiled modules are stored */
+    extern const std::string cacheDirectoryName;
+
+    /* counters on the usage of the compiled module cache, reported in the statistics of the interpreter */
+    extern std::atomic<size_t> hits;
+    extern std::atomic<size_t> misses;
+    extern std::atomic<size_t> reuses;
+
+    /* 64-bit FNV-1a hash of the text, used as the content key of a compiled module */
+    uint64_t contentHash(const std::string &text);
+
+    /* returns the program for the text of fileName, either read from the compiled
+     * module cache when the content hash and interpreter version match, or freshly
+     * lexed and parsed after which the cache is updated. Parsing errors are returned
+     * in errorMsgs and nothing is cached in that case.
+     *
+     * the cache can be disabled by defining the LUCI_NO_CACHE environment variable
+     */
+    std::unique_ptr<ast::Program> parseProgram(const std::string &text, const std::string &fileName, std::vector<ParserError> &errorMsgs);
+
+    /* a program as loaded by loadProgram, when parsing failed errorMsgs is non-empty */
+    struct LoadedProgram
+    {
+        std::shared_ptr<ast::Program> program;
+        std::vector<ParserError> errorMsgs;
+    };
+
+    /* returns the program of fileName from the process-wide cache of loaded programs, which
+     * is keyed by the canonical path and revalidated against the modification time and size
+     * of the file, so that a file that is run or imported repeatedly is only parsed once.
+     *
+     * the functions defined by a program refer into its syntax tree, so every environment a
+     * program runs in keeps it alive (obj::Environment::retainProgram); the cache itself only
+     * holds the latest version of each file and a superseded version is released once the last
+     * environment that ran it is gone.
+     *
+     * a loaded program is shared by all interpreters and threads of the process and must be
+     * treated as immutable after parsing: nothing may be memoised in its syntax tree.
+     *
+     * returns nullptr when the file cannot be read
+     */
+    std::shared_ptr<const LoadedProgram> loadProgram(const std::string &fileName);
+}
+
+#endif
@@ -0,0 +1,113 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+/* example of a native module, built as native_example.so and loaded by import native_example; */
+
+#include "NativeModule.h"
+#include "Typing.h"
+
+namespace
+{
+    struct Accumulator : public obj::NativeObject
+    {
+        double total = 0.0;
+        size_t count = 0;
+
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            auto cloned = std::make_shared<Accumulator>(nativeType);
+            cloned->total = total;
+            cloned->count = count;
+            return cloned;
+        };
+        Accumulator(const std::shared_ptr<obj::BuiltinType> &inativeType) : obj::NativeObject(inativeType, "accumulator"){};
+    };
+
+    /* the type is shared by all interpreters that import the module */
+    const std::shared_ptr<obj::BuiltinType> &accumulatorType();
+
+    std::shared_ptr<obj::Object> dot(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return std::make_shared<obj::Error>("dot: expected 2 arguments of type (array_double, array_double)", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->at(0).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, ArrayDouble, "dot: expected argument 1 to be an array_double");
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, ArrayDouble, "dot: expected argument 2 to be an array_double");
+
+        const auto &lhs = static_cast<obj::ArrayDouble *>(evaluatedExpr1.get())->value;
+        const auto &rhs = static_cast<obj::ArrayDouble *>(evaluatedExpr2.get())->value;
+        if (lhs.size() != rhs.size())
+            return std::make_shared<obj::Error>("dot: expected arrays of equal length", obj::ErrorType::ValueError);
+
+        double result = 0.0;
+        for (size_t i = 0; i < lhs.size(); ++i)
+            result += lhs[i] * rhs[i];
+        return std::make_shared<obj::Double>(result);
+    }
+
+    std::shared_ptr<obj::Object> accumulator(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 0)
+            return std::make_shared<obj::Error>("accumulator: expected 0 arguments", obj::ErrorType::TypeError);
+
+        return std::make_shared<Accumulator>(accumulatorType());
+    }
+
+    std::shared_ptr<obj::Object> accumulator_add(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (arguments.size() != 1 || arguments[0]->type != obj::ObjectType::Double)
+            return std::make_shared<obj::Error>("add: expected 1 argument of type double", obj::ErrorType::TypeError);
+
+        auto accumulatorObj = static_cast<Accumulator *>(self.get());
+        accumulatorObj->total += static_cast<obj::Double *>(arguments[0].get())->value;
+        accumulatorObj->count += 1;
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> accumulator_mean(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (arguments.size() != 0)
+            return std::make_shared<obj::Error>("mean: expected 0 arguments", obj::ErrorType::TypeError);
+
+        auto accumulatorObj = static_cast<Accumulator *>(self.get());
+        if (accumulatorObj->count == 0)
+            return std::make_shared<obj::Error>("mean: no values added", obj::ErrorType::ValueError);
+        return std::make_shared<obj::Double>(accumulatorObj->total / static_cast<double>(accumulatorObj->count));
+    }
+
+    const std::shared_ptr<obj::BuiltinType> &accumulatorType()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        static std::shared_ptr<obj::BuiltinType> builtinType = []()
+        {
+            auto accumulatorBuiltinType = std::make_shared<obj::BuiltinType>();
+            accumulatorBuiltinType->builtinObjectType = obj::ObjectType::NativeObject;
+            accumulatorBuiltinType->functions = {
+                {"add", TBuiltInFD({&accumulator_add, typing::makeFunctionType("double", "null")})},
+                {"mean", TBuiltInFD({&accumulator_mean, typing::makeFunctionType("", "double")})},
+            };
+            return accumulatorBuiltinType;
+        }();
+        return builtinType;
+    }
+}
+
+LUCI_NATIVE_MODULE(module)
+{
+    module->environment->add("dot", builtin::makeBuiltInFunctionObj(&dot, "array_double, array_double", "double"), false, nullptr);
+    module->environment->add("accumulator", builtin::makeBuiltInFunctionObj(&accumulator, "", "native"), false, nullptr);
+}
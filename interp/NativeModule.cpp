@@ -0,0 +1,119 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "NativeModule.h"
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace
+{
+    typedef int (*TApiVersionFunction)();
+    typedef void (*TRegisterModuleFunction)(obj::Module *module);
+
+    struct Library
+    {
+        TApiVersionFunction apiVersion = nullptr;
+        TRegisterModuleFunction registerModule = nullptr;
+    };
+
+    /* libraries opened by this process, keyed by canonical path, they are never closed */
+    std::mutex librariesMutex;
+    std::unordered_map<std::string, Library> libraries;
+
+#ifdef _WIN32
+    std::string lastError()
+    {
+        return "error code " + std::to_string(GetLastError());
+    }
+
+    void *openLibrary(const std::string &fileName)
+    {
+        return LoadLibraryA(fileName.c_str());
+    }
+
+    void *findSymbol(void *handle, const char *name)
+    {
+        return reinterpret_cast<void *>(GetProcAddress(static_cast<HMODULE>(handle), name));
+    }
+#else
+    std::string lastError()
+    {
+        const char *msg = dlerror();
+        return msg ? std::string(msg) : std::string("unknown error");
+    }
+
+    void *openLibrary(const std::string &fileName)
+    {
+        return dlopen(fileName.c_str(), RTLD_NOW | RTLD_LOCAL);
+    }
+
+    void *findSymbol(void *handle, const char *name)
+    {
+        return dlsym(handle, name);
+    }
+#endif
+}
+
+namespace native
+{
+#if defined(_WIN32)
+    const std::string moduleFileExtension = ".dll";
+#elif defined(__APPLE__)
+    const std::string moduleFileExtension = ".dylib";
+#else
+    const std::string moduleFileExtension = ".so";
+#endif
+
+    std::shared_ptr<obj::Object> loadModule(const std::string &fileName)
+    {
+        std::error_code ec;
+        auto canonicalPath = std::filesystem::canonical(fileName, ec);
+        if (ec)
+            return std::make_shared<obj::Error>("import: native module " + fileName + " not found", obj::ErrorType::ImportError);
+
+        Library library;
+        {
+            std::lock_guard<std::mutex> lock(librariesMutex);
+            auto libraryIt = libraries.find(canonicalPath.string());
+            if (libraryIt != libraries.end())
+            {
+                library = libraryIt->second;
+            }
+            else
+            {
+                void *handle = openLibrary(canonicalPath.string());
+                if (!handle)
+                    return std::make_shared<obj::Error>("import: native module " + fileName + " cannot be loaded, " + lastError(), obj::ErrorType::ImportError);
+
+                library.apiVersion = reinterpret_cast<TApiVersionFunction>(findSymbol(handle, "luci_module_api_version"));
+                library.registerModule = reinterpret_cast<TRegisterModuleFunction>(findSymbol(handle, "luci_register_module"));
+                libraries.emplace(canonicalPath.string(), library);
+            }
+        }
+
+        if (!library.apiVersion || !library.registerModule)
+            return std::make_shared<obj::Error>("import: native module " + fileName + " has no luci_register_module entry point", obj::ErrorType::ImportError);
+        if (library.apiVersion() != LUCI_NATIVE_MODULE_API_VERSION)
+            return std::make_shared<obj::Error>("import: native module " + fileName + " was built for api version " + std::to_string(library.apiVersion()) + ", expected " + std::to_string(LUCI_NATIVE_MODULE_API_VERSION), obj::ErrorType::ImportError);
+
+        auto moduleObj = std::make_shared<obj::Module>();
+        moduleObj->fileName = fileName;
+        library.registerModule(moduleObj.get());
+        moduleObj->state = obj::ModuleState::Loaded;
+        moduleObj->environment->markShared();
+        return moduleObj;
+    }
+}
@@ -0,0 +1,73 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_NATIVE_MODULE_H
+#define GUARDIAN_OF_INCLUSION_NATIVE_MODULE_H
+
+/* native modules are shared libraries that import loads when no .luci file of the module exists,
+ * e.g. import kernels; loads kernels.so (kernels.dylib on macOS, kernels.dll on Windows) from the
+ * same directory a kernels.luci would be loaded from.
+ *
+ * a native module defines its entry point with LUCI_NATIVE_MODULE, which receives the new module
+ * and adds its functions and types to the environment of the module:
+ *
+ *   #include "NativeModule.h"
+ *
+ *   std::shared_ptr<obj::Object> scale(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+ *   { ... }
+ *
+ *   LUCI_NATIVE_MODULE(module)
+ *   {
+ *       module->environment->add("scale", builtin::makeBuiltInFunctionObj(&scale, "double,double", "double"), false, nullptr);
+ *   }
+ *
+ * objects of a type defined by the module derive from obj::NativeObject and implement clone to copy
+ * their own data, their member functions and properties are taken from the obj::BuiltinType the
+ * module constructs for them.
+ *
+ * a native module is compiled against the headers of the interpreter but not linked with it, the
+ * symbols are resolved against the luci executable (or the host embedding libluci), which exports them
+ */
+
+#include "Evaluator.h"
+#include "Object.h"
+
+#include <memory>
+#include <string>
+
+/* bump whenever the layout of the objects or the signature of the builtin functions changes,
+ * a native module compiled against another version is refused by import
+ */
+#define LUCI_NATIVE_MODULE_API_VERSION 1
+
+#ifdef _WIN32
+#define LUCI_NATIVE_MODULE_EXPORT extern "C" __declspec(dllexport)
+#else
+#define LUCI_NATIVE_MODULE_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+#define LUCI_NATIVE_MODULE(moduleName)                                                   \
+    LUCI_NATIVE_MODULE_EXPORT int luci_module_api_version() { return LUCI_NATIVE_MODULE_API_VERSION; } \
+    LUCI_NATIVE_MODULE_EXPORT void luci_register_module(obj::Module *moduleName)
+
+namespace native
+{
+    /* file name extension of native modules on this platform, including the dot */
+    extern const std::string moduleFileExtension;
+
+    /* returns a loaded module filled by the entry point of the shared library fileName, or an error
+     * of type ImportError when the library cannot be opened, has no entry point or was compiled
+     * against another version of the interpreter.
+     *
+     * libraries stay loaded until the end of the process, as the objects of a module refer
+     * to functions of the library
+     */
+    std::shared_ptr<obj::Object> loadModule(const std::string &fileName);
+}
+
+#endif
@@ -12,6 +12,7 @@
 #include "Evaluator.h" // to support evaluating the destructor
 #include "Ast.h"       // to support function evaluation, knowing the type hierarchy from Node->BlockStatement
 
+#include <algorithm>
 #include <sstream>
 #include <cstdlib>
 
@@ -32,6 +33,7 @@ namespace obj
 
     Environment::~Environment()
     {
+        delete[] stripes.load();
         instancesDestructed += 1;
     }
 
@@ -59,6 +61,12 @@ namespace obj
             return "ReturnValue";
         case ObjectType::Array:
             return "Array";
+        case ObjectType::ArrayInt:
+            return "ArrayInt";
+        case ObjectType::ArrayView:
+            return "ArrayView";
+        case ObjectType::NdArray:
+            return "NdArray";
         case ObjectType::ArrayDouble:
             return "ArrayDouble";
         case ObjectType::ArrayComplex:
@@ -89,6 +97,26 @@ namespace obj
             return "Module";
         case ObjectType::Thread:
             return "Thread";
+        case ObjectType::ThreadPool:
+            return "ThreadPool";
+        case ObjectType::Future:
+            return "Future";
+        case ObjectType::Channel:
+            return "Channel";
+        case ObjectType::Mutex:
+            return "Mutex";
+        case ObjectType::RwLock:
+            return "RwLock";
+        case ObjectType::LockGuard:
+            return "LockGuard";
+        case ObjectType::Condition:
+            return "Condition";
+        case ObjectType::Barrier:
+            return "Barrier";
+        case ObjectType::AtomicInt:
+            return "AtomicInt";
+        case ObjectType::NativeObject:
+            return "NativeObject";
         case ObjectType::Range:
             return "Range";
         case ObjectType::Regex:
@@ -154,6 +182,19 @@ namespace obj
         return "module";
     }
 
+    NativeObject::NativeObject(const std::shared_ptr<BuiltinType> &inativeType, const std::string &itypeName) : Object(ObjectType::NativeObject), nativeType(inativeType), typeName(itypeName)
+    {
+    }
+
+    NativeObject::~NativeObject()
+    {
+    }
+
+    std::string NativeObject::inspect() const
+    {
+        return "<" + typeName + ">";
+    }
+
     std::string Null::inspect() const
     {
         return "null";
@@ -213,6 +254,8 @@ namespace obj
 
         if (stride == 1)
             return upper - lower;
+        if (stride > 1)
+            return (upper - lower + stride - 1) / stride;
 
         int64_t count = 0;
         for (int64_t idx = lower; idx < upper; idx += stride)
@@ -270,6 +313,30 @@ namespace obj
         return "Exit(" + std::to_string(value) + ") at " + std::to_string(token.lineNumber) + ":" + std::to_string(token.columnNumber);
     }
 
+    void markShared(const std::shared_ptr<Object> &value)
+    {
+        if (!value)
+            return;
+        switch (value->type)
+        {
+        case ObjectType::Function:
+        {
+            auto function = static_cast<Function *>(value.get());
+            if (function->environment)
+                function->environment->markShared();
+            break;
+        }
+        case ObjectType::Array:
+            for (const auto &element : static_cast<Array *>(value.get())->value)
+                markShared(element);
+            break;
+        case ObjectType::Dictionary:
+            for (const auto &[key, element] : static_cast<Dictionary *>(value.get())->value)
+                markShared(element);
+            break;
+        }
+    }
+
     std::string Function::inspect() const
     {
         std::stringstream ss;
@@ -292,61 +359,131 @@ namespace obj
         return "Builtin function";
     }
 
+    namespace
+    {
+        /* the lock stripe of the calling thread, threads are spread over the stripes in the order they first read */
+        size_t threadLockStripe()
+        {
+            static std::atomic<size_t> nrThreads{0};
+            thread_local const size_t stripe = nrThreads.fetch_add(1) % Environment::nrLockStripes;
+            return stripe;
+        }
+    }
+
+    Environment::WriteLock::WriteLock(LockStripe *istripes) : stripes(istripes)
+    {
+        if (stripes)
+        {
+            for (size_t i = 0; i < nrLockStripes; ++i)
+                stripes[i].mutex.lock();
+        }
+    }
+
+    Environment::WriteLock::~WriteLock()
+    {
+        if (stripes)
+        {
+            for (size_t i = nrLockStripes; i > 0; --i)
+                stripes[i - 1].mutex.unlock();
+        }
+    }
+
+    void Environment::markShared()
+    {
+        for (Environment *environment = this; environment; environment = environment->outer.get())
+        {
+            if (environment->stripes.load(std::memory_order_acquire))
+                break; // the outer environments of a shared environment are already shared
+
+            LockStripe *expected = nullptr;
+            LockStripe *newStripes = new LockStripe[nrLockStripes];
+            if (!environment->stripes.compare_exchange_strong(expected, newStripes, std::memory_order_acq_rel))
+            {
+                delete[] newStripes;
+                break;
+            }
+        }
+    }
+
+    std::shared_lock<std::shared_mutex> Environment::readLock() const
+    {
+        if (auto lockStripes = stripes.load(std::memory_order_acquire))
+            return std::shared_lock<std::shared_mutex>(lockStripes[threadLockStripe()].mutex);
+        return std::shared_lock<std::shared_mutex>();
+    }
+
+    Environment::WriteLock Environment::writeLock() const
+    {
+        return WriteLock(stripes.load(std::memory_order_acquire));
+    }
+
+    void Environment::retainProgram(const std::shared_ptr<const cache::LoadedProgram> &program)
+    {
+        auto lock = writeLock();
+        if (std::find(programs.begin(), programs.end(), program) == programs.end())
+            programs.push_back(program);
+    }
+
     bool Environment::has(const std::string &name) const
     {
-        auto storeIt = store.find(name);
-        if (storeIt == store.end())
         {
-            if (outer)
-                return outer->has(name);
-            return false;
+            auto lock = readLock();
+            if (store.find(name) != store.end())
+                return true;
         }
-        return true;
+        if (outer)
+            return outer->has(name);
+        return false;
     }
 
     std::shared_ptr<Object> Environment::get(const std::string &name) const
     {
-        auto storeIt = store.find(name);
-        if (storeIt == store.end())
         {
-            if (outer)
-                return outer->get(name);
-            return std::make_unique<obj::Error>(obj::Error("Identifier not found: " + name, obj::ErrorType::IdentifierNotFound));
+            auto lock = readLock();
+            auto storeIt = store.find(name);
+            if (storeIt != store.end())
+                return storeIt->second.obj;
         }
-        return storeIt->second.obj;
+        if (outer)
+            return outer->get(name);
+        return std::make_unique<obj::Error>(obj::Error("Identifier not found: " + name, obj::ErrorType::IdentifierNotFound));
     }
 
     ast::TypeExpression *Environment::getType(const std::string &name) const
     {
-        auto storeIt = store.find(name);
-        if (storeIt == store.end())
         {
-            if (outer)
-                return outer->getType(name);
-            return nullptr;
+            auto lock = readLock();
+            auto storeIt = store.find(name);
+            if (storeIt != store.end())
+                return storeIt->second.type;
         }
-        return storeIt->second.type;
+        if (outer)
+            return outer->getType(name);
+        return nullptr;
     }
 
     std::shared_ptr<Object> Environment::set(const std::string &name, std::shared_ptr<Object> value)
     {
-        auto storeIt = store.find(name);
-        if (storeIt == store.end())
         {
-            if (outer)
-                return outer->set(name, value);
-            return std::make_unique<obj::Error>("identifier not found: " + name, obj::ErrorType::IdentifierNotFound);
+            auto lock = writeLock();
+            auto storeIt = store.find(name);
+            if (storeIt != store.end())
+            {
+                if (storeIt->second.constant)
+                    return std::make_unique<obj::Error>("variable is const: " + name, obj::ErrorType::ConstError);
+
+                storeIt->second.obj = std::move(value);
+                return storeIt->second.obj;
+            }
         }
-
-        if (storeIt->second.constant)
-            return std::make_unique<obj::Error>("variable is const: " + name, obj::ErrorType::ConstError);
-
-        storeIt->second.obj = std::move(value);
-        return storeIt->second.obj;
+        if (outer)
+            return outer->set(name, value);
+        return std::make_unique<obj::Error>("identifier not found: " + name, obj::ErrorType::IdentifierNotFound);
     }
 
     std::shared_ptr<Object> Environment::add(const std::string &name, std::shared_ptr<Object> value, bool constant, ast::TypeExpression *type)
     {
+        auto lock = writeLock();
         auto storeIt = store.find(name);
         if (storeIt != store.end())
         {
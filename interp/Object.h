@@ -16,11 +16,30 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <regex>
+#include <shared_mutex>
 #include <thread>
 
+namespace scheduler
+{
+    class WorkStealingPool;
+}
+
+namespace coroutine
+{
+    class Coroutine;
+}
+
+namespace cache
+{
+    struct LoadedProgram;
+}
+
 namespace obj
 {
     enum class ObjectType
@@ -61,6 +80,19 @@ namespace obj
         ContinueValue = 32,
         Clock = 33,
         TimePoint = 34,
+        ThreadPool = 35,
+        Future = 36,
+        Channel = 37,
+        Mutex = 38,
+        RwLock = 39,
+        LockGuard = 40,
+        Condition = 41,
+        Barrier = 42,
+        AtomicInt = 43,
+        NativeObject = 44,
+        ArrayInt = 45,
+        ArrayView = 46,
+        NdArray = 47,
     };
 
     std::string toString(const ObjectType &type);
@@ -70,7 +102,8 @@ namespace obj
         static std::atomic_int instancesConstructed;
         static std::atomic_int instancesDestructed;
 
-        int frozen = 0; /*< when frozen larger than 0 no updates allowed to object */
+        std::atomic_int frozen{0}; /*< when frozen larger than 0 no updates allowed to object, atomic as objects can be iterated from several threads */
+        std::atomic_bool immortal{false}; /*< immortal objects are deep-frozen for good, never destructed and referred to without reference counting */
         ObjectType type;
         ast::TypeExpression *declaredType = nullptr; /*< objects that have a declared type will carry non-nullptrs */
         virtual std::string inspect() const;
@@ -79,6 +112,14 @@ namespace obj
         virtual bool eq(const Object *other) const;
         virtual std::shared_ptr<Object> clone() const;
         Object(ObjectType itype = ObjectType::Unknown);
+        Object(const Object &other) : frozen(other.frozen.load()), type(other.type), declaredType(other.declaredType){};
+        Object &operator=(const Object &other)
+        {
+            frozen = other.frozen.load();
+            type = other.type;
+            declaredType = other.declaredType;
+            return *this;
+        }
         virtual ~Object();
 
         void *operator new(size_t size);
@@ -88,8 +129,20 @@ namespace obj
     struct ObjectFreezer : public Object
     {
         std::shared_ptr<Object> obj;
-        ObjectFreezer(std::shared_ptr<Object> iobj) : Object(ObjectType::Freezer), obj(iobj) { ++obj->frozen; }
-        ~ObjectFreezer() { --obj->frozen; }
+        // immortal objects stay frozen anyway, leaving their count alone avoids contention between the threads reading them
+        ObjectFreezer(std::shared_ptr<Object> iobj) : Object(ObjectType::Freezer), obj(iobj), counted(!obj->immortal)
+        {
+            if (counted)
+                ++obj->frozen;
+        }
+        ~ObjectFreezer()
+        {
+            if (counted)
+                --obj->frozen;
+        }
+
+    private:
+        bool counted;
     };
 
     enum class ErrorType : int
@@ -137,6 +190,46 @@ namespace obj
             ast::TypeExpression *type;
         };
         std::unordered_map<std::string, TTokenSharedObj> store;
+        std::vector<std::shared_ptr<const cache::LoadedProgram>> programs;
+
+        /* an environment that can be reached from more than one thread, such as the environment
+         * captured by the function of a thread or the environment of a module, is marked as shared
+         * and its store is then guarded by striped reader/writer locks: a reader only locks the stripe
+         * of its own thread, so that readers on different threads do not write to the same cache line,
+         * and a writer locks all stripes; all other environments, such as the frames of function calls
+         * inside a thread, remain lock-free
+         */
+        struct alignas(64) LockStripe
+        {
+            mutable std::shared_mutex mutex;
+        };
+        static constexpr size_t nrLockStripes = 16;
+        std::atomic<LockStripe *> stripes{nullptr}; /*< allocated when the environment is marked shared */
+
+        /* holds all stripes of a shared environment locked exclusively until it is destroyed */
+        class WriteLock
+        {
+        public:
+            explicit WriteLock(LockStripe *istripes);
+            WriteLock(const WriteLock &) = delete;
+            WriteLock &operator=(const WriteLock &) = delete;
+            ~WriteLock();
+
+        private:
+            LockStripe *stripes;
+        };
+
+        /* mark this environment and all its outer environments as shared */
+        void markShared();
+
+        /* locks on the store, only engaged when the environment is shared */
+        std::shared_lock<std::shared_mutex> readLock() const;
+        WriteLock writeLock() const;
+
+        /* keeps a program run in this environment alive: the functions and types it defines refer into its
+         * syntax tree and reach this environment through their closures
+         */
+        void retainProgram(const std::shared_ptr<const cache::LoadedProgram> &program);
 
         bool has(const std::string &) const;
         std::shared_ptr<Object> get(const std::string &) const;
@@ -276,6 +369,18 @@ namespace obj
         Iterator() : Object(ObjectType::Iterator){};
     };
 
+    struct ArrayInt : public Object
+    {
+        std::vector<int64_t> value;
+        static std::shared_ptr<Object> valueConstruct(const int64_t &value);
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override;
+        virtual bool eq(const Object *other) const;
+        ArrayInt(const std::vector<int64_t> &ivalue);
+        ArrayInt(std::vector<int64_t> &&ivalue);
+    };
+
     struct ArrayDouble : public Object
     {
         std::vector<double> value;
@@ -285,6 +390,7 @@ namespace obj
         virtual std::shared_ptr<Object> clone() const override;
         virtual bool eq(const Object *other) const;
         ArrayDouble(const std::vector<double> &ivalue);
+        ArrayDouble(std::vector<double> &&ivalue);
     };
 
     struct ArrayComplex : public Object
@@ -296,6 +402,7 @@ namespace obj
         virtual std::shared_ptr<Object> clone() const override;
         virtual bool eq(const Object *other) const;
         ArrayComplex(const std::vector<std::complex<double>> &ivalue);
+        ArrayComplex(std::vector<std::complex<double>> &&ivalue);
     };
 
     struct Array : public Object
@@ -314,6 +421,51 @@ namespace obj
         Array(const std::vector<std::complex<double>> &ivalue);
     };
 
+    /* a read-only view on part of an array, element index of the view is element offset + index * stride
+     * of the array; the array is kept alive and frozen for as long as the view exists, so creating a view
+     * does not copy any element.  A view on a view refers to the underlying array directly
+     */
+    struct ArrayView : public Object
+    {
+        std::shared_ptr<Object> array;
+        ObjectFreezer freezer;
+        size_t offset;
+        size_t length;
+        size_t stride;
+
+        std::shared_ptr<Object> element(size_t index) const;
+
+        virtual std::string inspect() const override;
+        /* copies the elements of the view into a new array of the type of the viewed array */
+        virtual std::shared_ptr<Object> clone() const override;
+        virtual bool eq(const Object *other) const override;
+        ArrayView(std::shared_ptr<Object> iarray, size_t ioffset, size_t ilength, size_t istride);
+    };
+
+    /* n-dimensional array of doubles, element (i0, i1, ...) is data->value[offset + i0 * strides[0] + i1 * strides[1] + ...].
+     * Indexing and transposing give an ndarray on the same elements, all other operations create new ones
+     */
+    struct NdArray : public Object
+    {
+        std::shared_ptr<ArrayDouble> data;
+        size_t offset = 0;
+        std::vector<size_t> shape;
+        std::vector<size_t> strides;
+
+        size_t size() const;
+        bool isContiguous() const;
+        /* the elements in row-major order */
+        std::vector<double> values() const;
+        /* element index along the first dimension, a double for a one-dimensional array */
+        std::shared_ptr<Object> at(size_t index) const;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override;
+        virtual bool eq(const Object *other) const override;
+        NdArray(std::vector<double> &&ivalues, const std::vector<size_t> &ishape);
+        NdArray(std::shared_ptr<ArrayDouble> idata, size_t ioffset, const std::vector<size_t> &ishape, const std::vector<size_t> &istrides);
+    };
+
     template <typename TArrayType>
     struct ArrayIterator : public Iterator
     {
@@ -345,6 +497,58 @@ namespace obj
         ArrayIterator(std::shared_ptr<TArrayType> iarray, size_t iindex) : Iterator(), array(iarray), freezer(iarray), index(iindex){};
     };
 
+    struct ArrayViewIterator : public Iterator
+    {
+        std::shared_ptr<ArrayView> view;
+        size_t index = 0;
+
+        virtual std::string inspect() const override
+        {
+            return "ArrayViewIterator()";
+        }
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::ArrayViewIterator>(view, index);
+        }
+        virtual bool isValid() const override
+        {
+            return index < view->length;
+        };
+        virtual std::shared_ptr<Object> next() override
+        {
+            if (isValid())
+                return view->element(index++);
+            return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
+        }
+        ArrayViewIterator(std::shared_ptr<ArrayView> iview, size_t iindex) : Iterator(), view(iview), index(iindex){};
+    };
+
+    struct NdArrayIterator : public Iterator
+    {
+        std::shared_ptr<NdArray> array;
+        size_t index = 0;
+
+        virtual std::string inspect() const override
+        {
+            return "NdArrayIterator()";
+        }
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::NdArrayIterator>(array, index);
+        }
+        virtual bool isValid() const override
+        {
+            return index < array->shape.front();
+        };
+        virtual std::shared_ptr<Object> next() override
+        {
+            if (isValid())
+                return array->at(index++);
+            return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
+        }
+        NdArrayIterator(std::shared_ptr<NdArray> iarray, size_t iindex) : Iterator(), array(iarray), index(iindex){};
+    };
+
     struct RangeIterator : public Iterator
     {
         std::shared_ptr<Range> rangeObj;
@@ -442,17 +646,26 @@ namespace obj
         Dictionary(const TDictionaryMap &ivalue);
     };
 
+    /* what a DictionaryIterator hands out, items are [key, value] pairs */
+    enum class DictionaryView
+    {
+        Keys,
+        Values,
+        Items,
+    };
+
     struct DictionaryIterator : public Iterator
     {
         std::shared_ptr<Dictionary> dict;
         ObjectFreezer freezer;
         TDictionaryMap::iterator iterator;
+        DictionaryView view = DictionaryView::Keys;
 
         virtual std::string inspect() const override;
         virtual std::shared_ptr<Object> clone() const override;
         virtual bool isValid() const override;
         virtual std::shared_ptr<Object> next() override;
-        DictionaryIterator(std::shared_ptr<Dictionary> idict, TDictionaryMap::iterator iiterator);
+        DictionaryIterator(std::shared_ptr<Dictionary> idict, TDictionaryMap::iterator iiterator, DictionaryView iview = DictionaryView::Keys);
     };
 
     typedef std::unordered_set<std::shared_ptr<Object>, obj::Hash, obj::Equal> TSetSet;
@@ -487,6 +700,7 @@ namespace obj
         std::vector<ast::TypeExpression *> argumentTypes;
         ast::TypeExpression *returnType = 0;
         ast::BlockStatement *body = 0;
+        bool isGenerator = false; /*< calling it returns a generator over the values yielded by body */
         std::shared_ptr<obj::Environment> environment;
         virtual std::string inspect() const override;
         virtual std::shared_ptr<Object> clone() const override
@@ -496,18 +710,32 @@ namespace obj
             func->argumentTypes = argumentTypes;
             func->returnType = returnType;
             func->body = body;
+            func->isGenerator = isGenerator;
             func->environment = environment;
             return func;
         };
         Function() : Object(ObjectType::Function) {}
     };
 
+    /* mark the environments reachable from value as shared before value is handed to another thread: the
+     * environment of a function and those of the functions held by an array or a dictionary
+     */
+    void markShared(const std::shared_ptr<Object> &value);
+
     typedef std::shared_ptr<obj::Object> (*TBuiltinFunction)(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
+    /* a native function of a host embedding the interpreter, called with the evaluated arguments */
+    typedef std::function<std::shared_ptr<obj::Object>(const std::vector<std::shared_ptr<obj::Object>> &arguments)> THostFunction;
     struct Builtin : public Object
     {
         TBuiltinFunction function;
+        THostFunction hostFunction; /*< used instead of function when set */
         virtual std::string inspect() const override;
-        virtual std::shared_ptr<Object> clone() const override { return std::make_shared<Builtin>(function); };
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            auto builtin = std::make_shared<Builtin>(function);
+            builtin->hostFunction = hostFunction;
+            return builtin;
+        };
         Builtin(TBuiltinFunction ifunction = nullptr) : Object(ObjectType::Builtin), function(ifunction) {}
     };
 
@@ -711,13 +939,262 @@ namespace obj
         Thread();
         virtual ~Thread();
 
-        void start();
+        /* self is this thread object, kept alive by the thread until it ends */
+        void start(const std::shared_ptr<Thread> &self);
         void join();
         bool joinable() const;
         void detach();
 
         void run();
     };
+
+    struct ThreadPool : public Object
+    {
+        std::shared_ptr<scheduler::WorkStealingPool> pool;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::ThreadPool>(pool);
+        };
+        ThreadPool(const std::shared_ptr<scheduler::WorkStealingPool> &ipool);
+        virtual ~ThreadPool();
+    };
+
+    /* outcome of a task submitted to a thread pool, set exactly once by the worker executing the task */
+    struct Future : public Object
+    {
+        mutable std::mutex mutex;
+        mutable std::condition_variable condition;
+        bool ready = false;
+        std::shared_ptr<Object> value;
+        std::vector<std::function<void()>> continuations;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::Future>();
+        };
+        Future();
+        virtual ~Future();
+
+        void set(const std::shared_ptr<Object> &ivalue);
+        /* call continuation once the value is set, from the thread setting it or immediately when already set */
+        void onReady(std::function<void()> continuation);
+        bool done() const;
+        /* blocks until the value is set, a worker thread of the pool executes pending tasks while waiting */
+        const std::shared_ptr<Object> &wait() const;
+    };
+
+    /* bounded multi-producer multi-consumer queue of objects to pass data between threads,
+     * the ring of cells follows the design of Dmitry Vyukov so that sending to a channel
+     * that is not full, and receiving from one that is not empty, never takes a lock;
+     * only threads that have to wait block on a condition variable
+     */
+    struct Channel : public Object
+    {
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            std::shared_ptr<Object> value;
+        };
+
+        const size_t capacity;
+        std::unique_ptr<Cell[]> cells;
+        std::atomic<size_t> sendPosition{0};
+        std::atomic<size_t> receivePosition{0};
+        std::atomic_bool closed{false};
+
+        std::mutex waitMutex;
+        std::condition_variable notEmpty;
+        std::condition_variable notFull;
+        std::atomic<size_t> waitingSenders{0};
+        std::atomic<size_t> waitingReceivers{0};
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::Channel>(capacity);
+        };
+        Channel(size_t icapacity);
+        virtual ~Channel();
+
+        /* non-blocking variants, false when the channel is full (or closed) respectively empty */
+        bool trySend(const std::shared_ptr<Object> &value);
+        bool tryReceive(std::shared_ptr<Object> &value);
+        /* blocking variants, false when the channel is closed (and for receive also drained) */
+        bool send(const std::shared_ptr<Object> &value);
+        bool receive(std::shared_ptr<Object> &value);
+        void close();
+
+    private:
+        /* the lock-free operations on the ring of cells */
+        bool push(const std::shared_ptr<Object> &value);
+        bool pop(std::shared_ptr<Object> &value);
+        void wakeWaiter(std::atomic<size_t> &waiting, std::condition_variable &condition);
+    };
+
+    struct Mutex : public Object
+    {
+        std::mutex mutex;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::Mutex>();
+        };
+        Mutex();
+        virtual ~Mutex();
+    };
+
+    struct RwLock : public Object
+    {
+        std::shared_mutex mutex;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::RwLock>();
+        };
+        RwLock();
+        virtual ~RwLock();
+    };
+
+    /* holds a mutex or rwlock locked until it is destroyed or unlocked, like the ObjectFreezer
+     * does for freezing, so a lock is released when the guard goes out of scope
+     */
+    struct LockGuard : public Object
+    {
+        std::shared_ptr<Object> lockable; /*< keeps the mutex or rwlock alive while locked */
+        std::unique_lock<std::mutex> mutexLock;
+        std::unique_lock<std::shared_mutex> writeLock;
+        std::shared_lock<std::shared_mutex> readLock;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::LockGuard>(lockable);
+        };
+        LockGuard(std::shared_ptr<Object> ilockable);
+        virtual ~LockGuard();
+
+        bool locked() const;
+        void unlock();
+    };
+
+    struct Condition : public Object
+    {
+        std::condition_variable condition;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::Condition>();
+        };
+        Condition();
+        virtual ~Condition();
+    };
+
+    /* reusable barrier, each round completes when the given number of threads arrived */
+    struct Barrier : public Object
+    {
+        const size_t nrThreads;
+        size_t nrArrived = 0;
+        size_t round = 0;
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::Barrier>(nrThreads);
+        };
+        Barrier(size_t inrThreads);
+        virtual ~Barrier();
+
+        /* returns true for exactly one thread per round, the last one to arrive */
+        bool arriveAndWait();
+    };
+
+    struct AtomicInt : public Object
+    {
+        std::atomic<int64_t> value;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::AtomicInt>(value.load());
+        };
+        AtomicInt(int64_t ivalue);
+        virtual ~AtomicInt();
+    };
+
+    /* base of the objects defined by a native module, a native module derives from it to hold its own
+     * data; the member functions and properties are looked up in nativeType instead of in the builtin
+     * types of the interpreter.  Only the derived type knows its data, so it implements clone itself
+     */
+    struct NativeObject : public Object
+    {
+        std::shared_ptr<BuiltinType> nativeType;
+        std::string typeName;
+
+        virtual std::string inspect() const override;
+        virtual std::shared_ptr<Object> clone() const override = 0;
+        NativeObject(const std::shared_ptr<BuiltinType> &inativeType, const std::string &itypeName);
+        virtual ~NativeObject();
+    };
+
+    struct ChannelIterator : public Iterator
+    {
+        std::shared_ptr<Channel> channel;
+        mutable std::shared_ptr<Object> received; /*< value received by isValid, handed out by next */
+
+        virtual std::string inspect() const override
+        {
+            return "ChannelIterator()";
+        }
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::ChannelIterator>(channel);
+        }
+        /* blocks until a value is received, invalid once the channel is closed and drained */
+        virtual bool isValid() const override;
+        virtual std::shared_ptr<Object> next() override;
+        ChannelIterator(std::shared_ptr<Channel> ichannel) : Iterator(), channel(ichannel){};
+    };
+
+    /* iterator over the values yielded by the body of a generator function, the body runs
+     * on a coroutine of its own and is suspended at every yield until the next value is asked for;
+     * only the thread that created the generator can ask for values
+     */
+    struct Generator : public Iterator
+    {
+        typedef std::function<std::shared_ptr<Object>()> TBody;
+
+        mutable std::recursive_mutex mutex;                  /*< one consumer at a time resumes the body */
+        mutable std::unique_ptr<coroutine::Coroutine> body;
+        mutable std::shared_ptr<Object> yielded; /*< value yielded by the body, handed out by next */
+        bool stopping = false;                   /*< set when destroyed early, yield then unwinds the body */
+        std::weak_ptr<Generator> self;           /*< kept alive while the body runs, set by its creator */
+
+        virtual std::string inspect() const override
+        {
+            return "Generator()";
+        }
+        /* a generator cannot be restarted, its clone is an exhausted iterator */
+        virtual std::shared_ptr<Object> clone() const override
+        {
+            return std::make_shared<obj::Iterator>();
+        }
+        /* resumes the body until it yields the next value, invalid once the body finished */
+        virtual bool isValid() const override;
+        virtual std::shared_ptr<Object> next() override;
+        Generator(TBody ibody);
+        ~Generator();
+
+    private:
+        void resume() const;
+    };
 }
 
 #endif
\ No newline at end of file
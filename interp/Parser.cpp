@@ -249,6 +249,8 @@ std::unique_ptr<ast::Program> Parser::parseProgram()
             statement = parseTryExceptStatement();
         else if (curToken.type == TokenType::RETURN)
             statement = parseReturnStatement();
+        else if (curToken.type == TokenType::YIELD)
+            statement = parseYieldStatement();
         else if (curToken.type == TokenType::BREAK)
             statement = parseBreakStatement();
         else if (curToken.type == TokenType::CONTINUE)
@@ -529,7 +531,9 @@ std::unique_ptr<ast::Expression> Parser::parseFunctionLiteral()
     if (!expectPeek(TokenType::LBRACE))
         return nullptr;
 
+    functionLiterals.push_back(funcLiteral.get());
     funcLiteral->body = parseBlockStatement();
+    functionLiterals.pop_back();
 
     return funcLiteral;
 }
@@ -998,6 +1002,8 @@ std::unique_ptr<ast::Statement> Parser::parseStatement()
         return parseLetStatement();
     else if (curToken.type == TokenType::RETURN)
         return parseReturnStatement();
+    else if (curToken.type == TokenType::YIELD)
+        return parseYieldStatement();
     else if (curToken.type == TokenType::BREAK)
         return parseBreakStatement();
     else if (curToken.type == TokenType::CONTINUE)
@@ -1170,6 +1176,27 @@ std::unique_ptr<ast::ReturnStatement> Parser::parseReturnStatement()
     return returnStatement;
 }
 
+std::unique_ptr<ast::YieldStatement> Parser::parseYieldStatement()
+{
+    std::unique_ptr<ast::YieldStatement> yieldStatement = std::make_unique<ast::YieldStatement>();
+    yieldStatement->token = curToken;
+
+    // a yield turns the innermost enclosing function into a generator
+    if (functionLiterals.empty())
+        parseError("yield outside of a function", curToken);
+    else
+        functionLiterals.back()->isGenerator = true;
+
+    advanceTokens();
+
+    yieldStatement->value = parseExpression(Precedence::LOWEST);
+
+    if (peekToken.type == TokenType::SEMICOLON)
+        advanceTokens();
+
+    return yieldStatement;
+}
+
 std::unique_ptr<ast::BreakStatement> Parser::parseBreakStatement()
 {
     std::unique_ptr<ast::BreakStatement> breakStatement = std::make_unique<ast::BreakStatement>();
@@ -63,6 +63,7 @@ struct Parser
     void peekError(const TokenType &t);
     void parseError(const std::string &msg, const Token &token);
     std::vector<ParserError> errorMsgs;
+    std::vector<ast::FunctionLiteral *> functionLiterals; /*< function literals whose body is being parsed, innermost last */
 
     std::unique_ptr<ast::ExpressionStatement> parseExpressionStatement();
     std::unique_ptr<ast::Statement> parseStatement();
@@ -72,6 +73,7 @@ struct Parser
     std::unique_ptr<ast::ScopeStatement> parseScopeStatement();
     std::unique_ptr<ast::TypeStatement> parseTypeStatement();
     std::unique_ptr<ast::ReturnStatement> parseReturnStatement();
+    std::unique_ptr<ast::YieldStatement> parseYieldStatement();
     std::unique_ptr<ast::BreakStatement> parseBreakStatement();
     std::unique_ptr<ast::ContinueStatement> parseContinueStatement();
     std::unique_ptr<ast::TryExceptStatement> parseTryExceptStatement();
@@ -11,6 +11,7 @@
 #include <map>
 #include <vector>
 #include "Parser.h"
+#include "AstSerializer.h"
 
 void testLetStatement()
 {
@@ -53,6 +54,29 @@ void testReturnStatement()
     }
 }
 
+void testYieldStatement()
+{
+    std::string input = "let g = fn(n) { let f = fn() { return 1; }; yield n; };";
+    auto lexer = createLexer(input, "");
+    auto parser = createParser(std::move(lexer));
+    auto program = parser->parseProgram();
+    checkParserErrors(*parser, 0);
+
+    auto letStatement = dynamic_cast<ast::LetStatement *>(program->statements[0].get());
+    auto generator = letStatement ? dynamic_cast<ast::FunctionLiteral *>(letStatement->value.get()) : nullptr;
+    if (!generator || !generator->isGenerator)
+        throw std::runtime_error("Expected a function literal marked as generator");
+
+    auto innerLet = dynamic_cast<ast::LetStatement *>(generator->body->statements[0].get());
+    auto inner = innerLet ? dynamic_cast<ast::FunctionLiteral *>(innerLet->value.get()) : nullptr;
+    if (!inner || inner->isGenerator)
+        throw std::runtime_error("Expected the nested function literal not to be a generator");
+
+    auto outsideParser = createParser(createLexer("yield 1;", ""));
+    outsideParser->parseProgram();
+    checkParserErrors(*outsideParser, 1);
+}
+
 void testProgramStringify()
 {
     std::string input = "let var = anothervar;\n";
@@ -382,6 +406,38 @@ void testCallExpression()
         throw std::runtime_error("Expected 3 arguments");
 }
 
+void testSerializeRoundTrip()
+{
+    std::string input = "let a : [int] = [1,2,3]; let b = {1:2.0, \"c\":{1}};\n"
+                        "let f = fn(x : int, y) -> [double] { if (x < 2) { return [1.0, 2.0]; } else { return null; }; };\n"
+                        "type T { a : int = 1; const b : int = 3; construct = fn() -> null { this.a = 5; }; };\n"
+                        "for (const i : int in 0..10) { while (true) { break; }; continue; };\n"
+                        "let g = fn(n : int) { for (i in range(n)) { yield i * i; }; };\n"
+                        "try { a[0] += -1; } except (e) { scope { 1+2.5; [1.5, 2.5]; } } m::n.k(b);";
+    auto lexer = createLexer(input, "");
+    auto parser = createParser(std::move(lexer));
+    auto program = parser->parseProgram();
+    checkParserErrors(*parser, 0);
+
+    std::stringstream ss;
+    ast::serialize(*program, ss);
+    auto fileName = std::make_shared<std::string>("roundtrip.luci");
+    auto restored = ast::deserialize(ss, fileName);
+    if (!restored)
+        throw std::runtime_error("Expected a deserialized program");
+
+    if (restored->text() != program->text())
+        throw std::runtime_error("Expected identical program text after round trip, got " + restored->text());
+
+    if (restored->statements.empty() || restored->statements.front()->token.fileName != fileName)
+        throw std::runtime_error("Expected file name to be restored on the tokens");
+
+    std::string serialized = ss.str();
+    std::stringstream truncated(serialized.substr(0, serialized.size() / 2));
+    if (ast::deserialize(truncated, fileName))
+        throw std::runtime_error("Expected truncated stream to be rejected");
+}
+
 int main()
 {
     try
@@ -389,6 +445,7 @@ int main()
         testLetStatement();
         testLetStatementMissingAssign();
         testReturnStatement();
+        testYieldStatement();
         testProgramStringify();
         testIdentifierExpression();
         testIntegerLiteralExpression();
@@ -399,6 +456,7 @@ int main()
         testIfExpression();
         testFunctionLiteralParsing();
         testCallExpression();
+        testSerializeRoundTrip();
         std::cerr << "All tests passed" << std::endl;
         return 0;
     }
@@ -0,0 +1,192 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Random.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace
+{
+    /* splitmix64, turns a seed into well mixed state words */
+    uint64_t splitMix64(uint64_t &x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    /* the same scheme with another increment and the mixing constants of moremur (Evensen), so that the
+     * words derived from a stream are independent of the words splitMix64 derives from an equal seed
+     */
+    uint64_t streamMix64(uint64_t &y)
+    {
+        uint64_t z = (y += 0xd1b54a32d192ed03ULL);
+        z = (z ^ (z >> 27)) * 0x3c79ac492ba7b653ULL;
+        z = (z ^ (z >> 33)) * 0x1c69b3f74ac4ae35ULL;
+        return z ^ (z >> 27);
+    }
+
+    /* the entropy all threads that are not seeded explicitly derive their seed from */
+    uint64_t processSeed()
+    {
+        static const uint64_t seed = []()
+        {
+            std::random_device device;
+            return (static_cast<uint64_t>(device()) << 32) ^ device();
+        }();
+        return seed;
+    }
+
+    std::atomic<uint64_t> threadCount{0};
+}
+
+namespace rng
+{
+    std::string toString(Algorithm algorithm)
+    {
+        switch (algorithm)
+        {
+        case Algorithm::Xoshiro256StarStar:
+            return "xoshiro256**";
+        case Algorithm::Pcg32:
+            return "pcg32";
+        }
+        return "";
+    }
+
+    bool fromString(const std::string &name, Algorithm &algorithm)
+    {
+        if (name == "xoshiro256**")
+            algorithm = Algorithm::Xoshiro256StarStar;
+        else if (name == "pcg32")
+            algorithm = Algorithm::Pcg32;
+        else
+            return false;
+        return true;
+    }
+
+    Generator::Generator()
+    {
+        seed(0, 0, Algorithm::Xoshiro256StarStar);
+    }
+
+    void Generator::seed(uint64_t seed, uint64_t stream, Algorithm algorithm)
+    {
+        currentAlgorithm = algorithm;
+        hasSpareNormal = false;
+        uint64_t x = seed;
+        if (algorithm == Algorithm::Pcg32)
+        {
+            // the initialisation of the reference implementation, the increment has to be odd
+            state[0] = 0;
+            state[1] = (stream << 1) | 1;
+            nextPcg32();
+            state[0] += splitMix64(x);
+            nextPcg32();
+            return;
+        }
+
+        // a sequence of the stream, mixed differently than the sequence of the seed, is mixed into the state of
+        // stream 0, so that seeding takes the same time for any stream; the streams are not a known distance
+        // apart as with jumps of 2^128 values, but with a period of 2^256 - 1 two streams overlapping within
+        // 2^64 values has a probability of 2^-128
+        uint64_t y = stream;
+        for (auto &word : state)
+            word = splitMix64(x) ^ (stream == 0 ? 0 : streamMix64(y));
+
+        // xoshiro256** only returns 0 from a state of all zeros, which no other state leads to
+        if ((state[0] | state[1] | state[2] | state[3]) == 0)
+            state[0] = 0x9e3779b97f4a7c15ULL;
+    }
+
+    int64_t Generator::integer(int64_t lower, int64_t upper)
+    {
+        // the number of values minus one, wrapping around for the full range of int64_t
+        const uint64_t range = static_cast<uint64_t>(upper) - static_cast<uint64_t>(lower);
+        if (range == std::numeric_limits<uint64_t>::max())
+            return static_cast<int64_t>(next());
+
+        // values at or above limit would make the smaller remainders more likely and are drawn again
+        const uint64_t count = range + 1;
+        const uint64_t limit = std::numeric_limits<uint64_t>::max() - std::numeric_limits<uint64_t>::max() % count;
+        uint64_t value = next();
+        while (value >= limit)
+            value = next();
+        return static_cast<int64_t>(static_cast<uint64_t>(lower) + value % count);
+    }
+
+    double Generator::normal()
+    {
+        if (hasSpareNormal)
+        {
+            hasSpareNormal = false;
+            return spareNormal;
+        }
+
+        double u, v, s;
+        do
+        {
+            u = 2.0 * uniform() - 1.0;
+            v = 2.0 * uniform() - 1.0;
+            s = u * u + v * v;
+        } while (s >= 1.0 || s == 0.0);
+
+        const double factor = std::sqrt(-2.0 * std::log(s) / s);
+        spareNormal = v * factor;
+        hasSpareNormal = true;
+        return u * factor;
+    }
+
+    double Generator::exponential()
+    {
+        // 1 - uniform() lies in (0, 1], so that the logarithm is finite
+        return -std::log(1.0 - uniform());
+    }
+
+    Generator &threadGenerator()
+    {
+        thread_local Generator generator = []()
+        {
+            Generator result;
+            uint64_t x = processSeed() + threadCount.fetch_add(1);
+            result.seed(splitMix64(x), 0, Algorithm::Xoshiro256StarStar);
+            return result;
+        }();
+        return generator;
+    }
+
+    void fillUniform(Generator &generator, double *out, size_t n, double lower, double upper)
+    {
+        const double width = upper - lower;
+        for (size_t i = 0; i < n; ++i)
+            out[i] = lower + width * generator.uniform();
+    }
+
+    void fillNormal(Generator &generator, double *out, size_t n, double mean, double deviation)
+    {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = mean + deviation * generator.normal();
+    }
+
+    void fillExponential(Generator &generator, double *out, size_t n, double rate)
+    {
+        const double scale = 1.0 / rate;
+        for (size_t i = 0; i < n; ++i)
+            out[i] = scale * generator.exponential();
+    }
+
+    void fillIntegers(Generator &generator, int64_t *out, size_t n, int64_t lower, int64_t upper)
+    {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = generator.integer(lower, upper);
+    }
+}
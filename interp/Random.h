@@ -0,0 +1,115 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_RANDOM_H
+#define GUARDIAN_OF_INCLUSION_RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* pseudo random numbers for the random module.  Every thread draws from a generator of its own, so
+ * that no locking is needed; a thread that is not seeded explicitly gets a seed derived from the
+ * entropy of the system and an index of the thread.  Seeding with the same seed and a different stream
+ * gives sequences that do not overlap in practice, one for each thread of a computation that must be
+ * reproducible; any stream is seeded in the same time.
+ */
+namespace rng
+{
+    enum class Algorithm
+    {
+        Xoshiro256StarStar, /*< xoshiro256** by Blackman and Vigna, streams mix a splitmix64 sequence into the state */
+        Pcg32,              /*< pcg32 (XSH-RR) by O'Neill, streams use a different increment */
+    };
+
+    /* the name used by the random module, and the algorithm for a name; returns false for an unknown name */
+    std::string toString(Algorithm algorithm);
+    bool fromString(const std::string &name, Algorithm &algorithm);
+
+    class Generator
+    {
+    public:
+        Generator();
+
+        void seed(uint64_t seed, uint64_t stream, Algorithm algorithm);
+        Algorithm algorithm() const { return currentAlgorithm; }
+
+        /* 64 uniformly distributed bits */
+        uint64_t next()
+        {
+            if (currentAlgorithm == Algorithm::Pcg32)
+            {
+                const uint64_t high = nextPcg32();
+                return (high << 32) | nextPcg32();
+            }
+            return nextXoshiro();
+        }
+
+        /* uniform in [0, 1), all 53 bits of the mantissa are random */
+        double uniform()
+        {
+            return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        /* uniform integer in [lower, upper], without the bias of taking a remainder */
+        int64_t integer(int64_t lower, int64_t upper);
+
+        /* standard normal, by the polar method of Marsaglia which gives two values per pair of uniforms */
+        double normal();
+
+        /* exponential with rate 1 */
+        double exponential();
+
+    private:
+        uint64_t nextXoshiro()
+        {
+            const uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+            const uint64_t t = state[1] << 17;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotateLeft(state[3], 45);
+            return result;
+        }
+
+        uint32_t nextPcg32()
+        {
+            const uint64_t old = state[0];
+            state[0] = old * 6364136223846793005ULL + state[1];
+            const auto xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+            const auto rotation = static_cast<uint32_t>(old >> 59);
+            return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+        }
+
+        static uint64_t rotateLeft(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        Algorithm currentAlgorithm = Algorithm::Xoshiro256StarStar;
+        uint64_t state[4]; /*< the state of xoshiro256**, or the state and increment of pcg32 */
+        bool hasSpareNormal = false;
+        double spareNormal = 0.0;
+    };
+
+    /* the generator of the calling thread */
+    Generator &threadGenerator();
+
+    /* out[i] for i < n drawn from the generator, uniform in [lower, upper) */
+    void fillUniform(Generator &generator, double *out, size_t n, double lower, double upper);
+    /* normal with the given mean and standard deviation */
+    void fillNormal(Generator &generator, double *out, size_t n, double mean, double deviation);
+    /* exponential with the given rate */
+    void fillExponential(Generator &generator, double *out, size_t n, double rate);
+    /* uniform integers in [lower, upper] */
+    void fillIntegers(Generator &generator, int64_t *out, size_t n, int64_t lower, int64_t upper);
+}
+
+#endif
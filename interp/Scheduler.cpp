@@ -0,0 +1,293 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+namespace
+{
+    thread_local scheduler::WorkStealingPool *currentPool = nullptr;
+    thread_local size_t currentWorkerIndex = 0;
+
+    std::atomic<size_t> parallelThreadCount{0}; /*< 0 until set by setParallelThreads */
+    std::atomic<size_t> parallelElementThreshold{32768};
+
+    size_t defaultParallelThreads()
+    {
+        static const size_t n = []() -> size_t
+        {
+            const char *value = std::getenv("LUCI_NUM_THREADS");
+            if (value)
+            {
+                char *end = nullptr;
+                const long long requested = std::strtoll(value, &end, 10);
+                if (end != value && *end == '\0' && requested > 0)
+                    return static_cast<size_t>(requested);
+            }
+            return scheduler::WorkStealingPool::shared().size();
+        }();
+        return n;
+    }
+
+    /* the chunks of one call of parallelFor, shared with the tasks that help the calling thread */
+    struct ParallelForState
+    {
+        const std::function<void(size_t, size_t)> *body = nullptr; /*< only used after claiming a chunk */
+        size_t n = 0;
+        size_t chunkSize = 0;
+        size_t nrChunks = 0;
+        std::atomic<size_t> nextChunk{0};
+
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        size_t remaining = 0;     /*< chunks not done yet, changed under doneMutex */
+        std::exception_ptr error; /*< the first exception thrown by a chunk, rethrown by the calling thread */
+
+        /* claims and runs the next chunk, false when all chunks were claimed already */
+        bool runChunk()
+        {
+            const size_t chunk = nextChunk++;
+            if (chunk >= nrChunks)
+                return false;
+
+            const size_t begin = chunk * chunkSize;
+            try
+            {
+                (*body)(begin, std::min(n, begin + chunkSize));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+
+            // the count is only changed under the mutex so that the last chunk is done with the mutex
+            // before the waiting thread can return
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remaining == 0)
+                doneCondition.notify_all();
+            return true;
+        }
+    };
+
+    /* runs the nrChunks chunks of chunkSize elements covering [0, n) on the calling thread and on nrHelpers tasks
+     * submitted to the shared pool, waits until all are done and rethrows the first exception of body
+     */
+    void runChunks(size_t n, size_t chunkSize, size_t nrChunks, size_t nrHelpers, const std::function<void(size_t, size_t)> &body)
+    {
+        // the chunks are claimed through a shared index by the calling thread and by the tasks submitted to
+        // help it, so that the calling thread only ever runs chunks of this call and never an unrelated task
+        // of the pool while it waits.  A task that starts after all chunks are claimed finds nothing to do,
+        // it can outlive the call and therefore shares the state instead of referring to the stack
+        auto state = std::make_shared<ParallelForState>();
+        state->body = &body;
+        state->n = n;
+        state->chunkSize = chunkSize;
+        state->nrChunks = nrChunks;
+        state->remaining = nrChunks;
+        auto &pool = scheduler::WorkStealingPool::shared();
+        for (size_t helper = 0; helper < nrHelpers; ++helper)
+            pool.submit([state]()
+                        {
+                            while (state->runChunk())
+                                ; });
+
+        while (state->runChunk())
+            ;
+
+        std::unique_lock<std::mutex> lock(state->doneMutex);
+        state->doneCondition.wait(lock, [&state]()
+                                  { return state->remaining == 0; });
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+}
+
+namespace scheduler
+{
+    WorkStealingPool::WorkStealingPool(size_t nrWorkers)
+    {
+        if (nrWorkers == 0)
+            nrWorkers = 1;
+
+        for (size_t i = 0; i < nrWorkers; ++i)
+            queues.push_back(std::make_unique<WorkerQueue>());
+        for (size_t i = 0; i < nrWorkers; ++i)
+            workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCondition.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    void WorkStealingPool::submit(TTask task)
+    {
+        size_t index = (currentPool == this) ? currentWorkerIndex : (nextQueue++ % queues.size());
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        ++pending;
+
+        // only pay for the wake-up when a worker is actually asleep, a worker announces
+        // itself in sleeping before it re-checks pending, so the wake-up cannot be lost
+        if (sleeping.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+            }
+            sleepCondition.notify_one();
+        }
+    }
+
+    bool WorkStealingPool::popTask(size_t index, TTask &task)
+    {
+        auto &queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            return false;
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        --pending;
+        return true;
+    }
+
+    bool WorkStealingPool::stealTask(size_t thief, TTask &task)
+    {
+        const size_t nrQueues = queues.size();
+        for (size_t offset = 1; offset <= nrQueues; ++offset)
+        {
+            auto &queue = *queues[(thief + offset) % nrQueues];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --pending;
+            return true;
+        }
+        return false;
+    }
+
+    bool WorkStealingPool::runPendingTask()
+    {
+        if (pending.load() == 0)
+            return false;
+
+        TTask task;
+        const size_t index = (currentPool == this) ? currentWorkerIndex : 0;
+        if (!((currentPool == this && popTask(index, task)) || stealTask(index, task)))
+            return false;
+        task();
+        return true;
+    }
+
+    void WorkStealingPool::workerLoop(size_t index)
+    {
+        currentPool = this;
+        currentWorkerIndex = index;
+
+        while (true)
+        {
+            TTask task;
+            if (popTask(index, task) || stealTask(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            ++sleeping;
+            sleepCondition.wait(lock, [this]()
+                                { return stopping || pending.load() > 0; });
+            --sleeping;
+            if (stopping && pending.load() == 0)
+                break;
+        }
+
+        currentPool = nullptr;
+    }
+
+    size_t WorkStealingPool::size() const
+    {
+        return workers.size();
+    }
+
+    bool WorkStealingPool::isWorkerThread() const
+    {
+        return currentPool == this;
+    }
+
+    WorkStealingPool *WorkStealingPool::current()
+    {
+        return currentPool;
+    }
+
+    WorkStealingPool &WorkStealingPool::shared()
+    {
+        // deliberately never destroyed, the idle workers are simply abandoned at exit
+        // instead of racing the destruction of the interpreter state they refer to
+        static WorkStealingPool *sharedPool = new WorkStealingPool(std::max<size_t>(1, std::thread::hardware_concurrency()));
+        return *sharedPool;
+    }
+
+    void parallelFor(size_t n, size_t minChunk, const std::function<void(size_t, size_t)> &body)
+    {
+        const size_t nrThreads = parallelThreads();
+        minChunk = std::max<size_t>(1, minChunk);
+        if (n <= minChunk || nrThreads <= 1)
+        {
+            body(0, n);
+            return;
+        }
+
+        const size_t nrChunks = std::min(nrThreads, (n + minChunk - 1) / minChunk);
+        runChunks(n, (n + nrChunks - 1) / nrChunks, nrChunks, nrChunks - 1, body);
+    }
+
+    void parallelForChunks(size_t n, size_t chunkSize, const std::function<void(size_t, size_t)> &body)
+    {
+        if (n == 0)
+            return;
+        chunkSize = std::max<size_t>(1, chunkSize);
+        const size_t nrChunks = (n + chunkSize - 1) / chunkSize;
+        runChunks(n, chunkSize, nrChunks, std::min(parallelThreads(), nrChunks) - 1, body);
+    }
+
+    size_t parallelThreads()
+    {
+        const size_t n = parallelThreadCount.load();
+        return n > 0 ? n : defaultParallelThreads();
+    }
+
+    void setParallelThreads(size_t n)
+    {
+        parallelThreadCount = n;
+    }
+
+    size_t parallelThreshold()
+    {
+        return parallelElementThreshold.load();
+    }
+
+    void setParallelThreshold(size_t n)
+    {
+        parallelElementThreshold = n;
+    }
+}
@@ -0,0 +1,149 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_SCHEDULER_H
+#define GUARDIAN_OF_INCLUSION_SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace scheduler
+{
+    typedef std::function<void()> TTask;
+
+    /* fixed size pool of worker threads, each worker owns a queue of tasks on which it
+     * operates at the back (LIFO, cache friendly for tasks spawning tasks) while idle
+     * workers steal from the front of the queues of the other workers (FIFO)
+     *
+     * tasks submitted from a worker of the pool go to the queue of that worker, tasks
+     * submitted from any other thread are spread round-robin over the queues
+     */
+    class WorkStealingPool
+    {
+    public:
+        explicit WorkStealingPool(size_t nrWorkers);
+        /* waits until all submitted tasks are executed */
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        void submit(TTask task);
+
+        /* execute a single pending task on the calling thread, used by threads that
+         * wait for the outcome of a task so that they help instead of block, returns
+         * false when no task was pending
+         */
+        bool runPendingTask();
+
+        size_t size() const;
+
+        /* true when the calling thread is one of the workers of this pool */
+        bool isWorkerThread() const;
+
+        /* the pool of the calling worker thread, nullptr when not running on a worker */
+        static WorkStealingPool *current();
+
+        /* process-wide pool with one worker per hardware thread, created on first use */
+        static WorkStealingPool &shared();
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<TTask> tasks;
+        };
+
+        bool popTask(size_t index, TTask &task);
+        bool stealTask(size_t thief, TTask &task);
+        void workerLoop(size_t index);
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> workers;
+
+        std::atomic<size_t> pending{0};
+        std::atomic<size_t> sleeping{0};
+        std::atomic<size_t> nextQueue{0};
+
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        bool stopping = false;
+    };
+
+    /* call body(begin, end) for consecutive chunks covering [0, n) on the shared pool and wait until all
+     * chunks are done, the calling thread takes part in the work but only runs chunks of this call; a range
+     * of at most minChunk elements is done on the calling thread only.  The first exception thrown by body
+     * is rethrown once all chunks are done.  Intended for native kernels that do not evaluate code
+     */
+    void parallelFor(size_t n, size_t minChunk, const std::function<void(size_t, size_t)> &body);
+
+    /* call body(begin, end) for the consecutive chunks of chunkSize elements covering [0, n) like parallelFor,
+     * but with chunks of the given size instead of one per thread: there can be more chunks than threads, so
+     * that a thread that is done early takes over chunks of the others when the cost per element varies
+     */
+    void parallelForChunks(size_t n, size_t chunkSize, const std::function<void(size_t, size_t)> &body);
+
+    /* the number of threads, the calling thread included, parallelFor spreads a range over: the value of
+     * the LUCI_NUM_THREADS environment variable, or else the size of the shared pool.  Setting it to 0
+     * returns to that default, 1 runs all native kernels on the calling thread
+     */
+    size_t parallelThreads();
+    void setParallelThreads(size_t n);
+
+    /* the number of elements above which the kernels on arrays of numbers use more than one thread */
+    size_t parallelThreshold();
+    void setParallelThreshold(size_t n);
+
+    /* sorts [first, first + n) by cutting a long range in one run per thread: sortRun(begin, end) sorts the
+     * elements begin to end of a run, all runs at the same time, after which the runs are merged pairwise
+     * with less.  The merges keep the order of equal elements, so that stable runs give a stable sort
+     */
+    template <typename TIterator, typename TLess, typename TSortRun>
+    void parallelSortRuns(TIterator first, size_t n, const TLess &less, const TSortRun &sortRun)
+    {
+        const size_t nrRuns = std::min(parallelThreads(), n / std::max<size_t>(1, parallelThreshold()));
+        if (nrRuns <= 1)
+        {
+            sortRun(0, n);
+            return;
+        }
+
+        auto boundary = [n, nrRuns](size_t run)
+        { return run * (n / nrRuns) + std::min(run, n % nrRuns); };
+        parallelFor(nrRuns, 1, [&boundary, &sortRun](size_t begin, size_t end)
+                    {
+                        for (size_t run = begin; run < end; ++run)
+                            sortRun(boundary(run), boundary(run + 1)); });
+
+        for (size_t width = 1; width < nrRuns; width *= 2)
+        {
+            const size_t nrMerges = (nrRuns + 2 * width - 1) / (2 * width);
+            parallelFor(nrMerges, 1, [first, &boundary, &less, width, nrRuns](size_t begin, size_t end)
+                        {
+                            for (size_t merge = begin; merge < end; ++merge)
+                            {
+                                const size_t left = 2 * width * merge;
+                                const size_t middle = std::min(nrRuns, left + width);
+                                const size_t right = std::min(nrRuns, left + 2 * width);
+                                auto at = [first, &boundary](size_t run)
+                                { return first + static_cast<std::ptrdiff_t>(boundary(run)); };
+                                if (middle < right)
+                                    std::inplace_merge(at(left), at(middle), at(right), less);
+                            } });
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,411 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Simd.h"
+#include "Scheduler.h"
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define LUCI_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(LUCI_SIMD_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    struct ScalarTraits
+    {
+        typedef double vector;
+        static constexpr size_t width = 1;
+
+        static vector load(const double *p) { return *p; }
+        static void store(double *p, vector v) { *p = v; }
+        static vector broadcast(double v) { return v; }
+        static vector add(vector a, vector b) { return a + b; }
+        static vector sub(vector a, vector b) { return a - b; }
+        static vector mul(vector a, vector b) { return a * b; }
+        static vector div(vector a, vector b) { return a / b; }
+        static vector min(vector a, vector b) { return a < b ? a : b; }
+        static vector max(vector a, vector b) { return a > b ? a : b; }
+        static vector sqrt(vector v) { return std::sqrt(v); }
+        static vector abs(vector v) { return std::fabs(v); }
+        static vector isNan(vector v) { return v != v ? 1.0 : 0.0; }
+        static vector bitOr(vector a, vector b) { return a + b; }
+        static bool any(vector v) { return v != 0.0; }
+
+        typedef int64_t ivector;
+        static ivector loadInt(const int64_t *p) { return *p; }
+        static void storeInt(int64_t *p, ivector v) { *p = v; }
+        static ivector broadcastInt(int64_t v) { return v; }
+        static ivector addInt(ivector a, ivector b) { return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b)); }
+        static ivector subInt(ivector a, ivector b) { return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b)); }
+    };
+
+#ifdef LUCI_SIMD_SSE2
+    struct Sse2Traits
+    {
+        typedef __m128d vector;
+        static constexpr size_t width = 2;
+
+        static vector load(const double *p) { return _mm_loadu_pd(p); }
+        static void store(double *p, vector v) { _mm_storeu_pd(p, v); }
+        static vector broadcast(double v) { return _mm_set1_pd(v); }
+        static vector pair(double re, double im) { return _mm_set_pd(im, re); }
+        static vector add(vector a, vector b) { return _mm_add_pd(a, b); }
+        static vector sub(vector a, vector b) { return _mm_sub_pd(a, b); }
+        static vector mul(vector a, vector b) { return _mm_mul_pd(a, b); }
+        static vector div(vector a, vector b) { return _mm_div_pd(a, b); }
+        static vector min(vector a, vector b) { return _mm_min_pd(a, b); }
+        static vector max(vector a, vector b) { return _mm_max_pd(a, b); }
+        static vector sqrt(vector v) { return _mm_sqrt_pd(v); }
+        static vector abs(vector v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), v); }
+        static vector isNan(vector v) { return _mm_cmpunord_pd(v, v); }
+        static vector bitOr(vector a, vector b) { return _mm_or_pd(a, b); }
+        static bool any(vector v) { return _mm_movemask_pd(v) != 0; }
+
+        typedef __m128i ivector;
+        static ivector loadInt(const int64_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+        static void storeInt(int64_t *p, ivector v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+        static ivector broadcastInt(int64_t v) { return _mm_set1_epi64x(v); }
+        static ivector addInt(ivector a, ivector b) { return _mm_add_epi64(a, b); }
+        static ivector subInt(ivector a, ivector b) { return _mm_sub_epi64(a, b); }
+
+        /* (a + bi)(c + di) = (ac - bd) + (ad + bc)i */
+        static vector complexMultiply(vector x, vector y)
+        {
+            const vector yRe = _mm_unpacklo_pd(y, y);
+            const vector yIm = _mm_unpackhi_pd(y, y);
+            const vector xSwapped = _mm_shuffle_pd(x, x, 1);
+            const vector signRe = _mm_set_pd(0.0, -0.0);
+            return _mm_add_pd(_mm_mul_pd(x, yRe), _mm_xor_pd(_mm_mul_pd(xSwapped, yIm), signRe));
+        }
+    };
+#endif
+
+    bool cpuSupportsAvx2()
+    {
+#if defined(LUCI_SIMD_AVX2) && defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(LUCI_SIMD_AVX2)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    struct Selection
+    {
+        simd::Kernels kernels;
+        std::string instructionSet;
+        size_t width; /*< number of doubles in a vector, the pairwise sums split ranges at a multiple of it */
+    };
+
+    Selection select()
+    {
+        const char *requested = std::getenv("LUCI_SIMD");
+        const std::string limit = requested ? requested : "";
+
+#ifdef LUCI_SIMD_AVX2
+        if (limit != "sse2" && limit != "scalar" && cpuSupportsAvx2())
+            return Selection{simd::avx2Kernels(), "avx2", 4};
+#endif
+#ifdef LUCI_SIMD_SSE2
+        if (limit != "scalar")
+            return Selection{makeKernels<Sse2Traits>(), "sse2", Sse2Traits::width};
+#endif
+        return Selection{makeKernels<ScalarTraits>(), "scalar", ScalarTraits::width};
+    }
+
+    const Selection &selected()
+    {
+        static const Selection selection = select();
+        return selection;
+    }
+
+    const double *asDoubles(const std::complex<double> *values)
+    {
+        return reinterpret_cast<const double *>(values);
+    }
+
+    double *asDoubles(std::complex<double> *values)
+    {
+        return reinterpret_cast<double *>(values);
+    }
+
+    /* elementwise kernels on a long range run on the threads in chunks of a multiple of this number of
+     * elements, so that only the last chunk can end in a part that is not a whole number of vectors and
+     * every element is computed the same way as on a single thread
+     */
+    const size_t chunkAlignment = 64;
+
+    /* body(begin, count) for chunks covering [0, n) */
+    template <typename TBody>
+    void forChunks(size_t n, const TBody &body)
+    {
+        const size_t threshold = scheduler::parallelThreshold();
+        if (n <= threshold)
+        {
+            body(0, n);
+            return;
+        }
+
+        const size_t nrBlocks = (n + chunkAlignment - 1) / chunkAlignment;
+        scheduler::parallelFor(nrBlocks, threshold / chunkAlignment, [n, &body](size_t beginBlock, size_t endBlock)
+                               {
+                                   const size_t begin = beginBlock * chunkAlignment;
+                                   body(begin, std::min(n, endBlock * chunkAlignment) - begin); });
+    }
+
+    /* the ranges the pairwise summation of the kernels splits [begin, begin + n) into, down to ranges
+     * of at most leafSize elements
+     */
+    void pairwiseLeaves(size_t begin, size_t n, size_t leafSize, size_t width, std::vector<std::pair<size_t, size_t>> &leaves)
+    {
+        if (n > leafSize)
+        {
+            size_t half = n / 2;
+            half -= half % width;
+            pairwiseLeaves(begin, half, leafSize, width, leaves);
+            pairwiseLeaves(begin + half, n - half, leafSize, width, leaves);
+            return;
+        }
+        leaves.emplace_back(begin, n);
+    }
+
+    /* adds the sums of the leaves in the order of the pairwise summation */
+    double combineLeaves(size_t n, size_t leafSize, size_t width, const std::vector<double> &sums, size_t &next)
+    {
+        if (n > leafSize)
+        {
+            size_t half = n / 2;
+            half -= half % width;
+            const double lhs = combineLeaves(half, leafSize, width, sums, next);
+            return lhs + combineLeaves(n - half, leafSize, width, sums, next);
+        }
+        return sums[next++];
+    }
+
+    /* the pairwise sum of n terms, sumRange(begin, count) sums a range with a kernel.  A long range is
+     * split the same way the kernel splits it and the parts are summed on the threads, which gives the
+     * same result to the last bit for any number of threads
+     */
+    template <typename TSumRange>
+    double threadedPairwiseSum(size_t n, const TSumRange &sumRange)
+    {
+        if (n <= scheduler::parallelThreshold() || scheduler::parallelThreads() <= 1)
+            return sumRange(0, n);
+
+        const size_t width = selected().width;
+        const size_t leafSize = std::max(pairwiseBlockSize, n / (2 * scheduler::parallelThreads()));
+        std::vector<std::pair<size_t, size_t>> leaves;
+        pairwiseLeaves(0, n, leafSize, width, leaves);
+
+        std::vector<double> sums(leaves.size());
+        scheduler::parallelFor(leaves.size(), 1, [&leaves, &sums, &sumRange](size_t begin, size_t end)
+                               {
+                                   for (size_t i = begin; i < end; ++i)
+                                       sums[i] = sumRange(leaves[i].first, leaves[i].second); });
+
+        size_t next = 0;
+        return combineLeaves(n, leafSize, width, sums, next);
+    }
+
+    void applyComplex(simd::Operation operation, const std::complex<double> *lhs, const std::complex<double> *rhs, std::complex<double> *out, size_t n)
+    {
+        const auto &kernels = selected().kernels;
+        switch (operation)
+        {
+        case simd::Operation::Add:
+        case simd::Operation::Subtract:
+            return kernels.binary(operation, asDoubles(lhs), asDoubles(rhs), asDoubles(out), 2 * n);
+        case simd::Operation::Multiply:
+            return kernels.complexMultiply(asDoubles(lhs), asDoubles(rhs), asDoubles(out), n);
+        case simd::Operation::Divide:
+            for (size_t i = 0; i < n; ++i)
+                out[i] = lhs[i] / rhs[i];
+            return;
+        }
+    }
+
+    void applyComplex(simd::Operation operation, const std::complex<double> *lhs, std::complex<double> rhs, std::complex<double> *out, size_t n)
+    {
+        const auto &kernels = selected().kernels;
+        switch (operation)
+        {
+        case simd::Operation::Add:
+        case simd::Operation::Subtract:
+            return kernels.pairRight(operation, asDoubles(lhs), rhs.real(), rhs.imag(), asDoubles(out), n);
+        case simd::Operation::Multiply:
+            // scaling by a real number
+            if (rhs.imag() == 0.0)
+                return kernels.scalarRight(operation, asDoubles(lhs), rhs.real(), asDoubles(out), 2 * n);
+            return kernels.complexMultiplyScalar(asDoubles(lhs), rhs.real(), rhs.imag(), asDoubles(out), n);
+        case simd::Operation::Divide:
+            if (rhs.imag() == 0.0)
+                return kernels.scalarRight(operation, asDoubles(lhs), rhs.real(), asDoubles(out), 2 * n);
+            for (size_t i = 0; i < n; ++i)
+                out[i] = lhs[i] / rhs;
+            return;
+        }
+    }
+
+    void applyComplex(simd::Operation operation, std::complex<double> lhs, const std::complex<double> *rhs, std::complex<double> *out, size_t n)
+    {
+        const auto &kernels = selected().kernels;
+        switch (operation)
+        {
+        case simd::Operation::Add:
+        case simd::Operation::Subtract:
+            return kernels.pairLeft(operation, lhs.real(), lhs.imag(), asDoubles(rhs), asDoubles(out), n);
+        case simd::Operation::Multiply:
+            return applyComplex(operation, rhs, lhs, out, n);
+        case simd::Operation::Divide:
+            for (size_t i = 0; i < n; ++i)
+                out[i] = lhs / rhs[i];
+            return;
+        }
+    }
+}
+
+namespace simd
+{
+    void apply(Operation operation, const double *lhs, const double *rhs, double *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { selected().kernels.binary(operation, lhs + begin, rhs + begin, out + begin, count); });
+    }
+
+    void apply(Operation operation, const double *lhs, double rhs, double *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { selected().kernels.scalarRight(operation, lhs + begin, rhs, out + begin, count); });
+    }
+
+    void apply(Operation operation, double lhs, const double *rhs, double *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { selected().kernels.scalarLeft(operation, lhs, rhs + begin, out + begin, count); });
+    }
+
+    /* complex numbers are stored as re, im pairs of doubles, so that addition and subtraction
+     * are the same operations on twice the number of doubles; the division of complex numbers
+     * is left to std::complex, which takes care of overflow and of infinities
+     */
+    void apply(Operation operation, const std::complex<double> *lhs, const std::complex<double> *rhs, std::complex<double> *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { applyComplex(operation, lhs + begin, rhs + begin, out + begin, count); });
+    }
+
+    void apply(Operation operation, const std::complex<double> *lhs, std::complex<double> rhs, std::complex<double> *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { applyComplex(operation, lhs + begin, rhs, out + begin, count); });
+    }
+
+    void apply(Operation operation, std::complex<double> lhs, const std::complex<double> *rhs, std::complex<double> *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { applyComplex(operation, lhs, rhs + begin, out + begin, count); });
+    }
+
+    void apply(Operation operation, const int64_t *lhs, const int64_t *rhs, int64_t *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { selected().kernels.integerBinary(operation, lhs + begin, rhs + begin, out + begin, count); });
+    }
+
+    void apply(Operation operation, const int64_t *lhs, int64_t rhs, int64_t *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { selected().kernels.integerScalarRight(operation, lhs + begin, rhs, out + begin, count); });
+    }
+
+    void apply(Operation operation, int64_t lhs, const int64_t *rhs, int64_t *out, size_t n)
+    {
+        forChunks(n, [operation, lhs, rhs, out](size_t begin, size_t count)
+                  { selected().kernels.integerScalarLeft(operation, lhs, rhs + begin, out + begin, count); });
+    }
+
+    void sqrt(const double *values, double *out, size_t n)
+    {
+        forChunks(n, [values, out](size_t begin, size_t count)
+                  { selected().kernels.sqrt(values + begin, out + begin, count); });
+    }
+
+    void abs(const double *values, double *out, size_t n)
+    {
+        forChunks(n, [values, out](size_t begin, size_t count)
+                  { selected().kernels.abs(values + begin, out + begin, count); });
+    }
+
+    double sum(const double *values, size_t n)
+    {
+        return threadedPairwiseSum(n, [values](size_t begin, size_t count)
+                           { return selected().kernels.sum(values + begin, count); });
+    }
+
+    double dot(const double *lhs, const double *rhs, size_t n)
+    {
+        return threadedPairwiseSum(n, [lhs, rhs](size_t begin, size_t count)
+                           { return selected().kernels.dot(lhs + begin, rhs + begin, count); });
+    }
+
+    double sumSquaredDeviations(const double *values, size_t n, double mean)
+    {
+        return threadedPairwiseSum(n, [values, mean](size_t begin, size_t count)
+                           { return selected().kernels.sumSquaredDeviations(values + begin, count, mean); });
+    }
+
+    void minMax(const double *values, size_t n, double &minimum, double &maximum)
+    {
+        if (n <= scheduler::parallelThreshold() || scheduler::parallelThreads() <= 1)
+            return selected().kernels.minMax(values, n, minimum, maximum);
+
+        // the extremes of the chunks are combined in order, a NaN in any chunk makes both NaN
+        const size_t nrChunks = std::min(n, scheduler::parallelThreads());
+        std::vector<double> minima(nrChunks), maxima(nrChunks);
+        scheduler::parallelFor(nrChunks, 1, [values, n, nrChunks, &minima, &maxima](size_t begin, size_t end)
+                               {
+                                   for (size_t chunk = begin; chunk < end; ++chunk)
+                                   {
+                                       const size_t first = chunk * n / nrChunks;
+                                       const size_t last = (chunk + 1) * n / nrChunks;
+                                       selected().kernels.minMax(values + first, last - first, minima[chunk], maxima[chunk]);
+                                   } });
+
+        minimum = minima[0];
+        maximum = maxima[0];
+        for (size_t chunk = 1; chunk < nrChunks; ++chunk)
+        {
+            if (minimum != minimum || minima[chunk] != minima[chunk])
+            {
+                minimum = maximum = std::numeric_limits<double>::quiet_NaN();
+                break;
+            }
+            minimum = std::min(minimum, minima[chunk]);
+            maximum = std::max(maximum, maxima[chunk]);
+        }
+    }
+
+    const std::string &instructionSet()
+    {
+        return selected().instructionSet;
+    }
+}
@@ -0,0 +1,75 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_SIMD_H
+#define GUARDIAN_OF_INCLUSION_SIMD_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* elementwise arithmetic and reductions on contiguous arrays of ints, doubles and complex numbers,
+ * as used by the operators on array_int, array_double and array_complex and by the numeric module.  The kernels
+ * are selected once at runtime for the instruction set of the processor (avx2 or sse2 on x86-64,
+ * plain loops elsewhere), the selection can be restricted by setting the LUCI_SIMD environment
+ * variable to sse2 or scalar.
+ *
+ * Ranges longer than scheduler::parallelThreshold() are split over the threads of the shared pool.
+ * The reductions are split at the same places as the pairwise summation splits them, so that their
+ * result does not depend on the number of threads.
+ *
+ * out may be the same array as an input, for the in-place operators
+ */
+namespace simd
+{
+    enum class Operation
+    {
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+    };
+
+    /* out[i] = lhs[i] op rhs[i] */
+    void apply(Operation operation, const double *lhs, const double *rhs, double *out, size_t n);
+    /* out[i] = lhs[i] op rhs */
+    void apply(Operation operation, const double *lhs, double rhs, double *out, size_t n);
+    /* out[i] = lhs op rhs[i] */
+    void apply(Operation operation, double lhs, const double *rhs, double *out, size_t n);
+
+    void apply(Operation operation, const std::complex<double> *lhs, const std::complex<double> *rhs, std::complex<double> *out, size_t n);
+    void apply(Operation operation, const std::complex<double> *lhs, std::complex<double> rhs, std::complex<double> *out, size_t n);
+    void apply(Operation operation, std::complex<double> lhs, const std::complex<double> *rhs, std::complex<double> *out, size_t n);
+
+    /* integer arithmetic wraps around on overflow and divides towards zero, the caller makes sure
+     * that no divisor is 0
+     */
+    void apply(Operation operation, const int64_t *lhs, const int64_t *rhs, int64_t *out, size_t n);
+    void apply(Operation operation, const int64_t *lhs, int64_t rhs, int64_t *out, size_t n);
+    void apply(Operation operation, int64_t lhs, const int64_t *rhs, int64_t *out, size_t n);
+
+    /* out[i] = sqrt(values[i]), equal to std::sqrt for every element */
+    void sqrt(const double *values, double *out, size_t n);
+    /* out[i] = |values[i]| */
+    void abs(const double *values, double *out, size_t n);
+
+    /* sum of the values by pairwise summation, the rounding error grows with O(log n) */
+    double sum(const double *values, size_t n);
+    /* sum of lhs[i] * rhs[i], by pairwise summation */
+    double dot(const double *lhs, const double *rhs, size_t n);
+    /* sum of (values[i] - mean)^2, by pairwise summation */
+    double sumSquaredDeviations(const double *values, size_t n, double mean);
+    /* minimum and maximum of n > 0 values, both are NaN when one of the values is NaN */
+    void minMax(const double *values, size_t n, double &minimum, double &maximum);
+
+    /* name of the selected instruction set: avx2, sse2 or scalar */
+    const std::string &instructionSet();
+}
+
+#endif
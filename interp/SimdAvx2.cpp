@@ -0,0 +1,69 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+/* this file is compiled with AVX2 enabled, its kernels are only called after checking that the
+ * processor supports AVX2, nothing else of the interpreter is to be included here
+ */
+
+#include "SimdKernels.h"
+
+#ifdef LUCI_SIMD_AVX2
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2Traits
+    {
+        typedef __m256d vector;
+        static constexpr size_t width = 4;
+
+        static vector load(const double *p) { return _mm256_loadu_pd(p); }
+        static void store(double *p, vector v) { _mm256_storeu_pd(p, v); }
+        static vector broadcast(double v) { return _mm256_set1_pd(v); }
+        static vector pair(double re, double im) { return _mm256_set_pd(im, re, im, re); }
+        static vector add(vector a, vector b) { return _mm256_add_pd(a, b); }
+        static vector sub(vector a, vector b) { return _mm256_sub_pd(a, b); }
+        static vector mul(vector a, vector b) { return _mm256_mul_pd(a, b); }
+        static vector div(vector a, vector b) { return _mm256_div_pd(a, b); }
+        static vector min(vector a, vector b) { return _mm256_min_pd(a, b); }
+        static vector max(vector a, vector b) { return _mm256_max_pd(a, b); }
+        static vector sqrt(vector v) { return _mm256_sqrt_pd(v); }
+        static vector abs(vector v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+        static vector isNan(vector v) { return _mm256_cmp_pd(v, v, _CMP_UNORD_Q); }
+        static vector bitOr(vector a, vector b) { return _mm256_or_pd(a, b); }
+        static bool any(vector v) { return _mm256_movemask_pd(v) != 0; }
+
+        typedef __m256i ivector;
+        static ivector loadInt(const int64_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+        static void storeInt(int64_t *p, ivector v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+        static ivector broadcastInt(int64_t v) { return _mm256_set1_epi64x(v); }
+        static ivector addInt(ivector a, ivector b) { return _mm256_add_epi64(a, b); }
+        static ivector subInt(ivector a, ivector b) { return _mm256_sub_epi64(a, b); }
+
+        /* (a + bi)(c + di) = (ac - bd) + (ad + bc)i, for two complex numbers at once */
+        static vector complexMultiply(vector x, vector y)
+        {
+            const vector yRe = _mm256_movedup_pd(y);
+            const vector yIm = _mm256_permute_pd(y, 0xF);
+            const vector xSwapped = _mm256_permute_pd(x, 0x5);
+            return _mm256_addsub_pd(_mm256_mul_pd(x, yRe), _mm256_mul_pd(xSwapped, yIm));
+        }
+    };
+}
+
+namespace simd
+{
+    const Kernels &avx2Kernels()
+    {
+        static const Kernels kernels = makeKernels<Avx2Traits>();
+        return kernels;
+    }
+}
+
+#endif
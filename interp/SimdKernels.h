@@ -0,0 +1,555 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_SIMD_KERNELS_H
+#define GUARDIAN_OF_INCLUSION_SIMD_KERNELS_H
+
+/* kernels behind Simd.h, written once against a traits type describing a vector register:
+ *
+ *   vector, width          the register type and the number of doubles it holds
+ *   load, store            unaligned load and store of width doubles
+ *   broadcast(v)           all lanes set to v
+ *   pair(re, im)           lanes set to re, im, re, im, ...
+ *   add, sub, mul, div     lane-wise arithmetic
+ *   min, max               lane-wise a < b ? a : b and a > b ? a : b
+ *   sqrt, abs              lane-wise square root and absolute value
+ *   isNan, bitOr, any      lane-wise mask of NaN lanes, combination of masks, whether any lane is set
+ *   complexMultiply(x, y)  product of the complex numbers held as re, im pairs in x and y
+ *   ivector                the register type holding width 64-bit integers
+ *   loadInt, storeInt      unaligned load and store of width integers
+ *   broadcastInt(v)        all integer lanes set to v
+ *   addInt, subInt         lane-wise integer arithmetic, wrapping around on overflow
+ *
+ * this header is included by translation units compiled for different instruction sets, all of
+ * it has internal linkage so that the linker never mixes up code compiled for another instruction set
+ */
+
+#include "Simd.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace simd
+{
+    /* a complete set of kernels compiled for one instruction set, complex numbers are passed as
+     * nPairs consecutive re, im pairs of doubles
+     */
+    struct Kernels
+    {
+        void (*binary)(Operation, const double *, const double *, double *, size_t);
+        void (*scalarRight)(Operation, const double *, double, double *, size_t);
+        void (*scalarLeft)(Operation, double, const double *, double *, size_t);
+        void (*pairRight)(Operation, const double *, double, double, double *, size_t);
+        void (*pairLeft)(Operation, double, double, const double *, double *, size_t);
+        void (*complexMultiply)(const double *, const double *, double *, size_t);
+        void (*complexMultiplyScalar)(const double *, double, double, double *, size_t);
+        void (*sqrt)(const double *, double *, size_t);
+        void (*abs)(const double *, double *, size_t);
+
+        void (*integerBinary)(Operation, const int64_t *, const int64_t *, int64_t *, size_t);
+        void (*integerScalarRight)(Operation, const int64_t *, int64_t, int64_t *, size_t);
+        void (*integerScalarLeft)(Operation, int64_t, const int64_t *, int64_t *, size_t);
+
+        double (*sum)(const double *, size_t);
+        double (*dot)(const double *, const double *, size_t);
+        double (*sumSquaredDeviations)(const double *, size_t, double);
+        void (*minMax)(const double *, size_t, double &, double &);
+    };
+
+    /* the kernels compiled with AVX2 enabled, only available when LUCI_SIMD_AVX2 is defined */
+    const Kernels &avx2Kernels();
+}
+
+namespace
+{
+    struct AddOp
+    {
+        template <typename T>
+        static typename T::vector vector(typename T::vector a, typename T::vector b) { return T::add(a, b); }
+        static double scalar(double a, double b) { return a + b; }
+    };
+
+    struct SubtractOp
+    {
+        template <typename T>
+        static typename T::vector vector(typename T::vector a, typename T::vector b) { return T::sub(a, b); }
+        static double scalar(double a, double b) { return a - b; }
+    };
+
+    struct MultiplyOp
+    {
+        template <typename T>
+        static typename T::vector vector(typename T::vector a, typename T::vector b) { return T::mul(a, b); }
+        static double scalar(double a, double b) { return a * b; }
+    };
+
+    struct DivideOp
+    {
+        template <typename T>
+        static typename T::vector vector(typename T::vector a, typename T::vector b) { return T::div(a, b); }
+        static double scalar(double a, double b) { return a / b; }
+    };
+
+    /* the loops are instantiated per operation so that the operation is not switched on per element */
+    template <typename T, typename Op>
+    struct BinaryLoop
+    {
+        static void run(const double *lhs, const double *rhs, double *out, size_t n)
+        {
+            size_t i = 0;
+            for (; i + T::width <= n; i += T::width)
+                T::store(out + i, Op::template vector<T>(T::load(lhs + i), T::load(rhs + i)));
+            for (; i < n; ++i)
+                out[i] = Op::scalar(lhs[i], rhs[i]);
+        }
+    };
+
+    template <typename T, typename Op>
+    struct ScalarRightLoop
+    {
+        static void run(const double *lhs, double rhs, double *out, size_t n)
+        {
+            const auto rhsVector = T::broadcast(rhs);
+            size_t i = 0;
+            for (; i + T::width <= n; i += T::width)
+                T::store(out + i, Op::template vector<T>(T::load(lhs + i), rhsVector));
+            for (; i < n; ++i)
+                out[i] = Op::scalar(lhs[i], rhs);
+        }
+    };
+
+    template <typename T, typename Op>
+    struct ScalarLeftLoop
+    {
+        static void run(double lhs, const double *rhs, double *out, size_t n)
+        {
+            const auto lhsVector = T::broadcast(lhs);
+            size_t i = 0;
+            for (; i + T::width <= n; i += T::width)
+                T::store(out + i, Op::template vector<T>(lhsVector, T::load(rhs + i)));
+            for (; i < n; ++i)
+                out[i] = Op::scalar(lhs, rhs[i]);
+        }
+    };
+
+    template <typename T, typename Op>
+    struct PairRightLoop
+    {
+        static void run(const double *lhs, double re, double im, double *out, size_t nPairs)
+        {
+            const size_t n = 2 * nPairs;
+            size_t i = 0;
+            if constexpr (T::width >= 2)
+            {
+                const auto rhsVector = T::pair(re, im);
+                for (; i + T::width <= n; i += T::width)
+                    T::store(out + i, Op::template vector<T>(T::load(lhs + i), rhsVector));
+            }
+            for (; i < n; i += 2)
+            {
+                out[i] = Op::scalar(lhs[i], re);
+                out[i + 1] = Op::scalar(lhs[i + 1], im);
+            }
+        }
+    };
+
+    template <typename T, typename Op>
+    struct PairLeftLoop
+    {
+        static void run(double re, double im, const double *rhs, double *out, size_t nPairs)
+        {
+            const size_t n = 2 * nPairs;
+            size_t i = 0;
+            if constexpr (T::width >= 2)
+            {
+                const auto lhsVector = T::pair(re, im);
+                for (; i + T::width <= n; i += T::width)
+                    T::store(out + i, Op::template vector<T>(lhsVector, T::load(rhs + i)));
+            }
+            for (; i < n; i += 2)
+            {
+                out[i] = Op::scalar(re, rhs[i]);
+                out[i + 1] = Op::scalar(im, rhs[i + 1]);
+            }
+        }
+    };
+
+    template <typename T, template <typename, typename> class Loop, typename... Args>
+    void dispatchOperation(simd::Operation operation, Args... args)
+    {
+        switch (operation)
+        {
+        case simd::Operation::Add:
+            return Loop<T, AddOp>::run(args...);
+        case simd::Operation::Subtract:
+            return Loop<T, SubtractOp>::run(args...);
+        case simd::Operation::Multiply:
+            return Loop<T, MultiplyOp>::run(args...);
+        case simd::Operation::Divide:
+            return Loop<T, DivideOp>::run(args...);
+        }
+    }
+
+    template <typename T>
+    void binary(simd::Operation operation, const double *lhs, const double *rhs, double *out, size_t n)
+    {
+        dispatchOperation<T, BinaryLoop>(operation, lhs, rhs, out, n);
+    }
+
+    template <typename T>
+    void scalarRight(simd::Operation operation, const double *lhs, double rhs, double *out, size_t n)
+    {
+        dispatchOperation<T, ScalarRightLoop>(operation, lhs, rhs, out, n);
+    }
+
+    template <typename T>
+    void scalarLeft(simd::Operation operation, double lhs, const double *rhs, double *out, size_t n)
+    {
+        dispatchOperation<T, ScalarLeftLoop>(operation, lhs, rhs, out, n);
+    }
+
+    template <typename T>
+    void pairRight(simd::Operation operation, const double *lhs, double re, double im, double *out, size_t nPairs)
+    {
+        dispatchOperation<T, PairRightLoop>(operation, lhs, re, im, out, nPairs);
+    }
+
+    template <typename T>
+    void pairLeft(simd::Operation operation, double re, double im, const double *rhs, double *out, size_t nPairs)
+    {
+        dispatchOperation<T, PairLeftLoop>(operation, re, im, rhs, out, nPairs);
+    }
+
+    template <typename T>
+    void complexMultiply(const double *lhs, const double *rhs, double *out, size_t nPairs)
+    {
+        const size_t n = 2 * nPairs;
+        size_t i = 0;
+        if constexpr (T::width >= 2)
+        {
+            for (; i + T::width <= n; i += T::width)
+                T::store(out + i, T::complexMultiply(T::load(lhs + i), T::load(rhs + i)));
+        }
+        for (; i < n; i += 2)
+        {
+            const double a = lhs[i], b = lhs[i + 1], c = rhs[i], d = rhs[i + 1];
+            out[i] = a * c - b * d;
+            out[i + 1] = a * d + b * c;
+        }
+    }
+
+    template <typename T>
+    void complexMultiplyScalar(const double *lhs, double re, double im, double *out, size_t nPairs)
+    {
+        const size_t n = 2 * nPairs;
+        size_t i = 0;
+        if constexpr (T::width >= 2)
+        {
+            const auto rhsVector = T::pair(re, im);
+            for (; i + T::width <= n; i += T::width)
+                T::store(out + i, T::complexMultiply(T::load(lhs + i), rhsVector));
+        }
+        for (; i < n; i += 2)
+        {
+            const double a = lhs[i], b = lhs[i + 1];
+            out[i] = a * re - b * im;
+            out[i + 1] = a * im + b * re;
+        }
+    }
+
+    struct SqrtOp
+    {
+        template <typename T>
+        static typename T::vector vector(typename T::vector a) { return T::sqrt(a); }
+        static double scalar(double a) { return std::sqrt(a); }
+    };
+
+    struct AbsOp
+    {
+        template <typename T>
+        static typename T::vector vector(typename T::vector a) { return T::abs(a); }
+        static double scalar(double a) { return std::fabs(a); }
+    };
+
+    /* both the square root instructions and std::sqrt are correctly rounded, so that all lanes give
+     * the same result as the scalar function
+     */
+    template <typename T, typename Op>
+    void unary(const double *values, double *out, size_t n)
+    {
+        size_t i = 0;
+        for (; i + T::width <= n; i += T::width)
+            T::store(out + i, Op::template vector<T>(T::load(values + i)));
+        for (; i < n; ++i)
+            out[i] = Op::scalar(values[i]);
+    }
+
+    /* integer operations, computed on unsigned values so that overflow wraps around instead of
+     * being undefined; there are no 64-bit integer multiplication and division instructions below
+     * AVX-512, those operations have no vector form
+     */
+    struct IntegerAddOp
+    {
+        static constexpr bool hasVector = true;
+        template <typename T>
+        static typename T::ivector vector(typename T::ivector a, typename T::ivector b) { return T::addInt(a, b); }
+        static int64_t scalar(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b)); }
+    };
+
+    struct IntegerSubtractOp
+    {
+        static constexpr bool hasVector = true;
+        template <typename T>
+        static typename T::ivector vector(typename T::ivector a, typename T::ivector b) { return T::subInt(a, b); }
+        static int64_t scalar(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b)); }
+    };
+
+    struct IntegerMultiplyOp
+    {
+        static constexpr bool hasVector = false;
+        static int64_t scalar(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b)); }
+    };
+
+    /* the smallest int divided by -1 wraps around instead of trapping */
+    struct IntegerDivideOp
+    {
+        static constexpr bool hasVector = false;
+        static int64_t scalar(int64_t a, int64_t b) { return b == -1 ? static_cast<int64_t>(0 - static_cast<uint64_t>(a)) : a / b; }
+    };
+
+    template <typename T, typename Op>
+    struct IntegerBinaryLoop
+    {
+        static void run(const int64_t *lhs, const int64_t *rhs, int64_t *out, size_t n)
+        {
+            size_t i = 0;
+            if constexpr (Op::hasVector)
+            {
+                for (; i + T::width <= n; i += T::width)
+                    T::storeInt(out + i, Op::template vector<T>(T::loadInt(lhs + i), T::loadInt(rhs + i)));
+            }
+            for (; i < n; ++i)
+                out[i] = Op::scalar(lhs[i], rhs[i]);
+        }
+    };
+
+    template <typename T, typename Op>
+    struct IntegerScalarRightLoop
+    {
+        static void run(const int64_t *lhs, int64_t rhs, int64_t *out, size_t n)
+        {
+            size_t i = 0;
+            if constexpr (Op::hasVector)
+            {
+                const auto rhsVector = T::broadcastInt(rhs);
+                for (; i + T::width <= n; i += T::width)
+                    T::storeInt(out + i, Op::template vector<T>(T::loadInt(lhs + i), rhsVector));
+            }
+            for (; i < n; ++i)
+                out[i] = Op::scalar(lhs[i], rhs);
+        }
+    };
+
+    template <typename T, typename Op>
+    struct IntegerScalarLeftLoop
+    {
+        static void run(int64_t lhs, const int64_t *rhs, int64_t *out, size_t n)
+        {
+            size_t i = 0;
+            if constexpr (Op::hasVector)
+            {
+                const auto lhsVector = T::broadcastInt(lhs);
+                for (; i + T::width <= n; i += T::width)
+                    T::storeInt(out + i, Op::template vector<T>(lhsVector, T::loadInt(rhs + i)));
+            }
+            for (; i < n; ++i)
+                out[i] = Op::scalar(lhs, rhs[i]);
+        }
+    };
+
+    template <typename T, template <typename, typename> class Loop, typename... Args>
+    void dispatchIntegerOperation(simd::Operation operation, Args... args)
+    {
+        switch (operation)
+        {
+        case simd::Operation::Add:
+            return Loop<T, IntegerAddOp>::run(args...);
+        case simd::Operation::Subtract:
+            return Loop<T, IntegerSubtractOp>::run(args...);
+        case simd::Operation::Multiply:
+            return Loop<T, IntegerMultiplyOp>::run(args...);
+        case simd::Operation::Divide:
+            return Loop<T, IntegerDivideOp>::run(args...);
+        }
+    }
+
+    template <typename T>
+    void integerBinary(simd::Operation operation, const int64_t *lhs, const int64_t *rhs, int64_t *out, size_t n)
+    {
+        dispatchIntegerOperation<T, IntegerBinaryLoop>(operation, lhs, rhs, out, n);
+    }
+
+    template <typename T>
+    void integerScalarRight(simd::Operation operation, const int64_t *lhs, int64_t rhs, int64_t *out, size_t n)
+    {
+        dispatchIntegerOperation<T, IntegerScalarRightLoop>(operation, lhs, rhs, out, n);
+    }
+
+    template <typename T>
+    void integerScalarLeft(simd::Operation operation, int64_t lhs, const int64_t *rhs, int64_t *out, size_t n)
+    {
+        dispatchIntegerOperation<T, IntegerScalarLeftLoop>(operation, lhs, rhs, out, n);
+    }
+
+    /* the terms summed by the reductions, both as a vector starting at i and as the single element i */
+    template <typename T>
+    struct ValueTerm
+    {
+        const double *values;
+
+        typename T::vector vector(size_t i) const { return T::load(values + i); }
+        double scalar(size_t i) const { return values[i]; }
+    };
+
+    template <typename T>
+    struct ProductTerm
+    {
+        const double *lhs;
+        const double *rhs;
+
+        typename T::vector vector(size_t i) const { return T::mul(T::load(lhs + i), T::load(rhs + i)); }
+        double scalar(size_t i) const { return lhs[i] * rhs[i]; }
+    };
+
+    template <typename T>
+    struct SquaredDeviationTerm
+    {
+        const double *values;
+        double mean;
+        typename T::vector meanVector;
+
+        typename T::vector vector(size_t i) const
+        {
+            const auto deviation = T::sub(T::load(values + i), meanVector);
+            return T::mul(deviation, deviation);
+        }
+        double scalar(size_t i) const { return (values[i] - mean) * (values[i] - mean); }
+    };
+
+    /* number of elements below which a range is summed directly, above it the range is split in two
+     * halves that are summed separately, which bounds the rounding error by O(log n) instead of O(n)
+     */
+    const size_t pairwiseBlockSize = 128;
+
+    template <typename T, typename Term>
+    double pairwiseSum(const Term &term, size_t begin, size_t n)
+    {
+        if (n > pairwiseBlockSize)
+        {
+            // the split is kept at a multiple of the vector width, so that all blocks are summed the same way
+            size_t half = n / 2;
+            half -= half % T::width;
+            return pairwiseSum<T>(term, begin, half) + pairwiseSum<T>(term, begin + half, n - half);
+        }
+
+        // independent accumulators hide the latency of the additions
+        auto acc0 = T::broadcast(0.0), acc1 = T::broadcast(0.0), acc2 = T::broadcast(0.0), acc3 = T::broadcast(0.0);
+        const size_t end = begin + n;
+        size_t i = begin;
+        for (; i + 4 * T::width <= end; i += 4 * T::width)
+        {
+            acc0 = T::add(acc0, term.vector(i));
+            acc1 = T::add(acc1, term.vector(i + T::width));
+            acc2 = T::add(acc2, term.vector(i + 2 * T::width));
+            acc3 = T::add(acc3, term.vector(i + 3 * T::width));
+        }
+        for (; i + T::width <= end; i += T::width)
+            acc0 = T::add(acc0, term.vector(i));
+
+        double lanes[T::width];
+        T::store(lanes, T::add(T::add(acc0, acc1), T::add(acc2, acc3)));
+        double result = 0.0;
+        for (size_t lane = 0; lane < T::width; ++lane)
+            result += lanes[lane];
+        for (; i < end; ++i)
+            result += term.scalar(i);
+        return result;
+    }
+
+    template <typename T>
+    double sum(const double *values, size_t n)
+    {
+        return pairwiseSum<T>(ValueTerm<T>{values}, 0, n);
+    }
+
+    template <typename T>
+    double dot(const double *lhs, const double *rhs, size_t n)
+    {
+        return pairwiseSum<T>(ProductTerm<T>{lhs, rhs}, 0, n);
+    }
+
+    template <typename T>
+    double sumSquaredDeviations(const double *values, size_t n, double mean)
+    {
+        return pairwiseSum<T>(SquaredDeviationTerm<T>{values, mean, T::broadcast(mean)}, 0, n);
+    }
+
+    /* minimum and maximum of n > 0 values, both are NaN when one of the values is NaN */
+    template <typename T>
+    void minMax(const double *values, size_t n, double &minimum, double &maximum)
+    {
+        double lo = values[0], hi = values[0];
+        bool hasNan = false;
+        size_t i = 0;
+        if (n >= T::width)
+        {
+            auto loVector = T::load(values), hiVector = loVector, nanVector = T::isNan(loVector);
+            for (i = T::width; i + T::width <= n; i += T::width)
+            {
+                const auto v = T::load(values + i);
+                loVector = T::min(loVector, v);
+                hiVector = T::max(hiVector, v);
+                nanVector = T::bitOr(nanVector, T::isNan(v));
+            }
+            hasNan = T::any(nanVector);
+
+            double loLanes[T::width], hiLanes[T::width];
+            T::store(loLanes, loVector);
+            T::store(hiLanes, hiVector);
+            for (size_t lane = 0; lane < T::width; ++lane)
+            {
+                lo = loLanes[lane] < lo ? loLanes[lane] : lo;
+                hi = hiLanes[lane] > hi ? hiLanes[lane] : hi;
+            }
+        }
+        for (; i < n; ++i)
+        {
+            const double v = values[i];
+            hasNan = hasNan || v != v;
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+        }
+
+        if (hasNan)
+            lo = hi = std::numeric_limits<double>::quiet_NaN();
+        minimum = lo;
+        maximum = hi;
+    }
+
+    template <typename T>
+    simd::Kernels makeKernels()
+    {
+        return simd::Kernels{&binary<T>, &scalarRight<T>, &scalarLeft<T>, &pairRight<T>, &pairLeft<T>, &complexMultiply<T>, &complexMultiplyScalar<T>,
+                             &unary<T, SqrtOp>, &unary<T, AbsOp>,
+                             &integerBinary<T>, &integerScalarRight<T>, &integerScalarLeft<T>,
+                             &sum<T>, &dot<T>, &sumSquaredDeviations<T>, &minMax<T>};
+    }
+}
+
+#endif
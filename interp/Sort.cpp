@@ -0,0 +1,228 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Sort.h"
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    /* below this number of elements a range is sorted by comparing elements instead of by distributing them */
+    const size_t radixMinimum = 2048;
+    const size_t stringRadixMinimum = 32;
+
+    /* strings sharing a longer prefix than this are compared instead of distributed further */
+    const size_t stringRadixMaximumDepth = 64;
+
+    /* the keys are distributed on 11 bits at a time, so that 64 bit keys take at most 6 passes */
+    const size_t digitBits = 11;
+    const size_t digitValues = size_t(1) << digitBits;
+    const uint64_t digitMask = digitValues - 1;
+
+    const uint64_t signBit = 1ULL << 63;
+
+    /* keys of which the unsigned order is the order of the values */
+    uint64_t integerKey(int64_t value)
+    {
+        return static_cast<uint64_t>(value) ^ signBit;
+    }
+
+    uint64_t doubleKey(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & signBit) ? ~bits : bits | signBit;
+    }
+
+    struct KeyedIndex
+    {
+        uint64_t key;
+        size_t index;
+    };
+
+    /* stable radix sort on the digits of key(values[i]) - the smallest key, least significant first; a
+     * digit that is the same for all keys is skipped, so that keys of a small range take few passes
+     */
+    template <typename T, typename TKey>
+    void radixSort(T *values, size_t n, const TKey &key)
+    {
+        if (n < radixMinimum)
+        {
+            std::stable_sort(values, values + n, [&key](const T &a, const T &b)
+                             { return key(a) < key(b); });
+            return;
+        }
+
+        uint64_t minimum = key(values[0]);
+        uint64_t maximum = minimum;
+        for (size_t i = 1; i < n; ++i)
+        {
+            const uint64_t k = key(values[i]);
+            minimum = std::min(minimum, k);
+            maximum = std::max(maximum, k);
+        }
+        size_t nrDigits = 0;
+        for (uint64_t range = maximum - minimum; range != 0; range >>= digitBits)
+            ++nrDigits;
+
+        std::vector<std::array<size_t, digitValues>> counts(nrDigits);
+        for (auto &digitCounts : counts)
+            digitCounts.fill(0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const uint64_t k = key(values[i]) - minimum;
+            for (size_t digit = 0; digit < nrDigits; ++digit)
+                ++counts[digit][(k >> (digitBits * digit)) & digitMask];
+        }
+
+        std::vector<T> buffer(n);
+        T *from = values;
+        T *to = buffer.data();
+        const uint64_t firstKey = key(values[0]) - minimum;
+        for (size_t digit = 0; digit < nrDigits; ++digit)
+        {
+            auto &digitCounts = counts[digit];
+            const size_t shift = digitBits * digit;
+            if (digitCounts[(firstKey >> shift) & digitMask] == n)
+                continue;
+
+            size_t offset = 0;
+            for (auto &count : digitCounts)
+            {
+                const size_t c = count;
+                count = offset;
+                offset += c;
+            }
+            for (size_t i = 0; i < n; ++i)
+                to[digitCounts[((key(from[i]) - minimum) >> shift) & digitMask]++] = from[i];
+            std::swap(from, to);
+        }
+        if (from != values)
+            std::copy(from, from + n, values);
+    }
+
+    template <typename T, typename TKey>
+    void parallelRadixSort(std::vector<T> &values, const TKey &key)
+    {
+        scheduler::parallelSortRuns(
+            values.begin(), values.size(), [&key](const T &a, const T &b)
+            { return key(a) < key(b); },
+            [&values, &key](size_t begin, size_t end)
+            { radixSort(values.data() + begin, end - begin, key); });
+    }
+
+    std::vector<size_t> orderOfKeys(std::vector<KeyedIndex> &keyed)
+    {
+        parallelRadixSort(keyed, [](const KeyedIndex &item)
+                          { return item.key; });
+
+        std::vector<size_t> result(keyed.size());
+        for (size_t i = 0; i < keyed.size(); ++i)
+            result[i] = keyed[i].index;
+        return result;
+    }
+
+    struct KeyedString
+    {
+        const std::string *key;
+        size_t index;
+    };
+
+    /* 0 for a key of depth characters, otherwise 1 + the character at depth */
+    size_t stringDigit(const KeyedString &item, size_t depth)
+    {
+        return depth < item.key->size() ? 1 + static_cast<unsigned char>((*item.key)[depth]) : 0;
+    }
+
+    /* stable radix sort of keys that have their first depth characters in common */
+    void stringRadixSort(KeyedString *items, size_t n, size_t depth, KeyedString *buffer)
+    {
+        if (n < stringRadixMinimum || depth >= stringRadixMaximumDepth)
+        {
+            std::stable_sort(items, items + n, [depth](const KeyedString &a, const KeyedString &b)
+                             { return a.key->compare(depth, std::string::npos, *b.key, depth, std::string::npos) < 0; });
+            return;
+        }
+
+        size_t starts[258] = {};
+        for (size_t i = 0; i < n; ++i)
+            ++starts[stringDigit(items[i], depth) + 1];
+        for (size_t digit = 1; digit < 258; ++digit)
+            starts[digit] += starts[digit - 1];
+
+        size_t next[257];
+        std::copy(starts, starts + 257, next);
+        for (size_t i = 0; i < n; ++i)
+            buffer[next[stringDigit(items[i], depth)]++] = items[i];
+        std::copy(buffer, buffer + n, items);
+
+        // the keys that end at depth are equal and stay in their order
+        for (size_t digit = 1; digit < 257; ++digit)
+        {
+            const size_t count = starts[digit + 1] - starts[digit];
+            if (count > 1)
+                stringRadixSort(items + starts[digit], count, depth + 1, buffer + starts[digit]);
+        }
+    }
+}
+
+namespace sorting
+{
+    void sort(std::vector<int64_t> &values)
+    {
+        parallelRadixSort(values, integerKey);
+    }
+
+    void sort(std::vector<double> &values)
+    {
+        auto firstNan = std::stable_partition(values.begin(), values.end(), [](double value)
+                                              { return value == value; });
+        std::vector<double> numbers(values.begin(), firstNan);
+        parallelRadixSort(numbers, doubleKey);
+        std::copy(numbers.begin(), numbers.end(), values.begin());
+    }
+
+    std::vector<size_t> order(const std::vector<int64_t> &keys)
+    {
+        std::vector<KeyedIndex> keyed(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            keyed[i] = KeyedIndex{integerKey(keys[i]), i};
+        return orderOfKeys(keyed);
+    }
+
+    std::vector<size_t> order(const std::vector<double> &keys)
+    {
+        std::vector<KeyedIndex> keyed(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            keyed[i] = KeyedIndex{keys[i] == keys[i] ? doubleKey(keys[i]) : std::numeric_limits<uint64_t>::max(), i};
+        return orderOfKeys(keyed);
+    }
+
+    std::vector<size_t> order(const std::vector<const std::string *> &keys)
+    {
+        std::vector<KeyedString> keyed(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            keyed[i] = KeyedString{keys[i], i};
+
+        std::vector<KeyedString> buffer(keyed.size());
+        scheduler::parallelSortRuns(
+            keyed.begin(), keyed.size(), [](const KeyedString &a, const KeyedString &b)
+            { return *a.key < *b.key; },
+            [&keyed, &buffer](size_t begin, size_t end)
+            { stringRadixSort(keyed.data() + begin, end - begin, 0, buffer.data() + begin); });
+
+        std::vector<size_t> result(keyed.size());
+        for (size_t i = 0; i < keyed.size(); ++i)
+            result[i] = keyed[i].index;
+        return result;
+    }
+}
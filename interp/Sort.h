@@ -0,0 +1,36 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_SORT_H
+#define GUARDIAN_OF_INCLUSION_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* stable sorts of ints, doubles and strings as used by sort and sorted.  Ints and doubles are mapped
+ * to unsigned keys in the order of their values and sorted by a radix sort on 11 bit digits of the
+ * key minus the smallest key, least significant digit first; the digits above the range of the keys
+ * and a digit that is the same for all keys are skipped.  Strings are sorted by a radix sort on their
+ * characters (first character first).  A long array is cut in one run per thread, the runs are sorted
+ * at the same time and merged afterwards (scheduler::parallelSortRuns).
+ */
+namespace sorting
+{
+    void sort(std::vector<int64_t> &values);
+    /* NaN comes after all other values, -0.0 before 0.0 */
+    void sort(std::vector<double> &values);
+
+    /* the indices of the keys in the order of the keys, equal keys in the order of their index */
+    std::vector<size_t> order(const std::vector<int64_t> &keys);
+    std::vector<size_t> order(const std::vector<double> &keys);
+    std::vector<size_t> order(const std::vector<const std::string *> &keys);
+}
+
+#endif
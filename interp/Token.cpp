@@ -100,6 +100,7 @@ namespace TokenTypeStr
     const std::string CONTINUE = "CONTINUE";
 
     const std::string DOTDOT = "..";
+    const std::string YIELD = "YIELD";
 }
 
 bool Token::operator==(const Token &other) const
@@ -243,6 +244,8 @@ std::string toString(TokenType tokenType)
         return TokenTypeStr::CONTINUE;
     case TokenType::DOTDOT:
         return TokenTypeStr::DOTDOT;
+    case TokenType::YIELD:
+        return TokenTypeStr::YIELD;
     };
     return TokenTypeStr::NOT_SET;
 }
@@ -103,6 +103,7 @@ enum class TokenType
 
     CONTINUE = 62,
     DOTDOT = 63,
+    YIELD = 64,
 };
 
 std::string toString(TokenType tokenType);
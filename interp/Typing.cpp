@@ -11,6 +11,9 @@
 #include "Parser.h"
 #include "Evaluator.h" // to get access to the builtins
 
+#include <mutex>
+#include <unordered_map>
+
 namespace typing
 {
     ast::TypeExpression *AnalysisContext::findType(const std::string &name) const
@@ -625,8 +628,22 @@ namespace typing
         case obj::ObjectType::String:
         case obj::ObjectType::Error:
         case obj::ObjectType::Range:
+        case obj::ObjectType::Iterator:
         case obj::ObjectType::Regex:
         case obj::ObjectType::IOObject:
+        case obj::ObjectType::Module:
+        case obj::ObjectType::Thread:
+        case obj::ObjectType::ThreadPool:
+        case obj::ObjectType::Future:
+        case obj::ObjectType::Channel:
+        case obj::ObjectType::Mutex:
+        case obj::ObjectType::RwLock:
+        case obj::ObjectType::LockGuard:
+        case obj::ObjectType::Condition:
+        case obj::ObjectType::Barrier:
+        case obj::ObjectType::AtomicInt:
+        case obj::ObjectType::NativeObject:
+        case obj::ObjectType::NdArray:
         {
             std::map<obj::ObjectType, std::string> builtInRevTypeMapping = {
                 {obj::ObjectType::Null, "null"},
@@ -639,7 +656,19 @@ namespace typing
                 {obj::ObjectType::IOObject, "io"},
                 {obj::ObjectType::Module, "module"},
                 {obj::ObjectType::Thread, "thread"},
+                {obj::ObjectType::ThreadPool, "pool"},
+                {obj::ObjectType::Future, "future"},
+                {obj::ObjectType::Channel, "channel"},
+                {obj::ObjectType::Mutex, "mutex"},
+                {obj::ObjectType::RwLock, "rwlock"},
+                {obj::ObjectType::LockGuard, "lock_guard"},
+                {obj::ObjectType::Condition, "condition"},
+                {obj::ObjectType::Barrier, "barrier"},
+                {obj::ObjectType::AtomicInt, "atomic_int"},
+                {obj::ObjectType::NativeObject, "native"},
+                {obj::ObjectType::NdArray, "ndarray"},
                 {obj::ObjectType::Range, "range"},
+                {obj::ObjectType::Iterator, "iterator"},
                 {obj::ObjectType::Regex, "regex"},
             };
             auto typeIdentifier = std::make_unique<ast::TypeIdentifier>();
@@ -669,6 +698,14 @@ namespace typing
             }
             return std::move(typeArray);
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto typeArray = std::make_unique<ast::TypeArray>();
+            typeArray->elementType = std::make_unique<ast::TypeIdentifier>("int");
+            return std::move(typeArray);
+        }
+        case obj::ObjectType::ArrayView:
+            return computeType(static_cast<obj::ArrayView *>(obj)->array.get());
         case obj::ObjectType::ArrayDouble:
         {
             std::map<ast::TypeExpression *, std::unique_ptr<ast::TypeExpression>, CompareTypes> elementTypes;
@@ -937,8 +974,20 @@ namespace typing
                 {"io", obj::ObjectType::IOObject},
                 {"module", obj::ObjectType::Module},
                 {"thread", obj::ObjectType::Thread},
+                {"pool", obj::ObjectType::ThreadPool},
+                {"future", obj::ObjectType::Future},
+                {"channel", obj::ObjectType::Channel},
+                {"mutex", obj::ObjectType::Mutex},
+                {"rwlock", obj::ObjectType::RwLock},
+                {"lock_guard", obj::ObjectType::LockGuard},
+                {"condition", obj::ObjectType::Condition},
+                {"barrier", obj::ObjectType::Barrier},
+                {"atomic_int", obj::ObjectType::AtomicInt},
+                {"native", obj::ObjectType::NativeObject},
+                {"ndarray", obj::ObjectType::NdArray},
                 {"regex", obj::ObjectType::Regex},
                 {"range", obj::ObjectType::Range},
+                {"iterator", obj::ObjectType::Iterator},
             };
             auto expectedObjType = builtInTypeMapping.find(typeIdentifierValue);
             if (expectedObjType == builtInTypeMapping.end())
@@ -957,7 +1006,19 @@ namespace typing
         }
         case ast::NodeType::TypeArray:
         {
-            if (obj->type != obj::ObjectType::Array && obj->type != obj::ObjectType::ArrayDouble && obj->type != obj::ObjectType::ArrayComplex)
+            if (obj->type == obj::ObjectType::ArrayView)
+            {
+                auto view = static_cast<obj::ArrayView *>(obj);
+                if (view->array->type != obj::ObjectType::Array)
+                    return isCompatibleType(type, view->array.get(), nullptr);
+                for (size_t i = 0; i < view->length; ++i)
+                {
+                    if (!isCompatibleType(static_cast<ast::TypeArray *>(type)->elementType.get(), view->element(i).get(), nullptr))
+                        return false;
+                }
+                return true;
+            }
+            if (obj->type != obj::ObjectType::Array && obj->type != obj::ObjectType::ArrayInt && obj->type != obj::ObjectType::ArrayDouble && obj->type != obj::ObjectType::ArrayComplex)
                 return false;
 
             auto typeArray = static_cast<ast::TypeArray *>(type);
@@ -973,6 +1034,12 @@ namespace typing
                 }
                 break;
             }
+            case obj::ObjectType::ArrayInt:
+            {
+                if (typeArray->elementType->type != ast::NodeType::TypeIdentifier)
+                    return false;
+                return (static_cast<ast::TypeIdentifier *>(typeArray->elementType.get())->value == "int");
+            }
             case obj::ObjectType::ArrayDouble:
             {
                 if (typeArray->elementType->type != ast::NodeType::TypeIdentifier)
@@ -1045,6 +1112,16 @@ namespace typing
 
     ast::TypeFunction *makeFunctionType(const std::string &argTypeStr, const std::string &returnTypeStr)
     {
+        // many builtins share the same signature, parse each distinct signature only once
+        static std::mutex parsedTypesMutex;
+        static std::unordered_map<std::string, ast::TypeFunction *> parsedTypes;
+
+        const std::string key = argTypeStr + "\n" + returnTypeStr;
+        std::lock_guard<std::mutex> lock(parsedTypesMutex);
+        auto parsedTypeIt = parsedTypes.find(key);
+        if (parsedTypeIt != parsedTypes.end())
+            return parsedTypeIt->second;
+
         ast::TypeFunction *functionType = new ast::TypeFunction();
         {
             auto lexer = createLexer(returnTypeStr, "");
@@ -1064,6 +1141,7 @@ namespace typing
             }
         }
 
+        parsedTypes.insert_or_assign(key, functionType);
         return functionType;
     }
 }
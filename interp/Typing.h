@@ -67,6 +67,7 @@ namespace typing
 
     /* create a function type object based on an arg str and return str
      *   makeFunctionType("int, int","null") gives a function type of "fn(int, int) -> null"
+     * the returned type is shared between all callers with the same strings and must not be modified
      */
     ast::TypeFunction *makeFunctionType(const std::string &argTypeStr, const std::string &returnTypeStr);
 }
@@ -20,7 +20,7 @@ namespace
         const std::vector<std::shared_ptr<obj::Object>> &arguments,
         size_t nrExpectedArguments)
     {
-        if (self.get()->type != obj::ObjectType::Array && self.get()->type != obj::ObjectType::ArrayDouble && self.get()->type != obj::ObjectType::ArrayComplex)
+        if (self.get()->type != obj::ObjectType::Array && self.get()->type != obj::ObjectType::ArrayInt && self.get()->type != obj::ObjectType::ArrayDouble && self.get()->type != obj::ObjectType::ArrayComplex)
             return std::make_shared<obj::Error>(errorPrefix + ": expected " + toString(obj::ObjectType::Array) + ", got " + toString(self.get()->type), obj::ErrorType::TypeError);
         if (arguments.size() != nrExpectedArguments)
             return std::make_shared<obj::Error>(errorPrefix + ": expected " + std::to_string(nrExpectedArguments) + " arguments, got " + std::to_string(arguments.size()), obj::ErrorType::TypeError);
@@ -30,6 +30,37 @@ namespace
 
 namespace obj
 {
+    std::shared_ptr<Object> ArrayInt::valueConstruct(const int64_t &value)
+    {
+        return std::make_shared<Integer>(value);
+    }
+
+    std::string ArrayInt::inspect() const
+    {
+        std::stringstream ss;
+        std::vector<std::string> elements;
+        for (const auto &element : value)
+            elements.push_back(std::to_string(element));
+
+        ss << "[";
+        ss << util::join(elements, ", ");
+        ss << "]";
+        return ss.str();
+    }
+
+    std::shared_ptr<Object> ArrayInt::clone() const
+    {
+        return std::make_shared<obj::ArrayInt>(value);
+    };
+
+    bool ArrayInt::eq(const Object *other) const
+    {
+        return static_cast<const obj::ArrayInt *>(other)->value == value;
+    };
+
+    ArrayInt::ArrayInt(const std::vector<int64_t> &ivalue) : Object(ObjectType::ArrayInt), value(ivalue){};
+    ArrayInt::ArrayInt(std::vector<int64_t> &&ivalue) : Object(ObjectType::ArrayInt), value(std::move(ivalue)){};
+
     std::shared_ptr<Object> ArrayDouble::valueConstruct(const double &value)
     {
         return std::make_shared<Double>(value);
@@ -59,6 +90,7 @@ namespace obj
     };
 
     ArrayDouble::ArrayDouble(const std::vector<double> &ivalue) : Object(ObjectType::ArrayDouble), value(ivalue){};
+    ArrayDouble::ArrayDouble(std::vector<double> &&ivalue) : Object(ObjectType::ArrayDouble), value(std::move(ivalue)){};
 
     std::shared_ptr<Object> ArrayComplex::valueConstruct(const std::complex<double> &value)
     {
@@ -89,6 +121,84 @@ namespace obj
     };
 
     ArrayComplex::ArrayComplex(const std::vector<std::complex<double>> &ivalue) : Object(ObjectType::ArrayComplex), value(ivalue){};
+    ArrayComplex::ArrayComplex(std::vector<std::complex<double>> &&ivalue) : Object(ObjectType::ArrayComplex), value(std::move(ivalue)){};
+
+    namespace
+    {
+        template <typename TArrayType>
+        auto viewValues(const ArrayView &view)
+        {
+            const auto &values = static_cast<const TArrayType *>(view.array.get())->value;
+            std::decay_t<decltype(values)> ret;
+            ret.reserve(view.length);
+            for (size_t i = 0; i < view.length; ++i)
+                ret.push_back(values[view.offset + i * view.stride]);
+            return ret;
+        }
+    }
+
+    std::shared_ptr<Object> ArrayView::element(size_t index) const
+    {
+        const size_t position = offset + index * stride;
+        switch (array->type)
+        {
+        case ObjectType::Array:
+            return static_cast<const Array *>(array.get())->value[position];
+        case ObjectType::ArrayInt:
+            return std::make_shared<Integer>(static_cast<const ArrayInt *>(array.get())->value[position]);
+        case ObjectType::ArrayDouble:
+            return std::make_shared<Double>(static_cast<const ArrayDouble *>(array.get())->value[position]);
+        case ObjectType::ArrayComplex:
+            return std::make_shared<Complex>(static_cast<const ArrayComplex *>(array.get())->value[position]);
+        }
+        return std::make_shared<Error>("ArrayView of " + toString(array->type), ErrorType::TypeError);
+    }
+
+    std::string ArrayView::inspect() const
+    {
+        return clone()->inspect();
+    }
+
+    std::shared_ptr<Object> ArrayView::clone() const
+    {
+        switch (array->type)
+        {
+        case ObjectType::Array:
+        {
+            std::vector<std::shared_ptr<Object>> values;
+            values.reserve(length);
+            for (const auto &v : viewValues<Array>(*this))
+                values.push_back(v->clone());
+            return std::make_shared<Array>(values);
+        }
+        case ObjectType::ArrayInt:
+            return std::make_shared<ArrayInt>(viewValues<ArrayInt>(*this));
+        case ObjectType::ArrayDouble:
+            return std::make_shared<ArrayDouble>(viewValues<ArrayDouble>(*this));
+        case ObjectType::ArrayComplex:
+            return std::make_shared<ArrayComplex>(viewValues<ArrayComplex>(*this));
+        }
+        return std::make_shared<Error>("ArrayView of " + toString(array->type), ErrorType::TypeError);
+    }
+
+    bool ArrayView::eq(const Object *other) const
+    {
+        if (other->type != ObjectType::ArrayView)
+            return false;
+        auto otherView = static_cast<const ArrayView *>(other);
+        if (otherView->length != length)
+            return false;
+        for (size_t i = 0; i < length; ++i)
+        {
+            auto left = element(i);
+            auto right = otherView->element(i);
+            if (left->type != right->type || !left->eq(right.get()))
+                return false;
+        }
+        return true;
+    }
+
+    ArrayView::ArrayView(std::shared_ptr<Object> iarray, size_t ioffset, size_t ilength, size_t istride) : Object(ObjectType::ArrayView), array(iarray), freezer(iarray), offset(ioffset), length(ilength), stride(istride){};
 
     std::shared_ptr<obj::Object> Array::valueConstruct(std::shared_ptr<Object> obj)
     {
@@ -197,6 +307,8 @@ namespace builtin
         {
         case obj::ObjectType::Array:
             return std::make_shared<obj::Integer>(static_cast<obj::Array *>(self.get())->value.size());
+        case obj::ObjectType::ArrayInt:
+            return std::make_shared<obj::Integer>(static_cast<obj::ArrayInt *>(self.get())->value.size());
         case obj::ObjectType::ArrayDouble:
             return std::make_shared<obj::Integer>(static_cast<obj::ArrayDouble *>(self.get())->value.size());
         case obj::ObjectType::ArrayComplex:
@@ -216,6 +328,8 @@ namespace builtin
         {
         case obj::ObjectType::Array:
             return std::make_shared<obj::Integer>(static_cast<obj::Array *>(self.get())->value.capacity());
+        case obj::ObjectType::ArrayInt:
+            return std::make_shared<obj::Integer>(static_cast<obj::ArrayInt *>(self.get())->value.capacity());
         case obj::ObjectType::ArrayDouble:
             return std::make_shared<obj::Integer>(static_cast<obj::ArrayDouble *>(self.get())->value.capacity());
         case obj::ObjectType::ArrayComplex:
@@ -238,6 +352,9 @@ namespace builtin
         case obj::ObjectType::Array:
             static_cast<obj::Array *>(self.get())->value.clear();
             return self;
+        case obj::ObjectType::ArrayInt:
+            static_cast<obj::ArrayInt *>(self.get())->value.clear();
+            return self;
         case obj::ObjectType::ArrayDouble:
             static_cast<obj::ArrayDouble *>(self.get())->value.clear();
             return self;
@@ -258,6 +375,8 @@ namespace builtin
         {
         case obj::ObjectType::Array:
             return std::make_shared<obj::Boolean>(static_cast<obj::Array *>(self.get())->value.empty());
+        case obj::ObjectType::ArrayInt:
+            return std::make_shared<obj::Boolean>(static_cast<obj::ArrayInt *>(self.get())->value.empty());
         case obj::ObjectType::ArrayDouble:
             return std::make_shared<obj::Boolean>(static_cast<obj::ArrayDouble *>(self.get())->value.empty());
         case obj::ObjectType::ArrayComplex:
@@ -280,6 +399,9 @@ namespace builtin
         case obj::ObjectType::Array:
             static_cast<obj::Array *>(self.get())->value.pop_back();
             break;
+        case obj::ObjectType::ArrayInt:
+            static_cast<obj::ArrayInt *>(self.get())->value.pop_back();
+            break;
         case obj::ObjectType::ArrayDouble:
             static_cast<obj::ArrayDouble *>(self.get())->value.pop_back();
             break;
@@ -307,6 +429,15 @@ namespace builtin
             arrayObj->value.push_back(arguments[0]);
             return self;
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            if (arguments[0]->type == obj::ObjectType::Integer)
+            {
+                static_cast<obj::ArrayInt *>(self.get())->value.push_back(static_cast<obj::Integer *>(arguments[0].get())->value);
+                return self;
+            }
+            return std::make_shared<obj::Error>("Cannot push a non-int to a [int]", obj::ErrorType::TypeError);
+        }
         case obj::ObjectType::ArrayDouble:
         {
             if (arguments[0]->type == obj::ObjectType::Double)
@@ -345,6 +476,9 @@ namespace builtin
         case obj::ObjectType::Array:
             static_cast<obj::Array *>(self.get())->value.reserve(static_cast<size_t>(capacity->value));
             break;
+        case obj::ObjectType::ArrayInt:
+            static_cast<obj::ArrayInt *>(self.get())->value.reserve(static_cast<size_t>(capacity->value));
+            break;
         case obj::ObjectType::ArrayDouble:
             static_cast<obj::ArrayDouble *>(self.get())->value.reserve(static_cast<size_t>(capacity->value));
             break;
@@ -372,6 +506,12 @@ namespace builtin
             std::reverse(arrayObj->value.begin(), arrayObj->value.end());
             break;
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto arrayObj = static_cast<obj::ArrayInt *>(self.get());
+            std::reverse(arrayObj->value.begin(), arrayObj->value.end());
+            break;
+        }
         case obj::ObjectType::ArrayDouble:
         {
             auto arrayObj = static_cast<obj::ArrayDouble *>(self.get());
@@ -403,6 +543,13 @@ namespace builtin
             std::reverse(values.begin(), values.end());
             return std::make_shared<obj::Array>(obj::Array(values));
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto arrayObj = static_cast<obj::ArrayInt *>(self.get());
+            std::vector<int64_t> values(arrayObj->value);
+            std::reverse(values.begin(), values.end());
+            return std::make_shared<obj::ArrayInt>(std::move(values));
+        }
         case obj::ObjectType::ArrayDouble:
         {
             auto arrayObj = static_cast<obj::ArrayDouble *>(self.get());
@@ -440,16 +587,25 @@ namespace builtin
         {
             auto arrayObj = static_cast<obj::Array *>(self.get());
             std::rotate(arrayObj->value.begin(), arrayObj->value.begin() + rotationValue, arrayObj->value.end());
+            break;
+        }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto arrayObj = static_cast<obj::ArrayInt *>(self.get());
+            std::rotate(arrayObj->value.begin(), arrayObj->value.begin() + rotationValue, arrayObj->value.end());
+            break;
         }
         case obj::ObjectType::ArrayDouble:
         {
             auto arrayObj = static_cast<obj::ArrayDouble *>(self.get());
             std::rotate(arrayObj->value.begin(), arrayObj->value.begin() + rotationValue, arrayObj->value.end());
+            break;
         }
         case obj::ObjectType::ArrayComplex:
         {
             auto arrayObj = static_cast<obj::ArrayComplex *>(self.get());
             std::rotate(arrayObj->value.begin(), arrayObj->value.begin() + rotationValue, arrayObj->value.end());
+            break;
         }
         }
         return self;
@@ -475,6 +631,13 @@ namespace builtin
             std::rotate(values.begin(), values.begin() + rotationValue, values.end());
             return std::make_shared<obj::Array>(obj::Array(values));
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto arrayObj = static_cast<obj::ArrayInt *>(self.get());
+            std::vector<int64_t> values(arrayObj->value);
+            std::rotate(values.begin(), values.begin() + rotationValue, values.end());
+            return std::make_shared<obj::ArrayInt>(std::move(values));
+        }
         case obj::ObjectType::ArrayDouble:
         {
             auto arrayObj = static_cast<obj::ArrayDouble *>(self.get());
@@ -493,36 +656,37 @@ namespace builtin
         return std::make_shared<obj::Error>("Method unavailable for type", obj::ErrorType::TypeError);
     }
 
-    std::vector<std::shared_ptr<obj::BuiltinType>> makeBuiltinTypeArrays()
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeArray(obj::ObjectType arrayType)
     {
-        std::vector<std::shared_ptr<obj::BuiltinType>> arrayTypes;
-
         typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
 
-        for (const auto &arrayType : {obj::ObjectType::Array, obj::ObjectType::ArrayDouble, obj::ObjectType::ArrayComplex})
-        {
-            auto arrayBuiltinType = std::make_shared<obj::BuiltinType>();
-            arrayBuiltinType->builtinObjectType = arrayType;
+        auto arrayBuiltinType = std::make_shared<obj::BuiltinType>();
+        arrayBuiltinType->builtinObjectType = arrayType;
 
-            arrayBuiltinType->functions = {
-                {"capacity", TBuiltInFD({&builtin::array_capacity, typing::makeFunctionType("", "int")})}, // "[all].fn() -> int"
-                {"clear", TBuiltInFD({&builtin::array_clear, typing::makeFunctionType("", "[all]")})},     // "[all].fn() -> [all]"
-                {"empty", TBuiltInFD({&builtin::array_empty, typing::makeFunctionType("", "[all]")})},     // "[all].fn() -> [all]"
+        arrayBuiltinType->functions = {
+            {"capacity", TBuiltInFD({&builtin::array_capacity, typing::makeFunctionType("", "int")})}, // "[all].fn() -> int"
+            {"clear", TBuiltInFD({&builtin::array_clear, typing::makeFunctionType("", "[all]")})},     // "[all].fn() -> [all]"
+            {"empty", TBuiltInFD({&builtin::array_empty, typing::makeFunctionType("", "[all]")})},     // "[all].fn() -> [all]"
 
-                {"push_back", TBuiltInFD({&builtin::array_push_back, typing::makeFunctionType("all", "[all]")})}, // "[all].fn(all) -> [all]"
-                {"pop_back", TBuiltInFD({&builtin::array_pop_back, typing::makeFunctionType("", "[all]")})},      // "[all].fn() -> [all]"
-                {"reserve", TBuiltInFD({&builtin::array_reserve, typing::makeFunctionType("int", "[all]")})},     // "[all].fn(int) -> [all]"
-                {"reverse", TBuiltInFD({&builtin::array_reverse, typing::makeFunctionType("", "[all]")})},        // "[all].fn() -> [all]"
-                {"reversed", TBuiltInFD({&builtin::array_reversed, typing::makeFunctionType("", "[all]")})},      // "[all].fn() -> [all]"
+            {"push_back", TBuiltInFD({&builtin::array_push_back, typing::makeFunctionType("all", "[all]")})}, // "[all].fn(all) -> [all]"
+            {"pop_back", TBuiltInFD({&builtin::array_pop_back, typing::makeFunctionType("", "[all]")})},      // "[all].fn() -> [all]"
+            {"reserve", TBuiltInFD({&builtin::array_reserve, typing::makeFunctionType("int", "[all]")})},     // "[all].fn(int) -> [all]"
+            {"reverse", TBuiltInFD({&builtin::array_reverse, typing::makeFunctionType("", "[all]")})},        // "[all].fn() -> [all]"
+            {"reversed", TBuiltInFD({&builtin::array_reversed, typing::makeFunctionType("", "[all]")})},      // "[all].fn() -> [all]"
 
-                {"size", TBuiltInFD({&builtin::array_size, typing::makeFunctionType("", "int")})},           // "[all].fn() -> int"
-                {"rotate", TBuiltInFD({&builtin::array_rotate, typing::makeFunctionType("int", "[all]")})},  // "[all].fn(int) -> [all]"
-                {"rotated", TBuiltInFD({&builtin::array_rotated, typing::makeFunctionType("int", "[all]")})} // "[all].fn(int) -> [all]"
-            };
+            {"size", TBuiltInFD({&builtin::array_size, typing::makeFunctionType("", "int")})},           // "[all].fn() -> int"
+            {"rotate", TBuiltInFD({&builtin::array_rotate, typing::makeFunctionType("int", "[all]")})},  // "[all].fn(int) -> [all]"
+            {"rotated", TBuiltInFD({&builtin::array_rotated, typing::makeFunctionType("int", "[all]")})} // "[all].fn(int) -> [all]"
+        };
 
-            arrayTypes.push_back(std::move(arrayBuiltinType));
-        }
+        return arrayBuiltinType;
+    }
 
+    std::vector<std::shared_ptr<obj::BuiltinType>> makeBuiltinTypeArrays()
+    {
+        std::vector<std::shared_ptr<obj::BuiltinType>> arrayTypes;
+        for (const auto &arrayType : {obj::ObjectType::Array, obj::ObjectType::ArrayInt, obj::ObjectType::ArrayDouble, obj::ObjectType::ArrayComplex})
+            arrayTypes.push_back(makeBuiltinTypeArray(arrayType));
         return arrayTypes;
     }
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ namespace builtin
     std::shared_ptr<obj::Object> array_rotate(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments);
     std::shared_ptr<obj::Object> array_rotated(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments);
 
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeArray(obj::ObjectType arrayType);
     std::vector<std::shared_ptr<obj::BuiltinType>> makeBuiltinTypeArrays();
 }
 
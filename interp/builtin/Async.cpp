@@ -0,0 +1,331 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Async.h"
+#include "../Evaluator.h"
+#include "../EventLoop.h"
+#include "../Scheduler.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+namespace
+{
+    std::shared_ptr<obj::Object> makeRunResult(int exitCode, const std::string &output)
+    {
+        return std::make_shared<obj::Array>(std::vector<std::shared_ptr<obj::Object>>{std::make_shared<obj::Integer>(exitCode), std::make_shared<obj::String>(output)});
+    }
+
+#ifdef __linux__
+    typedef std::function<void(int)> TExitCallback;
+
+    /* polls for the exit of pid from a timer of the loop, for kernels without pidfd_open */
+    void pollExit(event::EventLoop *loop, pid_t pid, TExitCallback onExit)
+    {
+        int status = 0;
+        pid_t result = waitpid(pid, &status, WNOHANG);
+        if (result == 0 || (result < 0 && errno == EINTR))
+        {
+            loop->callLater(0.01, [loop, pid, onExit]()
+                            { pollExit(loop, pid, onExit); });
+            return;
+        }
+        onExit(result == pid ? status : -1);
+    }
+
+    /* calls onExit with the status of pid once it has exited, without blocking the loop: a child can
+     * keep running long after closing its output and the loop serves all other operations meanwhile
+     */
+    void awaitExit(event::EventLoop *loop, pid_t pid, TExitCallback onExit)
+    {
+        int status = 0;
+        if (waitpid(pid, &status, WNOHANG) == pid)
+        {
+            onExit(status);
+            return;
+        }
+
+#ifdef SYS_pidfd_open
+        // a pidfd becomes readable when the process exits
+        const int pidFd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+        if (pidFd >= 0)
+        {
+            if (loop->watchReadable(pidFd, [loop, pidFd, pid, onExit]()
+                                    {
+                                        loop->unwatch(pidFd);
+                                        close(pidFd);
+                                        pollExit(loop, pid, onExit); }))
+                return;
+            close(pidFd);
+        }
+#endif
+        pollExit(loop, pid, onExit);
+    }
+
+    /* start command through the shell with its standard output connected to a pipe that is
+     * watched by the event loop, the future is set once the output is closed
+     */
+    std::shared_ptr<obj::Object> startProcess(const std::string &command, const std::shared_ptr<obj::Future> &future)
+    {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0)
+            return std::make_shared<obj::Error>("run: failed to create a pipe", obj::ErrorType::OSError);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+
+        pid_t pid = 0;
+        std::string shell = "/bin/sh";
+        std::string shellOption = "-c";
+        std::string commandCopy = command;
+        char *argv[] = {shell.data(), shellOption.data(), commandCopy.data(), nullptr};
+        int spawnResult = posix_spawn(&pid, shell.c_str(), &actions, nullptr, argv, environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(fds[1]);
+        if (spawnResult != 0)
+        {
+            close(fds[0]);
+            return std::make_shared<obj::Error>("run: failed to start " + command, obj::ErrorType::OSError);
+        }
+
+        const int readFd = fds[0];
+        fcntl(readFd, F_SETFL, fcntl(readFd, F_GETFL) | O_NONBLOCK);
+
+        // the loop owns the callback, so it is referred to by plain pointer from within
+        auto loop = event::EventLoop::current().get();
+        auto output = std::make_shared<std::string>();
+        loop->watchReadable(readFd, [loop, readFd, pid, output, future]()
+                            {
+                                char buffer[4096];
+                                while (true)
+                                {
+                                    auto nrRead = read(readFd, buffer, sizeof(buffer));
+                                    if (nrRead > 0)
+                                    {
+                                        output->append(buffer, static_cast<size_t>(nrRead));
+                                        continue;
+                                    }
+                                    if (nrRead < 0 && errno == EINTR)
+                                        continue;
+                                    if (nrRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                                        return;
+                                    break;
+                                }
+
+                                loop->unwatch(readFd);
+                                close(readFd);
+                                awaitExit(loop, pid, [output, future](int status)
+                                          { future->set(makeRunResult(status >= 0 && WIFEXITED(status) ? WEXITSTATUS(status) : -1, *output)); }); });
+        return nullptr;
+    }
+#else
+    std::shared_ptr<obj::Object> startProcess(const std::string &command, const std::shared_ptr<obj::Future> &future)
+    {
+#ifdef _MSC_VER
+#define popen _popen
+#define pclose _pclose
+#endif
+        // without a pollable pipe the process is waited for on a worker of the shared pool
+        scheduler::WorkStealingPool::shared().submit([command, future]()
+                                                     {
+                                                         FILE *pipe = popen(command.c_str(), "r");
+                                                         if (!pipe)
+                                                         {
+                                                             future->set(std::make_shared<obj::Error>("run: failed to start " + command, obj::ErrorType::OSError));
+                                                             return;
+                                                         }
+                                                         std::string output;
+                                                         char buffer[4096];
+                                                         size_t nrRead = 0;
+                                                         while ((nrRead = fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+                                                             output.append(buffer, nrRead);
+                                                         future->set(makeRunResult(pclose(pipe), output)); });
+        return nullptr;
+    }
+#endif
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> async_sleep(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("sleep: expected 1 argument", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Double, "sleep: expected argument 1 to be a double");
+
+        auto future = std::make_shared<obj::Future>();
+        event::EventLoop::current()->callLater(static_cast<obj::Double *>(evaluatedExpr1.get())->value, [future]()
+                                               { future->set(NullObject); });
+        return future;
+    }
+
+    std::shared_ptr<obj::Object> async_read_file(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("read_file: expected 1 argument", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, String, "read_file: expected argument 1 to be a str");
+
+        // regular files are always reported readable by epoll, so they are read on a worker of the shared pool
+        auto future = std::make_shared<obj::Future>();
+        auto fileName = static_cast<obj::String *>(evaluatedExpr1.get())->value;
+        scheduler::WorkStealingPool::shared().submit([fileName, future]()
+                                                     {
+                                                         std::ifstream inputf(fileName, std::ios::binary);
+                                                         if (!inputf.is_open())
+                                                         {
+                                                             future->set(std::make_shared<obj::Error>("read_file: cannot open " + fileName, obj::ErrorType::OSError));
+                                                             return;
+                                                         }
+                                                         std::stringstream content;
+                                                         content << inputf.rdbuf();
+                                                         future->set(std::make_shared<obj::String>(content.str())); });
+        return future;
+    }
+
+    std::shared_ptr<obj::Object> async_run(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("run: expected 1 argument", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, String, "run: expected argument 1 to be a str");
+
+        auto future = std::make_shared<obj::Future>();
+        auto errorObj = startProcess(static_cast<obj::String *>(evaluatedExpr1.get())->value, future);
+        if (errorObj)
+            return errorObj;
+        return future;
+    }
+
+    std::shared_ptr<obj::Object> async_then(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return std::make_shared<obj::Error>("then: expected 2 arguments of type (future, func)", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->at(0).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Future, "then: expected argument 1 to be a future");
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Function, "then: expected argument 2 to be a function");
+
+        auto future = std::static_pointer_cast<obj::Future>(evaluatedExpr1);
+        auto function = std::static_pointer_cast<obj::Function>(evaluatedExpr2);
+        auto result = std::make_shared<obj::Future>();
+        auto loop = event::EventLoop::current();
+
+        // the function runs on the thread of the loop, whichever thread completes the future
+        future->onReady([loop, future, function, result]()
+                        { loop->post([future, function, result]()
+                                     {
+                                         auto functionEnvironment = std::make_shared<obj::Environment>();
+                                         functionEnvironment->outer = function->environment;
+                                         result->set(evalFunctionWithArguments(function.get(), {future->wait()}, functionEnvironment)); }); });
+        return result;
+    }
+
+    std::shared_ptr<obj::Object> async_gather(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("gather: expected 1 argument of type [future]", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Array, "gather: expected argument 1 to be an array of futures");
+
+        std::vector<std::shared_ptr<obj::Future>> futures;
+        for (const auto &element : static_cast<obj::Array *>(evaluatedExpr1.get())->value)
+        {
+            if (element->type != obj::ObjectType::Future)
+                return std::make_shared<obj::Error>("gather: expected argument 1 to be an array of futures", obj::ErrorType::TypeError);
+            futures.push_back(std::static_pointer_cast<obj::Future>(element));
+        }
+
+        auto result = std::make_shared<obj::Future>();
+        auto remaining = std::make_shared<std::atomic<size_t>>(futures.size());
+        if (futures.empty())
+            result->set(std::make_shared<obj::Array>(std::vector<std::shared_ptr<obj::Object>>{}));
+
+        for (const auto &future : futures)
+        {
+            future->onReady([futures, remaining, result]()
+                            {
+                                if (--(*remaining) > 0)
+                                    return;
+                                std::vector<std::shared_ptr<obj::Object>> values;
+                                for (const auto &completed : futures)
+                                    values.push_back(completed->wait());
+                                result->set(std::make_shared<obj::Array>(values)); });
+        }
+        return result;
+    }
+
+    std::shared_ptr<obj::Object> async_await(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("await: expected 1 argument of type (future)", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Future, "await: expected argument 1 to be a future");
+
+        // futures completed outside of the loop (e.g. by a thread pool) wake the loop up
+        auto future = std::static_pointer_cast<obj::Future>(evaluatedExpr1);
+        auto loop = event::EventLoop::current();
+        future->onReady([loop]()
+                        { loop->post([]() {}); });
+
+        while (!future->done())
+            loop->runOnce();
+        return future->wait();
+    }
+
+    std::shared_ptr<obj::Module> createAsyncModule()
+    {
+        auto asyncModule = std::make_shared<obj::Module>();
+        asyncModule->environment->add("sleep", builtin::makeBuiltInFunctionObj(&builtin::async_sleep, "double", "future"), false, nullptr);
+        asyncModule->environment->add("read_file", builtin::makeBuiltInFunctionObj(&builtin::async_read_file, "str", "future"), false, nullptr);
+        asyncModule->environment->add("run", builtin::makeBuiltInFunctionObj(&builtin::async_run, "str", "future"), false, nullptr);
+        asyncModule->environment->add("then", builtin::makeBuiltInFunctionObj(&builtin::async_then, "future, all", "future"), false, nullptr);
+        asyncModule->environment->add("gather", builtin::makeBuiltInFunctionObj(&builtin::async_gather, "[future]", "future"), false, nullptr);
+        asyncModule->environment->add("await", builtin::makeBuiltInFunctionObj(&builtin::async_await, "future", "all"), false, nullptr);
+        asyncModule->state = obj::ModuleState::Loaded;
+        return asyncModule;
+    }
+} // namespace builtin
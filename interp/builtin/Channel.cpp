@@ -0,0 +1,299 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Channel.h"
+#include "../Evaluator.h"
+#include "../Typing.h"
+#include "../Util.h"
+
+namespace
+{
+    std::shared_ptr<obj::Object>
+    validateArguments(
+        const std::string &errorPrefix,
+        const std::shared_ptr<obj::Object> &self,
+        const std::vector<std::shared_ptr<obj::Object>> &arguments,
+        const obj::ObjectType expectedType,
+        std::set<size_t> nrExpectedArguments)
+    {
+        if (self.get()->type != expectedType)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected " + toString(expectedType) + ", got " + toString(self.get()->type), obj::ErrorType::TypeError);
+        if (nrExpectedArguments.find(arguments.size()) == nrExpectedArguments.end())
+        {
+            if (nrExpectedArguments.size() == 1)
+            {
+                return std::make_shared<obj::Error>(errorPrefix + ": expected " + std::to_string(*nrExpectedArguments.begin()) + " arguments, got " + std::to_string(arguments.size()), obj::ErrorType::TypeError);
+            }
+            else
+            {
+                std::vector<std::string> nrExpected;
+                for (const auto &element : nrExpectedArguments)
+                    nrExpected.push_back(std::to_string(element));
+                return std::make_shared<obj::Error>(errorPrefix + ": expected " + util::join(nrExpected, ",") + " arguments, got " + std::to_string(arguments.size()), obj::ErrorType::TypeError);
+            }
+        }
+        return nullptr;
+    }
+}
+
+namespace obj
+{
+    Channel::Channel(size_t icapacity) : Object(ObjectType::Channel), capacity(icapacity), cells(new Cell[icapacity])
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    Channel::~Channel()
+    {
+    }
+
+    bool Channel::push(const std::shared_ptr<Object> &value)
+    {
+        Cell *cell = nullptr;
+        size_t position = sendPosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &cells[position % capacity];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+            if (difference == 0)
+            {
+                if (sendPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+                return false; // the cell still holds the value of the previous round, full
+            else
+                position = sendPosition.load(std::memory_order_relaxed);
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Channel::pop(std::shared_ptr<Object> &value)
+    {
+        Cell *cell = nullptr;
+        size_t position = receivePosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &cells[position % capacity];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position + 1);
+            if (difference == 0)
+            {
+                if (receivePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+                return false; // the cell has not been written in this round yet, empty
+            else
+                position = receivePosition.load(std::memory_order_relaxed);
+        }
+
+        value = std::move(cell->value);
+        cell->value.reset();
+        cell->sequence.store(position + capacity, std::memory_order_release);
+        return true;
+    }
+
+    /* the fence pairs with the one taken by a waiting thread after announcing itself,
+     * either the waiter sees the updated cell or the notifier sees the waiter
+     */
+    void Channel::wakeWaiter(std::atomic<size_t> &waiting, std::condition_variable &condition)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load() == 0)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(waitMutex);
+        }
+        condition.notify_one();
+    }
+
+    bool Channel::trySend(const std::shared_ptr<Object> &value)
+    {
+        if (closed.load() || !push(value))
+            return false;
+        wakeWaiter(waitingReceivers, notEmpty);
+        return true;
+    }
+
+    bool Channel::tryReceive(std::shared_ptr<Object> &value)
+    {
+        if (!pop(value))
+            return false;
+        wakeWaiter(waitingSenders, notFull);
+        return true;
+    }
+
+    bool Channel::send(const std::shared_ptr<Object> &value)
+    {
+        if (closed.load())
+            return false;
+
+        bool sent = push(value);
+        if (!sent)
+        {
+            std::unique_lock<std::mutex> lock(waitMutex);
+            ++waitingSenders;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            notFull.wait(lock, [this, &value, &sent]()
+                         { return closed.load() || (sent = push(value)); });
+            --waitingSenders;
+        }
+
+        if (sent)
+            wakeWaiter(waitingReceivers, notEmpty);
+        return sent;
+    }
+
+    bool Channel::receive(std::shared_ptr<Object> &value)
+    {
+        bool received = pop(value);
+        if (!received)
+        {
+            std::unique_lock<std::mutex> lock(waitMutex);
+            ++waitingReceivers;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            notEmpty.wait(lock, [this, &value, &received]()
+                          { return (received = pop(value)) || closed.load(); });
+            --waitingReceivers;
+        }
+
+        // a send racing with close can still complete after the wait observed the close
+        if (!received)
+            received = pop(value);
+
+        if (received)
+            wakeWaiter(waitingSenders, notFull);
+        return received;
+    }
+
+    void Channel::close()
+    {
+        closed = true;
+        {
+            std::lock_guard<std::mutex> lock(waitMutex);
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    std::string Channel::inspect() const
+    {
+        return "<channel>";
+    }
+
+    bool ChannelIterator::isValid() const
+    {
+        if (!received)
+            channel->receive(received);
+        return received != nullptr;
+    }
+
+    std::shared_ptr<Object> ChannelIterator::next()
+    {
+        if (isValid())
+        {
+            auto value = std::move(received);
+            received.reset();
+            return value;
+        }
+        return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
+    }
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> channel_send(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("send", self, arguments, obj::ObjectType::Channel, {1});
+        if (errorObj)
+            return errorObj;
+
+        if (!static_cast<obj::Channel *>(self.get())->send(arguments.front()))
+            return std::make_shared<obj::Error>("send: channel is closed", obj::ErrorType::ValueError);
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> channel_try_send(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("try_send", self, arguments, obj::ObjectType::Channel, {1});
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Boolean>(static_cast<obj::Channel *>(self.get())->trySend(arguments.front()));
+    }
+
+    std::shared_ptr<obj::Object> channel_recv(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("recv", self, arguments, obj::ObjectType::Channel, {0});
+        if (errorObj)
+            return errorObj;
+
+        // null can be sent as a value, so a closed and drained channel is reported as an error
+        std::shared_ptr<obj::Object> value;
+        if (!static_cast<obj::Channel *>(self.get())->receive(value))
+            return std::make_shared<obj::Error>("recv: channel is closed", obj::ErrorType::ValueError);
+        return value;
+    }
+
+    std::shared_ptr<obj::Object> channel_try_recv(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("try_recv", self, arguments, obj::ObjectType::Channel, {0});
+        if (errorObj)
+            return errorObj;
+
+        // returns [true, value] for a received value and [false, null] when there is none
+        std::shared_ptr<obj::Object> value;
+        const bool received = static_cast<obj::Channel *>(self.get())->tryReceive(value);
+        std::vector<std::shared_ptr<obj::Object>> result = {std::make_shared<obj::Boolean>(received), received ? value : NullObject};
+        return std::make_shared<obj::Array>(result);
+    }
+
+    std::shared_ptr<obj::Object> channel_close(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("close", self, arguments, obj::ObjectType::Channel, {0});
+        if (errorObj)
+            return errorObj;
+
+        static_cast<obj::Channel *>(self.get())->close();
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> channel_closed(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("closed", self, arguments, obj::ObjectType::Channel, {0});
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Boolean>(static_cast<obj::Channel *>(self.get())->closed.load());
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeChannel()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto channelBuiltinType = std::make_shared<obj::BuiltinType>();
+        channelBuiltinType->builtinObjectType = obj::ObjectType::Channel;
+
+        channelBuiltinType->functions = {
+            {"send", TBuiltInFD({&builtin::channel_send, typing::makeFunctionType("all", "null")})},
+            {"try_send", TBuiltInFD({&builtin::channel_try_send, typing::makeFunctionType("all", "bool")})},
+            {"recv", TBuiltInFD({&builtin::channel_recv, typing::makeFunctionType("", "all")})},
+            {"try_recv", TBuiltInFD({&builtin::channel_try_recv, typing::makeFunctionType("", "[all]")})},
+            {"close", TBuiltInFD({&builtin::channel_close, typing::makeFunctionType("", "null")})},
+            {"closed", TBuiltInFD({&builtin::channel_closed, typing::makeFunctionType("", "bool")})},
+        };
+
+        return channelBuiltinType;
+    }
+} // namespace builtin
@@ -117,7 +117,7 @@ namespace obj
 
     std::shared_ptr<Object> DictionaryIterator::clone() const
     {
-        return std::make_shared<DictionaryIterator>(dict, iterator);
+        return std::make_shared<DictionaryIterator>(dict, iterator, view);
     }
 
     bool DictionaryIterator::isValid() const
@@ -131,14 +131,21 @@ namespace obj
     {
         if (isValid())
         {
-            auto value = iterator->first;
-            ++iterator;
-            return value;
+            const auto &[key, value] = *iterator++;
+            switch (view)
+            {
+            case DictionaryView::Values:
+                return value;
+            case DictionaryView::Items:
+                return std::make_shared<obj::Array>(std::vector<std::shared_ptr<Object>>{key, value});
+            default:
+                return key;
+            }
         }
         return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
     }
 
-    DictionaryIterator::DictionaryIterator(std::shared_ptr<Dictionary> idict, TDictionaryMap::iterator iiterator) : Iterator(), dict(idict), freezer(idict), iterator(iiterator){};
+    DictionaryIterator::DictionaryIterator(std::shared_ptr<Dictionary> idict, TDictionaryMap::iterator iiterator, DictionaryView iview) : Iterator(), dict(idict), freezer(idict), iterator(iiterator), view(iview){};
 }
 
 namespace builtin
@@ -153,6 +160,9 @@ namespace builtin
 
     std::shared_ptr<obj::Object> dictionary_clear(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
     {
+        if (self->frozen > 0)
+            return std::make_shared<obj::Error>("dictionary clear expects a non-frozen object", obj::ErrorType::TypeError);
+
         auto errorObj = validateArguments("clear", self, arguments, obj::ObjectType::Dictionary, 0);
         if (errorObj)
             return errorObj;
@@ -217,6 +227,9 @@ namespace builtin
 
     std::shared_ptr<obj::Object> dictionary_update(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
     {
+        if (self->frozen > 0)
+            return std::make_shared<obj::Error>("dictionary update expects a non-frozen object", obj::ErrorType::TypeError);
+
         auto errorObj = validateArguments("update", self, arguments, obj::ObjectType::Dictionary, 1);
         if (errorObj)
             return errorObj;
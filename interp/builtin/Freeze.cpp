@@ -9,6 +9,113 @@
 #include "Freeze.h"
 #include "../Evaluator.h"
 
+#include <mutex>
+#include <unordered_set>
+
+namespace
+{
+    /* calls visit for every object directly referred to by the given container object, the
+     * references are passed by reference so that visit can replace them where the container allows it
+     */
+    template <typename TVisit>
+    void forEachReferenced(obj::Object *object, TVisit visit)
+    {
+        switch (object->type)
+        {
+        case obj::ObjectType::Array:
+            for (auto &element : static_cast<obj::Array *>(object)->value)
+                element = visit(element);
+            break;
+        case obj::ObjectType::Dictionary:
+            // keys are const in the map, they are visited but keep their owning reference
+            for (auto &[key, value] : static_cast<obj::Dictionary *>(object)->value)
+            {
+                visit(key);
+                value = visit(value);
+            }
+            break;
+        case obj::ObjectType::Set:
+            for (const auto &element : static_cast<obj::Set *>(object)->value)
+                visit(element);
+            break;
+        case obj::ObjectType::UserObject:
+            for (auto &[name, property] : static_cast<obj::UserObject *>(object)->properties)
+                property.obj = visit(property.obj);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /* owning references to all immortal objects, deliberately never destructed: a shared object must stay valid
+     * until the very end of the process as any thread may still be reading it
+     */
+    std::mutex immortalsMutex;
+    std::vector<std::shared_ptr<obj::Object>> *immortals = new std::vector<std::shared_ptr<obj::Object>>();
+
+    /* a reference that does not own the object, copying it leaves the reference count alone */
+    std::shared_ptr<obj::Object> unownedReference(obj::Object *object)
+    {
+        return std::shared_ptr<obj::Object>(std::shared_ptr<obj::Object>(), object);
+    }
+
+    std::shared_ptr<obj::Object> freezeDeep(const std::shared_ptr<obj::Object> &root)
+    {
+        std::unordered_set<obj::Object *> visited;
+        std::vector<obj::Object *> pending;
+        auto visit = [&visited, &pending](const std::shared_ptr<obj::Object> &object)
+        {
+            if (object && !object->immortal && visited.insert(object.get()).second)
+            {
+                ++object->frozen;
+                pending.push_back(object.get());
+            }
+            return object;
+        };
+
+        // an explicit worklist instead of recursion, a long linked structure must not exhaust the stack
+        visit(root);
+        while (!pending.empty())
+        {
+            auto object = pending.back();
+            pending.pop_back();
+            forEachReferenced(object, visit);
+        }
+        return root;
+    }
+
+    std::shared_ptr<obj::Object> makeImmortal(const std::shared_ptr<obj::Object> &root)
+    {
+        std::vector<std::shared_ptr<obj::Object>> adopted;
+        std::vector<obj::Object *> pending;
+        auto visit = [&adopted, &pending](const std::shared_ptr<obj::Object> &object)
+        {
+            if (!object)
+                return object;
+            // the flag is set before the references of the object are visited, so that cycles end here
+            if (!object->immortal.exchange(true))
+            {
+                ++object->frozen;
+                adopted.push_back(object);
+                pending.push_back(object.get());
+            }
+            return unownedReference(object.get());
+        };
+
+        auto result = visit(root);
+        while (!pending.empty())
+        {
+            auto object = pending.back();
+            pending.pop_back();
+            forEachReferenced(object, visit);
+        }
+
+        std::lock_guard<std::mutex> lock(immortalsMutex);
+        immortals->insert(immortals->end(), adopted.begin(), adopted.end());
+        return result;
+    }
+}
+
 namespace builtin
 {
     std::shared_ptr<obj::Object> frozen(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
@@ -33,7 +140,8 @@ namespace builtin
             return obj::makeTypeError("freeze: expected 1 arguments");
 
         auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
-        ++evaluatedExpr->frozen;
+        if (!evaluatedExpr->immortal)
+            ++evaluatedExpr->frozen;
         return evaluatedExpr;
     }
 
@@ -46,6 +154,8 @@ namespace builtin
             return obj::makeTypeError("defrost: expected 1 arguments");
 
         auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        if (evaluatedExpr->immortal)
+            return std::make_shared<obj::Error>("defrost: cannot defrost a shared object", obj::ErrorType::ValueError);
         if (evaluatedExpr->frozen > 0)
             --evaluatedExpr->frozen;
         return evaluatedExpr;
@@ -63,4 +173,32 @@ namespace builtin
 
         return std::make_shared<obj::ObjectFreezer>(evaluatedExpr);
     }
-}
\ No newline at end of file
+
+    std::shared_ptr<obj::Object> freeze_deep(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return obj::makeTypeError("freeze_deep: expected 1 arguments");
+
+        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        if (evaluatedExpr->type == obj::ObjectType::Error)
+            return evaluatedExpr;
+        return freezeDeep(evaluatedExpr);
+    }
+
+    std::shared_ptr<obj::Object> share(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return obj::makeTypeError("share: expected 1 arguments");
+
+        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        if (evaluatedExpr->type == obj::ObjectType::Error)
+            return evaluatedExpr;
+        return makeImmortal(evaluatedExpr);
+    }
+}
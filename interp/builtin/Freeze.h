@@ -17,6 +17,14 @@ namespace builtin
     std::shared_ptr<obj::Object> freeze(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
     std::shared_ptr<obj::Object> defrost(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
     std::shared_ptr<obj::Object> freezer(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
+
+    /* freeze an object and everything reachable from it through arrays, dictionaries, sets and user objects */
+    std::shared_ptr<obj::Object> freeze_deep(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
+
+    /* deep-freeze an object for good and make it immortal, so that any number of threads can read it without
+     * touching reference counts or locks; returns the reference to use from then on
+     */
+    std::shared_ptr<obj::Object> share(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
 }
 
 #endif
\ No newline at end of file
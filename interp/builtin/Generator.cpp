@@ -0,0 +1,108 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Generator.h"
+#include "../Coroutine.h"
+#include "../Evaluator.h"
+
+namespace
+{
+    /* generator whose body is running on this thread, innermost when generators consume each other */
+    thread_local obj::Generator *currentGenerator = nullptr;
+}
+
+namespace obj
+{
+    Generator::Generator(TBody ibody) : Iterator()
+    {
+        body = std::make_unique<coroutine::Coroutine>([this, function = std::move(ibody)]()
+                                                      {
+            auto result = function();
+            // an error or exit ending the body is handed out as the last value, so that it reaches the consumer
+            if (!stopping && (result->type == ObjectType::Error || result->type == ObjectType::Exit))
+                yielded = result; });
+    }
+
+    Generator::~Generator()
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (!body->isStarted() || body->isFinished())
+            return;
+
+        // the body only runs on the thread that created it, destroyed elsewhere its stack is released
+        // without running the destructors of the objects its frames still hold
+        if (!body->isOwnedByCallingThread())
+            return;
+
+        stopping = true;
+        while (!body->isFinished())
+            resume();
+    }
+
+    void Generator::resume() const
+    {
+        if (body->isRunning())
+        {
+            yielded = std::make_shared<obj::Error>("generator is already running", obj::ErrorType::ValueError);
+            return;
+        }
+
+        auto previousGenerator = currentGenerator;
+        currentGenerator = const_cast<Generator *>(this);
+        try
+        {
+            body->resume();
+        }
+        catch (const std::exception &e)
+        {
+            yielded = std::make_shared<obj::Error>(e.what(), obj::ErrorType::UndefinedError);
+        }
+        currentGenerator = previousGenerator;
+    }
+
+    bool Generator::isValid() const
+    {
+        // the body can drop the last reference to its own generator, which is then destroyed once
+        // the body suspended again instead of while it still runs on the stack of the generator
+        auto keepAlive = self.lock();
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (!yielded && !body->isFinished())
+            resume();
+        return yielded != nullptr;
+    }
+
+    std::shared_ptr<Object> Generator::next()
+    {
+        auto keepAlive = self.lock();
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        if (isValid())
+        {
+            auto value = std::move(yielded);
+            yielded.reset();
+            return value;
+        }
+        return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
+    }
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> yieldValue(const std::shared_ptr<obj::Object> &value)
+    {
+        auto generator = currentGenerator;
+        if (!generator || coroutine::Coroutine::current() != generator->body.get())
+            return std::make_shared<obj::Error>("yield outside of a generator", obj::ErrorType::TypeError);
+
+        generator->yielded = value;
+        coroutine::Coroutine::suspend();
+
+        if (generator->stopping)
+            return std::make_shared<obj::Exit>(0);
+        return NullObject;
+    }
+}
@@ -0,0 +1,23 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_BUILTIN_GENERATOR_H
+#define GUARDIAN_OF_INCLUSION_BUILTIN_GENERATOR_H
+
+#include "../Object.h"
+
+namespace builtin
+{
+    /* hand value to the consumer of the generator whose body is running on the calling thread
+     * and suspend the body until the next value is asked for; returns an Exit when the generator
+     * is destroyed before its body finished, so that the body unwinds like on exit
+     */
+    std::shared_ptr<obj::Object> yieldValue(const std::shared_ptr<obj::Object> &value);
+}
+
+#endif
@@ -0,0 +1,528 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Iter.h"
+#include "../Evaluator.h"
+
+/* lazy adaptors on iterators, every adaptor pulls its elements one at a time from the
+ * iterator it wraps, so that a pipeline of adaptors runs as a single loop over the source
+ * without materializing the intermediate results
+ */
+namespace
+{
+    typedef std::shared_ptr<obj::Iterator> TIterator;
+
+    TIterator makeIterator(const std::shared_ptr<obj::Object> &obj)
+    {
+        return std::dynamic_pointer_cast<obj::Iterator>(builtin::iter_impl(obj));
+    }
+
+    TIterator cloneIterator(const TIterator &iterator)
+    {
+        return std::static_pointer_cast<obj::Iterator>(iterator->clone());
+    }
+
+    std::vector<TIterator> cloneIterators(const std::vector<TIterator> &iterators)
+    {
+        std::vector<TIterator> clones;
+        for (const auto &iterator : iterators)
+            clones.push_back(cloneIterator(iterator));
+        return clones;
+    }
+
+    std::shared_ptr<obj::Object> call(const std::shared_ptr<obj::Function> &function, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        return evalFunctionWithArguments(function.get(), arguments, function->environment);
+    }
+
+    struct MapIterator : public obj::Iterator
+    {
+        std::shared_ptr<obj::Function> function;
+        TIterator source;
+
+        virtual std::string inspect() const override
+        {
+            return "MapIterator()";
+        }
+        virtual std::shared_ptr<obj::Object> clone() const override
+        {
+            return std::make_shared<MapIterator>(function, cloneIterator(source));
+        }
+        virtual bool isValid() const override
+        {
+            return source->isValid();
+        }
+        virtual std::shared_ptr<obj::Object> next() override
+        {
+            auto value = source->next();
+            if (value->type == obj::ObjectType::Error)
+                return value;
+            return call(function, {value});
+        }
+        MapIterator(std::shared_ptr<obj::Function> ifunction, TIterator isource) : Iterator(), function(ifunction), source(isource){};
+    };
+
+    struct FilterIterator : public obj::Iterator
+    {
+        std::shared_ptr<obj::Function> function;
+        TIterator source;
+        mutable std::shared_ptr<obj::Object> accepted; /*< next value passing the filter, found by isValid */
+
+        virtual std::string inspect() const override
+        {
+            return "FilterIterator()";
+        }
+        virtual std::shared_ptr<obj::Object> clone() const override
+        {
+            auto iterator = std::make_shared<FilterIterator>(function, cloneIterator(source));
+            iterator->accepted = accepted;
+            return iterator;
+        }
+        virtual bool isValid() const override
+        {
+            while (!accepted && source->isValid())
+            {
+                auto value = source->next();
+                if (value->type == obj::ObjectType::Error)
+                {
+                    accepted = value;
+                    break;
+                }
+
+                auto keep = call(function, {value});
+                if (keep->type == obj::ObjectType::Error)
+                    accepted = keep;
+                else if (keep->type != obj::ObjectType::Boolean)
+                    accepted = std::make_shared<obj::Error>("filter: expected the function to return a bool, got " + obj::toString(keep->type), obj::ErrorType::TypeError);
+                else if (static_cast<obj::Boolean *>(keep.get())->value)
+                    accepted = value;
+            }
+            return accepted != nullptr;
+        }
+        virtual std::shared_ptr<obj::Object> next() override
+        {
+            if (isValid())
+            {
+                auto value = std::move(accepted);
+                accepted.reset();
+                return value;
+            }
+            return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
+        }
+        FilterIterator(std::shared_ptr<obj::Function> ifunction, TIterator isource) : Iterator(), function(ifunction), source(isource){};
+    };
+
+    struct ZipIterator : public obj::Iterator
+    {
+        std::vector<TIterator> sources;
+
+        virtual std::string inspect() const override
+        {
+            return "ZipIterator()";
+        }
+        virtual std::shared_ptr<obj::Object> clone() const override
+        {
+            return std::make_shared<ZipIterator>(cloneIterators(sources));
+        }
+        /* valid as long as all sources are */
+        virtual bool isValid() const override
+        {
+            for (const auto &source : sources)
+                if (!source->isValid())
+                    return false;
+            return !sources.empty();
+        }
+        virtual std::shared_ptr<obj::Object> next() override
+        {
+            std::vector<std::shared_ptr<obj::Object>> values;
+            values.reserve(sources.size());
+            for (const auto &source : sources)
+            {
+                values.push_back(source->next());
+                if (values.back()->type == obj::ObjectType::Error)
+                    return values.back();
+            }
+            return std::make_shared<obj::Array>(values);
+        }
+        ZipIterator(std::vector<TIterator> isources) : Iterator(), sources(std::move(isources)){};
+    };
+
+    struct EnumerateIterator : public obj::Iterator
+    {
+        TIterator source;
+        int64_t index = 0;
+
+        virtual std::string inspect() const override
+        {
+            return "EnumerateIterator()";
+        }
+        virtual std::shared_ptr<obj::Object> clone() const override
+        {
+            return std::make_shared<EnumerateIterator>(cloneIterator(source), index);
+        }
+        virtual bool isValid() const override
+        {
+            return source->isValid();
+        }
+        virtual std::shared_ptr<obj::Object> next() override
+        {
+            auto value = source->next();
+            if (value->type == obj::ObjectType::Error)
+                return value;
+            return std::make_shared<obj::Array>(std::vector<std::shared_ptr<obj::Object>>{std::make_shared<obj::Integer>(index++), value});
+        }
+        EnumerateIterator(TIterator isource, int64_t iindex) : Iterator(), source(isource), index(iindex){};
+    };
+
+    struct TakeIterator : public obj::Iterator
+    {
+        TIterator source;
+        int64_t remaining;
+
+        virtual std::string inspect() const override
+        {
+            return "TakeIterator()";
+        }
+        virtual std::shared_ptr<obj::Object> clone() const override
+        {
+            return std::make_shared<TakeIterator>(cloneIterator(source), remaining);
+        }
+        /* does not touch the source once enough elements are taken, so an infinite source can be cut short */
+        virtual bool isValid() const override
+        {
+            return remaining > 0 && source->isValid();
+        }
+        virtual std::shared_ptr<obj::Object> next() override
+        {
+            if (remaining <= 0)
+                return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
+            --remaining;
+            return source->next();
+        }
+        TakeIterator(TIterator isource, int64_t iremaining) : Iterator(), source(isource), remaining(iremaining){};
+    };
+
+    struct SkipIterator : public obj::Iterator
+    {
+        TIterator source;
+        mutable int64_t remaining; /*< elements still to be skipped, done when the first element is asked for */
+
+        virtual std::string inspect() const override
+        {
+            return "SkipIterator()";
+        }
+        virtual std::shared_ptr<obj::Object> clone() const override
+        {
+            return std::make_shared<SkipIterator>(cloneIterator(source), remaining);
+        }
+        virtual bool isValid() const override
+        {
+            for (; remaining > 0 && source->isValid(); --remaining)
+                source->next();
+            return source->isValid();
+        }
+        virtual std::shared_ptr<obj::Object> next() override
+        {
+            if (isValid())
+                return source->next();
+            return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
+        }
+        SkipIterator(TIterator isource, int64_t iremaining) : Iterator(), source(isource), remaining(iremaining){};
+    };
+
+    struct ChainIterator : public obj::Iterator
+    {
+        std::vector<TIterator> sources;
+        mutable size_t current = 0; /*< source currently handing out elements */
+
+        virtual std::string inspect() const override
+        {
+            return "ChainIterator()";
+        }
+        virtual std::shared_ptr<obj::Object> clone() const override
+        {
+            auto iterator = std::make_shared<ChainIterator>(cloneIterators(sources));
+            iterator->current = current;
+            return iterator;
+        }
+        virtual bool isValid() const override
+        {
+            while (current < sources.size() && !sources[current]->isValid())
+                ++current;
+            return current < sources.size();
+        }
+        virtual std::shared_ptr<obj::Object> next() override
+        {
+            if (isValid())
+                return sources[current]->next();
+            return std::make_shared<obj::Error>("next referencing invalid iterator", obj::ErrorType::TypeError);
+        }
+        ChainIterator(std::vector<TIterator> isources) : Iterator(), sources(std::move(isources)){};
+    };
+
+    /* evaluate argument index as something that can be iterated over, returns an error when it cannot */
+    std::shared_ptr<obj::Object> iterableArgument(const std::string &errorPrefix, const std::vector<std::unique_ptr<ast::Expression>> *arguments, size_t index, const std::shared_ptr<obj::Environment> &environment, TIterator &iterator)
+    {
+        auto evaluatedExpr = evalExpression(arguments->at(index).get(), environment);
+        if (evaluatedExpr->type == obj::ObjectType::Error)
+            return evaluatedExpr;
+        iterator = makeIterator(evaluatedExpr);
+        if (!iterator)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected argument " + std::to_string(index + 1) + " to be iterable, got " + obj::toString(evaluatedExpr->type), obj::ErrorType::TypeError);
+        return nullptr;
+    }
+
+    /* evaluate the arguments as a function followed by something that can be iterated over */
+    std::shared_ptr<obj::Object> functionAndIterableArguments(const std::string &errorPrefix, const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment, std::shared_ptr<obj::Function> &function, TIterator &iterator)
+    {
+        auto evaluatedExpr1 = evalExpression(arguments->at(0).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Function, errorPrefix + ": expected argument 1 to be a function");
+        function = std::static_pointer_cast<obj::Function>(evaluatedExpr1);
+        return iterableArgument(errorPrefix, arguments, 1, environment, iterator);
+    }
+
+    /* evaluate the arguments as something that can be iterated over followed by a count */
+    std::shared_ptr<obj::Object> iterableAndCountArguments(const std::string &errorPrefix, const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment, TIterator &iterator, int64_t &count)
+    {
+        auto errorObj = iterableArgument(errorPrefix, arguments, 0, environment, iterator);
+        if (errorObj)
+            return errorObj;
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Integer, errorPrefix + ": expected argument 2 to be an int");
+        count = static_cast<obj::Integer *>(evaluatedExpr2.get())->value;
+        if (count < 0)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected a non-negative count", obj::ErrorType::ValueError);
+        return nullptr;
+    }
+
+    std::shared_ptr<obj::Object> dictionaryView(const std::string &errorPrefix, const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment, obj::DictionaryView view)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected 1 argument of type {all:all}", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Dictionary, errorPrefix + ": expected argument 1 to be a dictionary");
+
+        auto dict = std::static_pointer_cast<obj::Dictionary>(evaluatedExpr1);
+        return std::make_shared<obj::DictionaryIterator>(dict, dict->value.begin(), view);
+    }
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> iter_map(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return std::make_shared<obj::Error>("map: expected 2 arguments of type (func, all)", obj::ErrorType::TypeError);
+
+        std::shared_ptr<obj::Function> function;
+        TIterator source;
+        auto errorObj = functionAndIterableArguments("map", arguments, environment, function, source);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<MapIterator>(function, source);
+    }
+
+    std::shared_ptr<obj::Object> iter_filter(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return std::make_shared<obj::Error>("filter: expected 2 arguments of type (func, all)", obj::ErrorType::TypeError);
+
+        std::shared_ptr<obj::Function> function;
+        TIterator source;
+        auto errorObj = functionAndIterableArguments("filter", arguments, environment, function, source);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<FilterIterator>(function, source);
+    }
+
+    std::shared_ptr<obj::Object> iter_zip(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->empty())
+            return std::make_shared<obj::Error>("zip: expected at least 1 argument", obj::ErrorType::TypeError);
+
+        std::vector<TIterator> sources(arguments->size());
+        for (size_t index = 0; index < arguments->size(); ++index)
+        {
+            auto errorObj = iterableArgument("zip", arguments, index, environment, sources[index]);
+            if (errorObj)
+                return errorObj;
+        }
+
+        return std::make_shared<ZipIterator>(std::move(sources));
+    }
+
+    std::shared_ptr<obj::Object> iter_enumerate(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("enumerate: expected 1 argument", obj::ErrorType::TypeError);
+
+        TIterator source;
+        auto errorObj = iterableArgument("enumerate", arguments, 0, environment, source);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<EnumerateIterator>(source, 0);
+    }
+
+    std::shared_ptr<obj::Object> iter_take(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return std::make_shared<obj::Error>("take: expected 2 arguments of type (all, int)", obj::ErrorType::TypeError);
+
+        TIterator source;
+        int64_t count = 0;
+        auto errorObj = iterableAndCountArguments("take", arguments, environment, source, count);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<TakeIterator>(source, count);
+    }
+
+    std::shared_ptr<obj::Object> iter_skip(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return std::make_shared<obj::Error>("skip: expected 2 arguments of type (all, int)", obj::ErrorType::TypeError);
+
+        TIterator source;
+        int64_t count = 0;
+        auto errorObj = iterableAndCountArguments("skip", arguments, environment, source, count);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<SkipIterator>(source, count);
+    }
+
+    std::shared_ptr<obj::Object> iter_chain(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        std::vector<TIterator> sources(arguments->size());
+        for (size_t index = 0; index < arguments->size(); ++index)
+        {
+            auto errorObj = iterableArgument("chain", arguments, index, environment, sources[index]);
+            if (errorObj)
+                return errorObj;
+        }
+
+        return std::make_shared<ChainIterator>(std::move(sources));
+    }
+
+    std::shared_ptr<obj::Object> iter_reduce(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2 && arguments->size() != 3)
+            return std::make_shared<obj::Error>("reduce: expected 2 or 3 arguments of type (func, all, all)", obj::ErrorType::TypeError);
+
+        std::shared_ptr<obj::Function> function;
+        TIterator source;
+        auto errorObj = functionAndIterableArguments("reduce", arguments, environment, function, source);
+        if (errorObj)
+            return errorObj;
+
+        std::shared_ptr<obj::Object> accumulated;
+        if (arguments->size() == 3)
+            accumulated = evalExpression(arguments->at(2).get(), environment);
+        else if (source->isValid())
+            accumulated = source->next();
+        else
+            return std::make_shared<obj::Error>("reduce: empty sequence without initial value", obj::ErrorType::ValueError);
+
+        while (accumulated->type != obj::ObjectType::Error && source->isValid())
+        {
+            auto value = source->next();
+            if (value->type == obj::ObjectType::Error)
+                return value;
+            accumulated = call(function, {accumulated, value});
+        }
+        return accumulated;
+    }
+
+    std::shared_ptr<obj::Object> iter_collect(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("collect: expected 1 argument", obj::ErrorType::TypeError);
+
+        TIterator source;
+        auto errorObj = iterableArgument("collect", arguments, 0, environment, source);
+        if (errorObj)
+            return errorObj;
+
+        std::vector<std::shared_ptr<obj::Object>> values;
+        while (source->isValid())
+        {
+            values.push_back(source->next());
+            if (values.back()->type == obj::ObjectType::Error)
+                return values.back();
+        }
+        return std::make_shared<obj::Array>(values);
+    }
+
+    std::shared_ptr<obj::Object> iter_keys(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        return dictionaryView("keys", arguments, environment, obj::DictionaryView::Keys);
+    }
+
+    std::shared_ptr<obj::Object> iter_values(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        return dictionaryView("values", arguments, environment, obj::DictionaryView::Values);
+    }
+
+    std::shared_ptr<obj::Object> iter_items(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        return dictionaryView("items", arguments, environment, obj::DictionaryView::Items);
+    }
+
+    std::shared_ptr<obj::Module> createIterModule()
+    {
+        auto iterModule = std::make_shared<obj::Module>();
+        iterModule->environment->add("map", builtin::makeBuiltInFunctionObj(&builtin::iter_map, "all, all", "iterator"), false, nullptr);
+        iterModule->environment->add("filter", builtin::makeBuiltInFunctionObj(&builtin::iter_filter, "all, all", "iterator"), false, nullptr);
+        iterModule->environment->add("zip", builtin::makeBuiltInFunctionObj(&builtin::iter_zip, "all", "iterator"), false, nullptr);
+        iterModule->environment->add("enumerate", builtin::makeBuiltInFunctionObj(&builtin::iter_enumerate, "all", "iterator"), false, nullptr);
+        iterModule->environment->add("take", builtin::makeBuiltInFunctionObj(&builtin::iter_take, "all, int", "iterator"), false, nullptr);
+        iterModule->environment->add("skip", builtin::makeBuiltInFunctionObj(&builtin::iter_skip, "all, int", "iterator"), false, nullptr);
+        iterModule->environment->add("chain", builtin::makeBuiltInFunctionObj(&builtin::iter_chain, "all", "iterator"), false, nullptr);
+        iterModule->environment->add("reduce", builtin::makeBuiltInFunctionObj(&builtin::iter_reduce, "all, all, all", "all"), false, nullptr);
+        iterModule->environment->add("collect", builtin::makeBuiltInFunctionObj(&builtin::iter_collect, "all", "[all]"), false, nullptr);
+        iterModule->environment->add("keys", builtin::makeBuiltInFunctionObj(&builtin::iter_keys, "{all:all}", "iterator"), false, nullptr);
+        iterModule->environment->add("values", builtin::makeBuiltInFunctionObj(&builtin::iter_values, "{all:all}", "iterator"), false, nullptr);
+        iterModule->environment->add("items", builtin::makeBuiltInFunctionObj(&builtin::iter_items, "{all:all}", "iterator"), false, nullptr);
+        iterModule->state = obj::ModuleState::Loaded;
+        return iterModule;
+    }
+} // namespace builtin
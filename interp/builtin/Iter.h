@@ -0,0 +1,19 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_BUILTIN_ITER_H
+#define GUARDIAN_OF_INCLUSION_BUILTIN_ITER_H
+
+#include "../Object.h"
+
+namespace builtin
+{
+    std::shared_ptr<obj::Module> createIterModule();
+}
+
+#endif
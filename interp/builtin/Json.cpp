@@ -317,6 +317,14 @@ namespace
                 values.push_back(objectToJsonValue(element));
             return JsonValue(values);
         }
+        case obj::ObjectType::ArrayInt:
+        {
+            std::vector<JsonValue> values;
+            auto array = static_cast<obj::ArrayInt *>(value.get());
+            for (const auto &element : array->value)
+                values.push_back(JsonValue(element));
+            return JsonValue(values);
+        }
         case obj::ObjectType::ArrayDouble:
         {
             std::vector<JsonValue> values;
@@ -326,6 +334,8 @@ namespace
             return JsonValue(values);
         }
         break;
+        case obj::ObjectType::ArrayView:
+            return objectToJsonValue(value->clone());
         case obj::ObjectType::Boolean:
             return JsonValue(static_cast<obj::Boolean *>(value.get())->value);
         case obj::ObjectType::Null:
@@ -8,32 +8,222 @@
 
 #include "Math.h"
 #include "../Evaluator.h"
+#include "../Scheduler.h"
+#include "../Simd.h"
 #include "../Typing.h"
 
+#include <cmath>
+#include <complex>
+
 namespace
 {
     typedef double (*TBuiltinDoubleFunction)(double arg);
+    typedef void (*TBuiltinArrayKernel)(const double *values, double *out, size_t n);
+
+    /* the objects holding a double or a complex result */
+    template <typename T>
+    struct ResultObject;
+
+    template <>
+    struct ResultObject<double>
+    {
+        typedef obj::Double scalar;
+        typedef obj::ArrayDouble array;
+        static constexpr obj::ObjectType arrayType = obj::ObjectType::ArrayDouble;
+        static constexpr const char *arrayName = "array_double";
+    };
+
+    template <>
+    struct ResultObject<std::complex<double>>
+    {
+        typedef obj::Complex scalar;
+        typedef obj::ArrayComplex array;
+        static constexpr obj::ObjectType arrayType = obj::ObjectType::ArrayComplex;
+        static constexpr const char *arrayName = "array_complex";
+    };
+
+    /* a number or an array of numbers given to a math function; array_double and array_complex are
+     * read in place, ints are converted into realBuffer
+     */
+    struct MathArgument
+    {
+        std::shared_ptr<obj::Object> owner;
+        bool isArray = false;
+        bool isComplex = false;
+        std::vector<double> realBuffer;
+        const double *real = nullptr;
+        std::vector<std::complex<double>> complexBuffer;
+        const std::complex<double> *complex = nullptr;
+        size_t n = 1;
+
+        double realAt(size_t i) const { return real[isArray ? i : 0]; }
+        std::complex<double> complexAt(size_t i) const { return isComplex ? complex[isArray ? i : 0] : std::complex<double>(realAt(i)); }
+    };
+
+    /* returns nullptr when the argument is set, otherwise the error */
+    std::shared_ptr<obj::Object> mathArgument(const std::shared_ptr<obj::Object> &obj, MathArgument &result)
+    {
+        result.owner = obj;
+        switch (obj->type)
+        {
+        case obj::ObjectType::Error:
+            return obj;
+        case obj::ObjectType::Double:
+            result.real = &static_cast<obj::Double *>(obj.get())->value;
+            return nullptr;
+        case obj::ObjectType::Integer:
+            result.realBuffer.push_back(static_cast<double>(static_cast<obj::Integer *>(obj.get())->value));
+            result.real = result.realBuffer.data();
+            return nullptr;
+        case obj::ObjectType::Complex:
+            result.isComplex = true;
+            result.complex = &static_cast<obj::Complex *>(obj.get())->value;
+            return nullptr;
+        case obj::ObjectType::ArrayDouble:
+        {
+            const auto &values = static_cast<obj::ArrayDouble *>(obj.get())->value;
+            result.isArray = true;
+            result.real = values.data();
+            result.n = values.size();
+            return nullptr;
+        }
+        case obj::ObjectType::ArrayInt:
+        {
+            const auto &values = static_cast<obj::ArrayInt *>(obj.get())->value;
+            result.isArray = true;
+            result.realBuffer.assign(values.begin(), values.end());
+            result.real = result.realBuffer.data();
+            result.n = values.size();
+            return nullptr;
+        }
+        case obj::ObjectType::ArrayComplex:
+        {
+            const auto &values = static_cast<obj::ArrayComplex *>(obj.get())->value;
+            result.isArray = true;
+            result.isComplex = true;
+            result.complex = values.data();
+            result.n = values.size();
+            return nullptr;
+        }
+        case obj::ObjectType::ArrayView:
+            return mathArgument(obj->clone(), result);
+        default:
+            break;
+        }
+        return std::make_shared<obj::Error>(obj::Error("Invalid type for function, expected double, complex or an array of them, got: " + obj::toString(obj->type), obj::ErrorType::TypeError));
+    }
+
+    /* the array the n results are written to: out when it is given, otherwise a new array.  Returns the
+     * array or the error
+     */
+    template <typename T>
+    std::shared_ptr<obj::Object> resultArray(const std::shared_ptr<obj::Object> &out, size_t n, T *&values)
+    {
+        typedef typename ResultObject<T>::array TArray;
+        if (!out)
+        {
+            auto result = std::make_shared<TArray>(std::vector<T>(n));
+            values = result->value.data();
+            return result;
+        }
+
+        if (out->type != ResultObject<T>::arrayType)
+            return std::make_shared<obj::Error>(obj::Error("Invalid type for out, expected " + std::string(ResultObject<T>::arrayName) + ", got: " + obj::toString(out->type), obj::ErrorType::TypeError));
+        if (out->frozen > 0)
+            return std::make_shared<obj::Error>("Invalid out, expected a non-frozen array", obj::ErrorType::TypeError);
+        auto &outValues = static_cast<TArray *>(out.get())->value;
+        if (outValues.size() != n)
+            return std::make_shared<obj::Error>("Invalid out, expected an array of " + std::to_string(n) + " elements, got " + std::to_string(outValues.size()), obj::ErrorType::ValueError);
+        values = outValues.data();
+        return out;
+    }
+
+    /* out[i] = function(i) for all i < n, over the shared worker pool for large arrays */
+    template <typename T, typename TFunction>
+    void fillValues(T *out, size_t n, const TFunction &function)
+    {
+        scheduler::parallelFor(n, scheduler::parallelThreshold(), [out, &function](size_t begin, size_t end)
+                               {
+                                   for (size_t i = begin; i < end; ++i)
+                                       out[i] = function(i); });
+    }
 
-    template <TBuiltinDoubleFunction double_fn>
+    /* the optional out argument following the count arguments of a math function, nullptr when it is not given */
+    std::shared_ptr<obj::Object> outArgument(const std::vector<std::unique_ptr<ast::Expression>> *arguments, size_t count, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (arguments->size() <= count)
+            return nullptr;
+        return evalExpression(arguments->at(count).get(), environment);
+    }
+
+    /* fn applied to a number, or to each element of an array.  A function with a complex form takes
+     * complex numbers as well, the complex form of abs gives doubles; array_kernel computes the
+     * function for a whole array_double at once
+     */
+    template <TBuiltinDoubleFunction double_fn, typename TComplexResult = std::complex<double>, TComplexResult (*complex_fn)(const std::complex<double> &) = nullptr, TBuiltinArrayKernel array_kernel = nullptr>
     std::shared_ptr<obj::Object> r_double_double_function(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
     {
         if (!arguments)
             return NullObject;
 
-        if (arguments->size() != 1)
-            return std::make_shared<obj::Error>("expected 1 argument", obj::ErrorType::TypeError);
+        if (arguments->size() != 1 && arguments->size() != 2)
+            return std::make_shared<obj::Error>("expected 1 or 2 arguments", obj::ErrorType::TypeError);
 
-        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
-        auto errorObj = dynamic_cast<obj::Error *>(evaluatedExpr.get());
+        MathArgument argument;
+        auto errorObj = mathArgument(evalExpression(arguments->front().get(), environment), argument);
         if (errorObj)
-            return evaluatedExpr;
+            return errorObj;
+
+        auto out = outArgument(arguments, 1, environment);
+        if (out && out->type == obj::ObjectType::Error)
+            return out;
+        if (out && !argument.isArray)
+            return std::make_shared<obj::Error>("Invalid out, only used for an array argument", obj::ErrorType::TypeError);
 
-        auto doubleObj = dynamic_cast<obj::Double *>(evaluatedExpr.get());
-        if (doubleObj)
-            return std::make_shared<obj::Double>(double_fn(doubleObj->value));
+        if (argument.isComplex)
+        {
+            if constexpr (complex_fn == nullptr)
+                return std::make_shared<obj::Error>(obj::Error("Invalid type for function, expected double, got: " + obj::toString(argument.owner->type), obj::ErrorType::TypeError));
+            else
+            {
+                if (!argument.isArray)
+                    return std::make_shared<typename ResultObject<TComplexResult>::scalar>(complex_fn(*argument.complex));
 
-        return std::make_shared<obj::Error>(obj::Error("Invalid type for function, expected double, got: " + obj::toString(evaluatedExpr->type), obj::ErrorType::TypeError));
+                TComplexResult *values = nullptr;
+                auto result = resultArray(out, argument.n, values);
+                if (result->type != obj::ObjectType::Error)
+                    fillValues(values, argument.n, [&argument](size_t i)
+                               { return complex_fn(argument.complex[i]); });
+                return result;
+            }
+        }
+
+        if (!argument.isArray)
+            return std::make_shared<obj::Double>(double_fn(*argument.real));
+
+        double *values = nullptr;
+        auto result = resultArray(out, argument.n, values);
+        if (result->type == obj::ObjectType::Error)
+            return result;
+        if constexpr (array_kernel != nullptr)
+            array_kernel(argument.real, values, argument.n);
+        else
+            fillValues(values, argument.n, [&argument](size_t i)
+                       { return double_fn(argument.real[i]); });
+        return result;
     }
+
+    double complexAbs(const std::complex<double> &z) { return std::abs(z); }
+    std::complex<double> complexAcos(const std::complex<double> &z) { return std::acos(z); }
+    std::complex<double> complexAsin(const std::complex<double> &z) { return std::asin(z); }
+    std::complex<double> complexAtan(const std::complex<double> &z) { return std::atan(z); }
+    std::complex<double> complexCos(const std::complex<double> &z) { return std::cos(z); }
+    std::complex<double> complexExp(const std::complex<double> &z) { return std::exp(z); }
+    std::complex<double> complexLog(const std::complex<double> &z) { return std::log(z); }
+    std::complex<double> complexLog10(const std::complex<double> &z) { return std::log10(z); }
+    std::complex<double> complexSin(const std::complex<double> &z) { return std::sin(z); }
+    std::complex<double> complexSqrt(const std::complex<double> &z) { return std::sqrt(z); }
+    std::complex<double> complexTan(const std::complex<double> &z) { return std::tan(z); }
 }
 
 namespace builtin
@@ -43,61 +233,86 @@ namespace builtin
         if (!arguments)
             return NullObject;
 
-        if (arguments->size() != 2)
-            return std::make_shared<obj::Error>("expected 2 argument", obj::ErrorType::TypeError);
+        if (arguments->size() != 2 && arguments->size() != 3)
+            return std::make_shared<obj::Error>("expected 2 or 3 arguments", obj::ErrorType::TypeError);
 
-        auto evaluatedExpr = evalExpression(arguments->at(0).get(), environment);
-        auto errorObj = dynamic_cast<obj::Error *>(evaluatedExpr.get());
+        MathArgument base, exponent;
+        auto errorObj = mathArgument(evalExpression(arguments->at(0).get(), environment), base);
+        if (errorObj)
+            return errorObj;
+        errorObj = mathArgument(evalExpression(arguments->at(1).get(), environment), exponent);
         if (errorObj)
-            return evaluatedExpr;
+            return errorObj;
 
-        auto doubleObj = dynamic_cast<obj::Double *>(evaluatedExpr.get());
-        if (!doubleObj)
-            return std::make_shared<obj::Error>(obj::Error("Invalid type for function, expected double, got: " + obj::toString(evaluatedExpr->type), obj::ErrorType::TypeError));
+        auto out = outArgument(arguments, 2, environment);
+        if (out && out->type == obj::ObjectType::Error)
+            return out;
 
-        auto evaluatedSecondExpr = evalExpression(arguments->at(1).get(), environment);
-        auto errorObjSecond = dynamic_cast<obj::Error *>(evaluatedSecondExpr.get());
-        if (errorObjSecond)
-            return evaluatedSecondExpr;
+        // a number is combined with each element of an array
+        const bool isArray = base.isArray || exponent.isArray;
+        if (base.isArray && exponent.isArray && base.n != exponent.n)
+            return std::make_shared<obj::Error>("Invalid arguments for pow, expected arrays of equal length, got " + std::to_string(base.n) + " and " + std::to_string(exponent.n), obj::ErrorType::ValueError);
+        if (out && !isArray)
+            return std::make_shared<obj::Error>("Invalid out, only used for an array argument", obj::ErrorType::TypeError);
+        const size_t n = base.isArray ? base.n : exponent.n;
 
-        auto doubleSecondObj = dynamic_cast<obj::Double *>(evaluatedSecondExpr.get());
-        if (!doubleSecondObj)
-            return std::make_shared<obj::Error>(obj::Error("Invalid type for function, expected double, got: " + obj::toString(evaluatedSecondExpr->type), obj::ErrorType::TypeError));
+        if (base.isComplex || exponent.isComplex)
+        {
+            if (!isArray)
+                return std::make_shared<obj::Complex>(std::pow(base.complexAt(0), exponent.complexAt(0)));
 
-        return std::make_shared<obj::Double>(pow(doubleObj->value, doubleSecondObj->value));
+            std::complex<double> *values = nullptr;
+            auto result = resultArray(out, n, values);
+            if (result->type != obj::ObjectType::Error)
+                fillValues(values, n, [&base, &exponent](size_t i)
+                           { return std::pow(base.complexAt(i), exponent.complexAt(i)); });
+            return result;
+        }
+
+        if (!isArray)
+            return std::make_shared<obj::Double>(pow(base.realAt(0), exponent.realAt(0)));
+
+        double *values = nullptr;
+        auto result = resultArray(out, n, values);
+        if (result->type != obj::ObjectType::Error)
+            fillValues(values, n, [&base, &exponent](size_t i)
+                       { return pow(base.realAt(i), exponent.realAt(i)); });
+        return result;
     }
 
-    template <TBuiltinDoubleFunction double_fn>
+    template <TBuiltinDoubleFunction double_fn, typename TComplexResult = std::complex<double>, TComplexResult (*complex_fn)(const std::complex<double> &) = nullptr, TBuiltinArrayKernel array_kernel = nullptr>
     std::shared_ptr<obj::Object> makeBuiltInDoubleFunctionObj()
     {
         auto func = std::make_shared<obj::Builtin>();
-        func->function = &r_double_double_function<double_fn>;
-        func->declaredType = typing::makeFunctionType("double", "double");
+        func->function = &r_double_double_function<double_fn, TComplexResult, complex_fn, array_kernel>;
+        func->declaredType = typing::makeFunctionType("all, all", "all");
         return func;
     }
 
     std::shared_ptr<obj::Module> createMathModule()
     {
+        typedef std::complex<double> TComplex;
+
         auto mathModule = std::make_shared<obj::Module>();
-        mathModule->environment->add("abs", builtin::makeBuiltInDoubleFunctionObj<fabs>(), false, nullptr);
-        mathModule->environment->add("acos", builtin::makeBuiltInDoubleFunctionObj<acos>(), false, nullptr);
-        mathModule->environment->add("asin", builtin::makeBuiltInDoubleFunctionObj<asin>(), false, nullptr);
-        mathModule->environment->add("atan", builtin::makeBuiltInDoubleFunctionObj<atan>(), false, nullptr);
+        mathModule->environment->add("abs", builtin::makeBuiltInDoubleFunctionObj<fabs, double, complexAbs, simd::abs>(), false, nullptr);
+        mathModule->environment->add("acos", builtin::makeBuiltInDoubleFunctionObj<acos, TComplex, complexAcos>(), false, nullptr);
+        mathModule->environment->add("asin", builtin::makeBuiltInDoubleFunctionObj<asin, TComplex, complexAsin>(), false, nullptr);
+        mathModule->environment->add("atan", builtin::makeBuiltInDoubleFunctionObj<atan, TComplex, complexAtan>(), false, nullptr);
         mathModule->environment->add("cbrt", builtin::makeBuiltInDoubleFunctionObj<cbrt>(), false, nullptr);
-        mathModule->environment->add("cos", builtin::makeBuiltInDoubleFunctionObj<cos>(), false, nullptr);
+        mathModule->environment->add("cos", builtin::makeBuiltInDoubleFunctionObj<cos, TComplex, complexCos>(), false, nullptr);
         mathModule->environment->add("erf", builtin::makeBuiltInDoubleFunctionObj<erf>(), false, nullptr);
         mathModule->environment->add("erfc", builtin::makeBuiltInDoubleFunctionObj<erfc>(), false, nullptr);
-        mathModule->environment->add("exp", builtin::makeBuiltInDoubleFunctionObj<exp>(), false, nullptr);
+        mathModule->environment->add("exp", builtin::makeBuiltInDoubleFunctionObj<exp, TComplex, complexExp>(), false, nullptr);
         mathModule->environment->add("lgamma", builtin::makeBuiltInDoubleFunctionObj<lgamma>(), false, nullptr);
-        mathModule->environment->add("log", builtin::makeBuiltInDoubleFunctionObj<log>(), false, nullptr);
-        mathModule->environment->add("log10", builtin::makeBuiltInDoubleFunctionObj<log10>(), false, nullptr);
+        mathModule->environment->add("log", builtin::makeBuiltInDoubleFunctionObj<log, TComplex, complexLog>(), false, nullptr);
+        mathModule->environment->add("log10", builtin::makeBuiltInDoubleFunctionObj<log10, TComplex, complexLog10>(), false, nullptr);
         mathModule->environment->add("round", builtin::makeBuiltInDoubleFunctionObj<round>(), false, nullptr);
-        mathModule->environment->add("sin", builtin::makeBuiltInDoubleFunctionObj<sin>(), false, nullptr);
-        mathModule->environment->add("sqrt", builtin::makeBuiltInDoubleFunctionObj<sqrt>(), false, nullptr);
-        mathModule->environment->add("tan", builtin::makeBuiltInDoubleFunctionObj<tan>(), false, nullptr);
+        mathModule->environment->add("sin", builtin::makeBuiltInDoubleFunctionObj<sin, TComplex, complexSin>(), false, nullptr);
+        mathModule->environment->add("sqrt", builtin::makeBuiltInDoubleFunctionObj<sqrt, TComplex, complexSqrt, simd::sqrt>(), false, nullptr);
+        mathModule->environment->add("tan", builtin::makeBuiltInDoubleFunctionObj<tan, TComplex, complexTan>(), false, nullptr);
         mathModule->environment->add("tgamma", builtin::makeBuiltInDoubleFunctionObj<tgamma>(), false, nullptr);
         mathModule->environment->add("trunc", builtin::makeBuiltInDoubleFunctionObj<trunc>(), false, nullptr);
-        mathModule->environment->add("pow", builtin::makeBuiltInFunctionObj(&builtin::pow_function, "double, double", "double"), false, nullptr);
+        mathModule->environment->add("pow", builtin::makeBuiltInFunctionObj(&builtin::pow_function, "all, all, all", "all"), false, nullptr);
         mathModule->state = obj::ModuleState::Loaded;
         return mathModule;
     }
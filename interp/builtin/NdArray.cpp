@@ -0,0 +1,803 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "NdArray.h"
+#include "../Evaluator.h"
+#include "../Scheduler.h"
+#include "../Simd.h"
+#include "../Typing.h"
+#include "../Util.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    std::vector<size_t> contiguousStrides(const std::vector<size_t> &shape)
+    {
+        std::vector<size_t> strides(shape.size(), 1);
+        for (size_t d = shape.size(); d > 1; --d)
+            strides[d - 2] = strides[d - 1] * shape[d - 1];
+        return strides;
+    }
+
+    size_t productOf(std::vector<size_t>::const_iterator begin, std::vector<size_t>::const_iterator end)
+    {
+        size_t product = 1;
+        for (auto it = begin; it != end; ++it)
+            product *= *it;
+        return product;
+    }
+
+    std::string shapeToString(const std::vector<size_t> &shape)
+    {
+        std::vector<std::string> dimensions;
+        for (const auto &dimension : shape)
+            dimensions.push_back(std::to_string(dimension));
+        return "(" + util::join(dimensions, ", ") + ")";
+    }
+
+    /* calls visit(positions) for each row, the elements along the last dimension, of an array of the
+     * given shape in row-major order; positions holds the position of the first element of the row for
+     * each of the N operands, which are read with their own strides
+     */
+    template <size_t N, typename TVisit>
+    void forEachRow(const std::vector<size_t> &shape, std::array<size_t, N> positions, const std::array<const std::vector<size_t> *, N> &strides, TVisit visit)
+    {
+        if (std::find(shape.begin(), shape.end(), 0) != shape.end())
+            return;
+
+        const size_t ndim = shape.size();
+        std::vector<size_t> index(ndim, 0);
+        for (;;)
+        {
+            visit(positions);
+
+            // advance the dimensions before the last one like an odometer
+            size_t d = ndim - 1;
+            for (;;)
+            {
+                if (d == 0)
+                    return;
+                --d;
+                if (++index[d] < shape[d])
+                {
+                    for (size_t k = 0; k < N; ++k)
+                        positions[k] += (*strides[k])[d];
+                    break;
+                }
+                for (size_t k = 0; k < N; ++k)
+                    positions[k] -= (shape[d] - 1) * (*strides[k])[d];
+                index[d] = 0;
+            }
+        }
+    }
+
+    /* the shape of broadcasting a and b: the shapes are aligned at their last dimension and a dimension
+     * of 1, or a missing one, is stretched to the dimension of the other shape
+     */
+    bool broadcastShape(const std::vector<size_t> &a, const std::vector<size_t> &b, std::vector<size_t> &result)
+    {
+        const size_t ndim = std::max(a.size(), b.size());
+        result.assign(ndim, 1);
+        for (size_t d = 0; d < ndim; ++d)
+        {
+            const size_t da = d < ndim - a.size() ? 1 : a[d - (ndim - a.size())];
+            const size_t db = d < ndim - b.size() ? 1 : b[d - (ndim - b.size())];
+            if (da != db && da != 1 && db != 1)
+                return false;
+            result[d] = da == 1 ? db : da;
+        }
+        return true;
+    }
+
+    /* strides to read array as if it had the broadcast shape, 0 along the stretched dimensions */
+    std::vector<size_t> broadcastStrides(const obj::NdArray &array, const std::vector<size_t> &shape)
+    {
+        std::vector<size_t> strides(shape.size(), 0);
+        const size_t skip = shape.size() - array.shape.size();
+        for (size_t d = 0; d < array.shape.size(); ++d)
+        {
+            if (array.shape[d] != 1)
+                strides[skip + d] = array.strides[d];
+        }
+        return strides;
+    }
+
+    bool toOperation(TokenType operator_t, simd::Operation &operation)
+    {
+        switch (operator_t)
+        {
+        case TokenType::PLUS:
+        case TokenType::PLUSASSIGN:
+            operation = simd::Operation::Add;
+            return true;
+        case TokenType::MINUS:
+        case TokenType::MINUSASSIGN:
+            operation = simd::Operation::Subtract;
+            return true;
+        case TokenType::ASTERISK:
+        case TokenType::ASTERISKASSIGN:
+            operation = simd::Operation::Multiply;
+            return true;
+        case TokenType::SLASH:
+        case TokenType::SLASHASSIGN:
+            operation = simd::Operation::Divide;
+            return true;
+        }
+        return false;
+    }
+
+    double applyOperation(simd::Operation operation, double lhs, double rhs)
+    {
+        switch (operation)
+        {
+        case simd::Operation::Add:
+            return lhs + rhs;
+        case simd::Operation::Subtract:
+            return lhs - rhs;
+        case simd::Operation::Multiply:
+            return lhs * rhs;
+        case simd::Operation::Divide:
+            return lhs / rhs;
+        }
+        return 0.0;
+    }
+
+    /* the operand as an ndarray, array_double and array_int are one-dimensional and a number has shape (1,)
+     * so that it is stretched to any shape; nullptr when the operand does not qualify
+     */
+    const obj::NdArray *asNdArray(const obj::Object *operand, std::unique_ptr<obj::NdArray> &converted)
+    {
+        switch (operand->type)
+        {
+        case obj::ObjectType::NdArray:
+            return static_cast<const obj::NdArray *>(operand);
+        case obj::ObjectType::ArrayDouble:
+        {
+            auto values = static_cast<const obj::ArrayDouble *>(operand)->value;
+            const size_t n = values.size();
+            converted = std::make_unique<obj::NdArray>(std::move(values), std::vector<size_t>{n});
+            return converted.get();
+        }
+        case obj::ObjectType::ArrayInt:
+        {
+            const auto &elements = static_cast<const obj::ArrayInt *>(operand)->value;
+            converted = std::make_unique<obj::NdArray>(std::vector<double>(elements.begin(), elements.end()), std::vector<size_t>{elements.size()});
+            return converted.get();
+        }
+        case obj::ObjectType::Double:
+            converted = std::make_unique<obj::NdArray>(std::vector<double>{static_cast<const obj::Double *>(operand)->value}, std::vector<size_t>{1});
+            return converted.get();
+        case obj::ObjectType::Integer:
+            converted = std::make_unique<obj::NdArray>(std::vector<double>{static_cast<double>(static_cast<const obj::Integer *>(operand)->value)}, std::vector<size_t>{1});
+            return converted.get();
+        }
+        return nullptr;
+    }
+
+    /* the values of left op right for the broadcast shape, in row-major order; rows with contiguous or
+     * stretched operands run on the SIMD kernels
+     */
+    std::vector<double> elementwise(simd::Operation operation, const obj::NdArray &left, const obj::NdArray &right, const std::vector<size_t> &shape)
+    {
+        std::vector<double> result(productOf(shape.begin(), shape.end()));
+        const double *lhs = left.data->value.data();
+        const double *rhs = right.data->value.data();
+        double *out = result.data();
+
+        if (left.shape == right.shape && left.isContiguous() && right.isContiguous())
+        {
+            simd::apply(operation, lhs + left.offset, rhs + right.offset, out, result.size());
+            return result;
+        }
+
+        const auto leftStrides = broadcastStrides(left, shape);
+        const auto rightStrides = broadcastStrides(right, shape);
+        const auto outStrides = contiguousStrides(shape);
+        const size_t inner = shape.back();
+        const size_t ls = leftStrides.back();
+        const size_t rs = rightStrides.back();
+        forEachRow<3>(shape, {left.offset, right.offset, 0}, {&leftStrides, &rightStrides, &outStrides}, [&](const std::array<size_t, 3> &p)
+                      {
+                          if (ls == 1 && rs == 1)
+                              simd::apply(operation, lhs + p[0], rhs + p[1], out + p[2], inner);
+                          else if (ls == 1 && rs == 0)
+                              simd::apply(operation, lhs + p[0], rhs[p[1]], out + p[2], inner);
+                          else if (ls == 0 && rs == 1)
+                              simd::apply(operation, lhs[p[0]], rhs + p[1], out + p[2], inner);
+                          else
+                          {
+                              for (size_t i = 0; i < inner; ++i)
+                                  out[p[2] + i] = applyOperation(operation, lhs[p[0] + i * ls], rhs[p[1] + i * rs]);
+                          } });
+        return result;
+    }
+
+    obj::NdArray transposed(const obj::NdArray &array)
+    {
+        std::vector<size_t> shape(array.shape.rbegin(), array.shape.rend());
+        std::vector<size_t> strides(array.strides.rbegin(), array.strides.rend());
+        return obj::NdArray(array.data, array.offset, shape, strides);
+    }
+
+    const size_t blockRows = 32;
+    const size_t blockDepth = 256;
+
+    /* c (m x n) += a (m x k) times the transpose of bt (n x k), both a and bt are row-major so every
+     * element of c is a dot product of two contiguous rows.  The rows are combined in blocks of blockRows
+     * rows of a and of bt over blockDepth columns, so that both blocks stay in cache while they are
+     * combined; the blocks of rows of c are spread over the shared pool
+     */
+    void multiplyBlocked(const double *a, const double *bt, double *c, size_t m, size_t n, size_t k)
+    {
+        const size_t nrRowBlocks = (m + blockRows - 1) / blockRows;
+        // small products are not worth handing out to other threads
+        const size_t minChunk = m * n * k < (static_cast<size_t>(1) << 18) ? nrRowBlocks : 1;
+        scheduler::parallelFor(nrRowBlocks, minChunk, [a, bt, c, m, n, k](size_t beginBlock, size_t endBlock)
+                               {
+                                   const size_t endRow = std::min(m, endBlock * blockRows);
+                                   for (size_t ib = beginBlock * blockRows; ib < endRow; ib += blockRows)
+                                   {
+                                       const size_t ie = std::min(endRow, ib + blockRows);
+                                       for (size_t jb = 0; jb < n; jb += blockRows)
+                                       {
+                                           const size_t je = std::min(n, jb + blockRows);
+                                           for (size_t kb = 0; kb < k; kb += blockDepth)
+                                           {
+                                               const size_t kl = std::min(blockDepth, k - kb);
+                                               for (size_t i = ib; i < ie; ++i)
+                                                   for (size_t j = jb; j < je; ++j)
+                                                       c[i * n + j] += simd::dot(a + i * k + kb, bt + j * k + kb, kl);
+                                           }
+                                       }
+                                   } });
+    }
+
+    std::shared_ptr<obj::Object> matmul(const obj::NdArray &left, const obj::NdArray &right)
+    {
+        if (left.shape.size() > 2 || right.shape.size() > 2)
+            return obj::makeTypeError("matmul: expected one- or two-dimensional arrays, got shapes " + shapeToString(left.shape) + " and " + shapeToString(right.shape));
+
+        // a one-dimensional left operand is a row, a one-dimensional right operand a column
+        const size_t m = left.shape.size() == 2 ? left.shape[0] : 1;
+        const size_t k = left.shape.back();
+        const size_t n = right.shape.size() == 2 ? right.shape[1] : 1;
+        if (right.shape[0] != k)
+            return std::make_shared<obj::Error>("matmul: shapes " + shapeToString(left.shape) + " and " + shapeToString(right.shape) + " do not align", obj::ErrorType::ValueError);
+
+        const auto a = left.values();
+        const auto bt = right.shape.size() == 2 ? transposed(right).values() : right.values();
+        std::vector<double> c(m * n, 0.0);
+        multiplyBlocked(a.data(), bt.data(), c.data(), m, n, k);
+
+        if (left.shape.size() == 2 && right.shape.size() == 2)
+            return std::make_shared<obj::NdArray>(std::move(c), std::vector<size_t>{m, n});
+        if (left.shape.size() == 2)
+            return std::make_shared<obj::NdArray>(std::move(c), std::vector<size_t>{m});
+        if (right.shape.size() == 2)
+            return std::make_shared<obj::NdArray>(std::move(c), std::vector<size_t>{n});
+        return std::make_shared<obj::Double>(c.front());
+    }
+
+    enum class Reduction
+    {
+        Sum,
+        Mean,
+        Min,
+        Max,
+    };
+
+    double reduceContiguous(Reduction reduction, const double *values, size_t n)
+    {
+        switch (reduction)
+        {
+        case Reduction::Sum:
+            return simd::sum(values, n);
+        case Reduction::Mean:
+            return simd::sum(values, n) / static_cast<double>(n);
+        default:
+            double minimum, maximum;
+            simd::minMax(values, n, minimum, maximum);
+            return reduction == Reduction::Min ? minimum : maximum;
+        }
+    }
+
+    /* reduction over all elements, or along one axis which removes that dimension from the shape; the
+     * slices along the axis are combined row by row so that the inner loops stay contiguous
+     */
+    std::shared_ptr<obj::Object> reduce(const obj::NdArray &array, Reduction reduction, const std::string &errorPrefix, bool hasAxis, size_t axis)
+    {
+        const auto values = array.values();
+        const size_t length = hasAxis ? array.shape[axis] : values.size();
+        if (length == 0 && (reduction == Reduction::Min || reduction == Reduction::Max))
+            return std::make_shared<obj::Error>(errorPrefix + ": expected a non-empty array", obj::ErrorType::ValueError);
+
+        if (!hasAxis)
+            return std::make_shared<obj::Double>(reduceContiguous(reduction, values.data(), values.size()));
+
+        const size_t outer = productOf(array.shape.begin(), array.shape.begin() + axis);
+        const size_t inner = productOf(array.shape.begin() + axis + 1, array.shape.end());
+        std::vector<double> result(outer * inner, 0.0);
+        for (size_t o = 0; o < outer; ++o)
+        {
+            const double *slices = values.data() + o * length * inner;
+            double *row = result.data() + o * inner;
+            if (inner == 1)
+            {
+                if (length > 0)
+                    *row = reduceContiguous(reduction, slices, length);
+                continue;
+            }
+            if (length == 0)
+                continue;
+
+            std::copy(slices, slices + inner, row);
+            for (size_t l = 1; l < length; ++l)
+            {
+                const double *slice = slices + l * inner;
+                if (reduction == Reduction::Sum || reduction == Reduction::Mean)
+                    simd::apply(simd::Operation::Add, row, slice, row, inner);
+                else if (reduction == Reduction::Min)
+                    std::transform(row, row + inner, slice, row, [](double x, double y)
+                                   { return std::min(x, y); });
+                else
+                    std::transform(row, row + inner, slice, row, [](double x, double y)
+                                   { return std::max(x, y); });
+            }
+        }
+        if (reduction == Reduction::Mean && inner > 1)
+            simd::apply(simd::Operation::Divide, result.data(), static_cast<double>(length), result.data(), result.size());
+        if (reduction == Reduction::Mean && length == 0)
+            std::fill(result.begin(), result.end(), std::numeric_limits<double>::quiet_NaN());
+
+        std::vector<size_t> shape = array.shape;
+        shape.erase(shape.begin() + axis);
+        if (shape.empty())
+            return std::make_shared<obj::Double>(result.front());
+        return std::make_shared<obj::NdArray>(std::move(result), shape);
+    }
+
+    /* the elements and the shape of a nested array of numbers */
+    struct Nesting
+    {
+        std::vector<size_t> shape;
+        std::vector<double> values;
+        size_t leafDepth = 0; /*< the depth of the numbers, 0 while no number is seen */
+    };
+
+    bool addNumber(Nesting &nesting, size_t depth, double value)
+    {
+        if (nesting.leafDepth == 0)
+            nesting.leafDepth = depth;
+        if (nesting.leafDepth != depth)
+            return false;
+        nesting.values.push_back(value);
+        return true;
+    }
+
+    bool enterArray(Nesting &nesting, size_t depth, size_t length)
+    {
+        if (nesting.shape.size() == depth)
+            nesting.shape.push_back(length);
+        return nesting.shape[depth] == length;
+    }
+
+    bool flatten(const obj::Object *obj, size_t depth, Nesting &nesting)
+    {
+        switch (obj->type)
+        {
+        case obj::ObjectType::Integer:
+            return depth > 0 && addNumber(nesting, depth, static_cast<double>(static_cast<const obj::Integer *>(obj)->value));
+        case obj::ObjectType::Double:
+            return depth > 0 && addNumber(nesting, depth, static_cast<const obj::Double *>(obj)->value);
+        case obj::ObjectType::ArrayInt:
+        {
+            const auto &elements = static_cast<const obj::ArrayInt *>(obj)->value;
+            if (!enterArray(nesting, depth, elements.size()))
+                return false;
+            for (const auto &element : elements)
+                if (!addNumber(nesting, depth + 1, static_cast<double>(element)))
+                    return false;
+            return true;
+        }
+        case obj::ObjectType::ArrayDouble:
+        {
+            const auto &elements = static_cast<const obj::ArrayDouble *>(obj)->value;
+            if (!enterArray(nesting, depth, elements.size()))
+                return false;
+            for (const auto &element : elements)
+                if (!addNumber(nesting, depth + 1, element))
+                    return false;
+            return true;
+        }
+        case obj::ObjectType::ArrayView:
+            return flatten(obj->clone().get(), depth, nesting);
+        case obj::ObjectType::NdArray:
+        {
+            auto array = static_cast<const obj::NdArray *>(obj);
+            if (!enterArray(nesting, depth, array->shape.front()))
+                return false;
+            for (size_t i = 0; i < array->shape.front(); ++i)
+                if (!flatten(array->at(i).get(), depth + 1, nesting))
+                    return false;
+            return true;
+        }
+        case obj::ObjectType::Array:
+        {
+            const auto &elements = static_cast<const obj::Array *>(obj)->value;
+            if (!enterArray(nesting, depth, elements.size()))
+                return false;
+            for (const auto &element : elements)
+                if (!flatten(element.get(), depth + 1, nesting))
+                    return false;
+            return true;
+        }
+        }
+        return false;
+    }
+
+    std::shared_ptr<obj::Object> shapeArgument(const std::shared_ptr<obj::Object> &obj, const std::string &errorPrefix, std::vector<size_t> &shape)
+    {
+        if (obj->type == obj::ObjectType::Error)
+            return obj;
+
+        std::vector<int64_t> dimensions;
+        if (obj->type == obj::ObjectType::ArrayInt)
+            dimensions = static_cast<obj::ArrayInt *>(obj.get())->value;
+        else if (obj->type == obj::ObjectType::Array)
+        {
+            for (const auto &element : static_cast<obj::Array *>(obj.get())->value)
+            {
+                if (element->type != obj::ObjectType::Integer)
+                    return obj::makeTypeError(errorPrefix + ": expected the shape to be an array of int");
+                dimensions.push_back(static_cast<obj::Integer *>(element.get())->value);
+            }
+        }
+        else
+            return obj::makeTypeError(errorPrefix + ": expected the shape to be an array of int, got " + obj::toString(obj->type));
+
+        if (dimensions.empty())
+            return std::make_shared<obj::Error>(errorPrefix + ": expected a shape with at least one dimension", obj::ErrorType::ValueError);
+        shape.clear();
+        for (const auto &dimension : dimensions)
+        {
+            if (dimension < 0)
+                return std::make_shared<obj::Error>(errorPrefix + ": expected non-negative dimensions", obj::ErrorType::ValueError);
+            shape.push_back(static_cast<size_t>(dimension));
+        }
+        return nullptr;
+    }
+
+    /* the axis argument of a reduction, a negative axis counts from the last dimension */
+    std::shared_ptr<obj::Object> axisArgument(const obj::NdArray &array, const std::vector<std::shared_ptr<obj::Object>> &arguments, const std::string &errorPrefix, bool &hasAxis, size_t &axis)
+    {
+        hasAxis = false;
+        if (arguments.empty())
+            return nullptr;
+        if (arguments.size() > 1)
+            return obj::makeTypeError(errorPrefix + ": expected at most 1 argument");
+        RETURN_TYPE_ERROR_ON_MISMATCH(arguments.front(), Integer, errorPrefix + ": expected the axis to be an int");
+
+        const int64_t ndim = static_cast<int64_t>(array.shape.size());
+        int64_t value = static_cast<obj::Integer *>(arguments.front().get())->value;
+        if (value < 0)
+            value += ndim;
+        if (value < 0 || value >= ndim)
+            return std::make_shared<obj::Error>(errorPrefix + ": axis " + arguments.front()->inspect() + " out of range for shape " + shapeToString(array.shape), obj::ErrorType::IndexError);
+        hasAxis = true;
+        axis = static_cast<size_t>(value);
+        return nullptr;
+    }
+}
+
+namespace obj
+{
+    size_t NdArray::size() const
+    {
+        return productOf(shape.begin(), shape.end());
+    }
+
+    bool NdArray::isContiguous() const
+    {
+        return strides == contiguousStrides(shape);
+    }
+
+    std::vector<double> NdArray::values() const
+    {
+        const auto &elements = data->value;
+        if (isContiguous())
+            return std::vector<double>(elements.begin() + offset, elements.begin() + offset + size());
+
+        std::vector<double> result;
+        result.reserve(size());
+        const size_t inner = shape.back();
+        const size_t innerStride = strides.back();
+        forEachRow<1>(shape, {offset}, {&strides}, [&](const std::array<size_t, 1> &p)
+                      {
+                          for (size_t i = 0; i < inner; ++i)
+                              result.push_back(elements[p[0] + i * innerStride]); });
+        return result;
+    }
+
+    std::shared_ptr<Object> NdArray::at(size_t index) const
+    {
+        const size_t position = offset + index * strides.front();
+        if (shape.size() == 1)
+            return std::make_shared<Double>(data->value[position]);
+
+        auto row = std::make_shared<NdArray>(data, position, std::vector<size_t>(shape.begin() + 1, shape.end()), std::vector<size_t>(strides.begin() + 1, strides.end()));
+        // a row of a frozen array cannot be used to update its elements either
+        if (frozen > 0)
+            ++row->frozen;
+        return row;
+    }
+
+    std::string NdArray::inspect() const
+    {
+        const auto elements = values();
+        const auto rowStrides = contiguousStrides(shape);
+        std::stringstream ss;
+        for (size_t i = 0; i < elements.size(); ++i)
+        {
+            // open a bracket for every dimension that starts at this element and close the ones that end before it
+            for (size_t d = 0; d < shape.size(); ++d)
+                if (i % (rowStrides[d] * shape[d]) == 0)
+                    ss << "[";
+            ss << std::to_string(elements[i]);
+            for (size_t d = 0; d < shape.size(); ++d)
+                if ((i + 1) % (rowStrides[d] * shape[d]) == 0)
+                    ss << "]";
+            if (i + 1 < elements.size())
+                ss << ", ";
+        }
+        if (elements.empty())
+            ss << "[]";
+        return ss.str();
+    }
+
+    std::shared_ptr<Object> NdArray::clone() const
+    {
+        return std::make_shared<NdArray>(values(), shape);
+    }
+
+    bool NdArray::eq(const Object *other) const
+    {
+        if (other->type != ObjectType::NdArray)
+            return false;
+        auto otherArray = static_cast<const NdArray *>(other);
+        return otherArray->shape == shape && otherArray->values() == values();
+    }
+
+    NdArray::NdArray(std::vector<double> &&ivalues, const std::vector<size_t> &ishape) : Object(ObjectType::NdArray), data(std::make_shared<ArrayDouble>(std::move(ivalues))), offset(0), shape(ishape), strides(contiguousStrides(ishape)){};
+    NdArray::NdArray(std::shared_ptr<ArrayDouble> idata, size_t ioffset, const std::vector<size_t> &ishape, const std::vector<size_t> &istrides) : Object(ObjectType::NdArray), data(idata), offset(ioffset), shape(ishape), strides(istrides){};
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> ndarray(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1 && arguments->size() != 2)
+            return obj::makeTypeError("ndarray: expected 1 or 2 arguments");
+
+        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        if (evaluatedExpr->type == obj::ObjectType::Error)
+            return evaluatedExpr;
+
+        std::vector<size_t> shape;
+        if (arguments->size() == 2)
+        {
+            auto errorObj = shapeArgument(evalExpression(arguments->at(1).get(), environment), "ndarray", shape);
+            if (errorObj)
+                return errorObj;
+        }
+
+        // a number fills an array of the given shape
+        if (evaluatedExpr->type == obj::ObjectType::Integer || evaluatedExpr->type == obj::ObjectType::Double)
+        {
+            if (shape.empty())
+                return obj::makeTypeError("ndarray: expected a shape to fill with a number");
+            const double value = evaluatedExpr->type == obj::ObjectType::Integer ? static_cast<double>(static_cast<obj::Integer *>(evaluatedExpr.get())->value) : static_cast<obj::Double *>(evaluatedExpr.get())->value;
+            return std::make_shared<obj::NdArray>(std::vector<double>(productOf(shape.begin(), shape.end()), value), shape);
+        }
+
+        Nesting nesting;
+        if (!flatten(evaluatedExpr.get(), 0, nesting) || (nesting.leafDepth != 0 && nesting.leafDepth != nesting.shape.size()))
+            return std::make_shared<obj::Error>("ndarray: expected numbers or arrays of numbers of equal length, got " + obj::toString(evaluatedExpr->type), obj::ErrorType::ValueError);
+
+        if (shape.empty())
+            shape = nesting.shape;
+        else if (productOf(shape.begin(), shape.end()) != nesting.values.size())
+            return std::make_shared<obj::Error>("ndarray: cannot shape " + std::to_string(nesting.values.size()) + " values as " + shapeToString(shape), obj::ErrorType::ValueError);
+        return std::make_shared<obj::NdArray>(std::move(nesting.values), shape);
+    }
+
+    obj::Object *evalNdArrayInfixOperator(TokenType operator_t, obj::Object *left, obj::Object *right)
+    {
+        std::unique_ptr<obj::NdArray> leftConverted, rightConverted;
+        auto leftArray = asNdArray(left, leftConverted);
+        auto rightArray = asNdArray(right, rightConverted);
+        if (!leftArray || !rightArray)
+            return nullptr;
+
+        if (operator_t == TokenType::EQ || operator_t == TokenType::N_EQ)
+        {
+            const bool equal = leftArray->shape == rightArray->shape && leftArray->values() == rightArray->values();
+            return new obj::Boolean(operator_t == TokenType::EQ ? equal : !equal);
+        }
+
+        simd::Operation operation;
+        if (!toOperation(operator_t, operation))
+            return nullptr;
+
+        std::vector<size_t> shape;
+        if (!broadcastShape(leftArray->shape, rightArray->shape, shape))
+            return new obj::Error("Cannot broadcast shapes " + shapeToString(leftArray->shape) + " and " + shapeToString(rightArray->shape) + " for " + toString(operator_t), obj::ErrorType::ValueError);
+        return new obj::NdArray(elementwise(operation, *leftArray, *rightArray, shape), shape);
+    }
+
+    bool evalOpNdArray(obj::NdArray *array, TokenType operator_t, const std::shared_ptr<obj::Object> &right)
+    {
+        simd::Operation operation;
+        if (!toOperation(operator_t, operation))
+            return false;
+
+        std::unique_ptr<obj::NdArray> rightConverted;
+        auto rightArray = asNdArray(right.get(), rightConverted);
+        std::vector<size_t> shape;
+        if (!rightArray || !broadcastShape(array->shape, rightArray->shape, shape) || shape != array->shape)
+            return false;
+
+        // computed completely before it is stored, the right operand may share the elements of array
+        const auto result = elementwise(operation, *array, *rightArray, shape);
+        auto &elements = array->data->value;
+        const size_t inner = shape.back();
+        const size_t innerStride = array->strides.back();
+        size_t index = 0;
+        forEachRow<1>(shape, {array->offset}, {&array->strides}, [&](const std::array<size_t, 1> &p)
+                      {
+                          for (size_t i = 0; i < inner; ++i)
+                              elements[p[0] + i * innerStride] = result[index++]; });
+        return true;
+    }
+
+    std::shared_ptr<obj::Object> ndarray_shape(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (!arguments.empty())
+            return obj::makeTypeError("shape: expected 0 arguments");
+
+        std::vector<int64_t> shape;
+        for (const auto &dimension : static_cast<obj::NdArray *>(self.get())->shape)
+            shape.push_back(static_cast<int64_t>(dimension));
+        return std::make_shared<obj::ArrayInt>(std::move(shape));
+    }
+
+    std::shared_ptr<obj::Object> ndarray_ndim(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (!arguments.empty())
+            return obj::makeTypeError("ndim: expected 0 arguments");
+        return std::make_shared<obj::Integer>(static_cast<int64_t>(static_cast<obj::NdArray *>(self.get())->shape.size()));
+    }
+
+    std::shared_ptr<obj::Object> ndarray_size(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (!arguments.empty())
+            return obj::makeTypeError("size: expected 0 arguments");
+        return std::make_shared<obj::Integer>(static_cast<int64_t>(static_cast<obj::NdArray *>(self.get())->size()));
+    }
+
+    std::shared_ptr<obj::Object> ndarray_transpose(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        /* the transpose reverses the dimensions and shares the elements */
+        if (!arguments.empty())
+            return obj::makeTypeError("transpose: expected 0 arguments");
+
+        auto array = static_cast<obj::NdArray *>(self.get());
+        auto result = std::make_shared<obj::NdArray>(transposed(*array));
+        if (array->frozen > 0)
+            ++result->frozen;
+        return result;
+    }
+
+    std::shared_ptr<obj::Object> ndarray_reshape(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (arguments.size() != 1)
+            return obj::makeTypeError("reshape: expected 1 argument");
+
+        auto array = static_cast<obj::NdArray *>(self.get());
+        std::vector<size_t> shape;
+        auto errorObj = shapeArgument(arguments.front(), "reshape", shape);
+        if (errorObj)
+            return errorObj;
+        if (productOf(shape.begin(), shape.end()) != array->size())
+            return std::make_shared<obj::Error>("reshape: cannot reshape " + shapeToString(array->shape) + " as " + shapeToString(shape), obj::ErrorType::ValueError);
+        return std::make_shared<obj::NdArray>(array->values(), shape);
+    }
+
+    std::shared_ptr<obj::Object> ndarray_matmul(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (arguments.size() != 1)
+            return obj::makeTypeError("matmul: expected 1 argument");
+
+        std::unique_ptr<obj::NdArray> converted;
+        auto right = arguments.front()->type == obj::ObjectType::Error ? nullptr : asNdArray(arguments.front().get(), converted);
+        if (arguments.front()->type == obj::ObjectType::Error)
+            return arguments.front();
+        if (!right || arguments.front()->type == obj::ObjectType::Integer || arguments.front()->type == obj::ObjectType::Double)
+            return obj::makeTypeError("matmul: expected an ndarray, an array_double or an array_int, got " + obj::toString(arguments.front()->type));
+        return matmul(*static_cast<obj::NdArray *>(self.get()), *right);
+    }
+
+    std::shared_ptr<obj::Object> reduceImpl(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments, Reduction reduction, const std::string &errorPrefix)
+    {
+        auto array = static_cast<obj::NdArray *>(self.get());
+        bool hasAxis = false;
+        size_t axis = 0;
+        auto errorObj = axisArgument(*array, arguments, errorPrefix, hasAxis, axis);
+        if (errorObj)
+            return errorObj;
+        return reduce(*array, reduction, errorPrefix, hasAxis, axis);
+    }
+
+    std::shared_ptr<obj::Object> ndarray_sum(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        return reduceImpl(self, arguments, Reduction::Sum, "sum");
+    }
+
+    std::shared_ptr<obj::Object> ndarray_mean(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        return reduceImpl(self, arguments, Reduction::Mean, "mean");
+    }
+
+    std::shared_ptr<obj::Object> ndarray_min(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        return reduceImpl(self, arguments, Reduction::Min, "min");
+    }
+
+    std::shared_ptr<obj::Object> ndarray_max(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        return reduceImpl(self, arguments, Reduction::Max, "max");
+    }
+
+    std::shared_ptr<obj::Object> ndarray_to_array(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (!arguments.empty())
+            return obj::makeTypeError("to_array: expected 0 arguments");
+        return std::make_shared<obj::ArrayDouble>(static_cast<obj::NdArray *>(self.get())->values());
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeNdArray()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto ndarrayBuiltinType = std::make_shared<obj::BuiltinType>();
+        ndarrayBuiltinType->builtinObjectType = obj::ObjectType::NdArray;
+
+        ndarrayBuiltinType->functions = {
+            {"shape", TBuiltInFD({&builtin::ndarray_shape, typing::makeFunctionType("", "[int]")})},          // "ndarray.fn() -> [int]"
+            {"ndim", TBuiltInFD({&builtin::ndarray_ndim, typing::makeFunctionType("", "int")})},              // "ndarray.fn() -> int"
+            {"size", TBuiltInFD({&builtin::ndarray_size, typing::makeFunctionType("", "int")})},              // "ndarray.fn() -> int"
+            {"transpose", TBuiltInFD({&builtin::ndarray_transpose, typing::makeFunctionType("", "ndarray")})}, // "ndarray.fn() -> ndarray"
+            {"reshape", TBuiltInFD({&builtin::ndarray_reshape, typing::makeFunctionType("[int]", "ndarray")})}, // "ndarray.fn([int]) -> ndarray"
+            {"matmul", TBuiltInFD({&builtin::ndarray_matmul, typing::makeFunctionType("all", "all")})},       // "ndarray.fn(all) -> all"
+            {"sum", TBuiltInFD({&builtin::ndarray_sum, typing::makeFunctionType("int", "all")})},             // "ndarray.fn(int) -> all"
+            {"mean", TBuiltInFD({&builtin::ndarray_mean, typing::makeFunctionType("int", "all")})},           // "ndarray.fn(int) -> all"
+            {"min", TBuiltInFD({&builtin::ndarray_min, typing::makeFunctionType("int", "all")})},             // "ndarray.fn(int) -> all"
+            {"max", TBuiltInFD({&builtin::ndarray_max, typing::makeFunctionType("int", "all")})},             // "ndarray.fn(int) -> all"
+            {"to_array", TBuiltInFD({&builtin::ndarray_to_array, typing::makeFunctionType("", "[double]")})}, // "ndarray.fn() -> [double]"
+        };
+
+        return ndarrayBuiltinType;
+    }
+}
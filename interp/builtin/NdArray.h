@@ -0,0 +1,30 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_BUILTIN_NDARRAY_H
+#define GUARDIAN_OF_INCLUSION_BUILTIN_NDARRAY_H
+
+#include "../Object.h"
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> ndarray(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
+
+    /* +, -, * and / elementwise with broadcasting and == and != with at least one ndarray operand, the
+     * other operand is an ndarray, an array_double, an array_int or a number.  Returns nullptr when the
+     * operator or the operands do not qualify
+     */
+    obj::Object *evalNdArrayInfixOperator(TokenType operator_t, obj::Object *left, obj::Object *right);
+
+    /* +=, -=, *= and /= on the elements of array, the right operand is broadcast to the shape of array */
+    bool evalOpNdArray(obj::NdArray *array, TokenType operator_t, const std::shared_ptr<obj::Object> &right);
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeNdArray();
+}
+
+#endif
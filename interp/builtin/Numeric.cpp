@@ -0,0 +1,718 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Numeric.h"
+#include "../Evaluator.h"
+#include "../Fft.h"
+#include "../Scheduler.h"
+#include "../Simd.h"
+#include "../Typing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    /* the values of an array_double are used in place, an array of ints and doubles is converted
+     * into buffer; owner keeps the array alive for as long as the values are used
+     */
+    struct NumericValues
+    {
+        std::shared_ptr<obj::Object> owner;
+        std::vector<double> buffer;
+        const double *values = nullptr;
+        size_t n = 0;
+    };
+
+    /* returns nullptr when the values are set, otherwise the error */
+    std::shared_ptr<obj::Object> numericValues(const std::shared_ptr<obj::Object> &obj, const std::string &errorPrefix, NumericValues &result)
+    {
+        if (obj->type == obj::ObjectType::Error)
+            return obj;
+
+        result.owner = obj;
+        if (obj->type == obj::ObjectType::ArrayDouble)
+        {
+            const auto &arrayValues = static_cast<obj::ArrayDouble *>(obj.get())->value;
+            result.values = arrayValues.data();
+            result.n = arrayValues.size();
+            return nullptr;
+        }
+
+        if (obj->type == obj::ObjectType::ArrayInt)
+        {
+            const auto &elements = static_cast<obj::ArrayInt *>(obj.get())->value;
+            result.buffer.assign(elements.begin(), elements.end());
+            result.values = result.buffer.data();
+            result.n = result.buffer.size();
+            return nullptr;
+        }
+
+        if (obj->type == obj::ObjectType::ArrayView)
+        {
+            // a contiguous view on an array_double is read in place, any other view through a copy
+            auto view = static_cast<obj::ArrayView *>(obj.get());
+            if (view->array->type == obj::ObjectType::ArrayDouble && view->stride == 1)
+            {
+                result.values = static_cast<obj::ArrayDouble *>(view->array.get())->value.data() + view->offset;
+                result.n = view->length;
+                return nullptr;
+            }
+            return numericValues(view->clone(), errorPrefix, result);
+        }
+
+        if (obj->type == obj::ObjectType::NdArray)
+        {
+            // the elements of an ndarray are read in row-major order, in place when they are contiguous
+            auto array = static_cast<obj::NdArray *>(obj.get());
+            if (array->isContiguous())
+                result.values = array->data->value.data() + array->offset;
+            else
+            {
+                result.buffer = array->values();
+                result.values = result.buffer.data();
+            }
+            result.n = array->size();
+            return nullptr;
+        }
+
+        if (obj->type == obj::ObjectType::Array)
+        {
+            const auto &elements = static_cast<obj::Array *>(obj.get())->value;
+            result.buffer.reserve(elements.size());
+            for (const auto &element : elements)
+            {
+                if (element->type == obj::ObjectType::Double)
+                    result.buffer.push_back(static_cast<obj::Double *>(element.get())->value);
+                else if (element->type == obj::ObjectType::Integer)
+                    result.buffer.push_back(static_cast<double>(static_cast<obj::Integer *>(element.get())->value));
+                else
+                    return obj::makeTypeError(errorPrefix + ": expected an array of int or double, found element of type " + obj::toString(element->type));
+            }
+            result.values = result.buffer.data();
+            result.n = result.buffer.size();
+            return nullptr;
+        }
+
+        return obj::makeTypeError(errorPrefix + ": expected argument to be an array_int, an array_double or an array of numbers, got " + obj::toString(obj->type));
+    }
+
+    /* the values of an array_complex are used in place, any other array of numbers is converted into buffer */
+    struct ComplexValues
+    {
+        std::shared_ptr<obj::Object> owner;
+        std::vector<std::complex<double>> buffer;
+        const std::complex<double> *values = nullptr;
+        size_t n = 0;
+    };
+
+    bool isComplexArray(const std::shared_ptr<obj::Object> &obj)
+    {
+        if (obj->type == obj::ObjectType::ArrayComplex)
+            return true;
+        if (obj->type == obj::ObjectType::ArrayView)
+            return isComplexArray(static_cast<obj::ArrayView *>(obj.get())->array);
+        if (obj->type == obj::ObjectType::Array)
+        {
+            const auto &elements = static_cast<obj::Array *>(obj.get())->value;
+            return std::any_of(elements.begin(), elements.end(), [](const std::shared_ptr<obj::Object> &element)
+                               { return element->type == obj::ObjectType::Complex; });
+        }
+        return false;
+    }
+
+    /* returns nullptr when the values are set, otherwise the error */
+    std::shared_ptr<obj::Object> complexValues(const std::shared_ptr<obj::Object> &obj, const std::string &errorPrefix, ComplexValues &result)
+    {
+        if (obj->type == obj::ObjectType::Error)
+            return obj;
+
+        result.owner = obj;
+        if (obj->type == obj::ObjectType::ArrayComplex)
+        {
+            const auto &arrayValues = static_cast<obj::ArrayComplex *>(obj.get())->value;
+            result.values = arrayValues.data();
+            result.n = arrayValues.size();
+            return nullptr;
+        }
+
+        if (obj->type == obj::ObjectType::ArrayView && isComplexArray(obj))
+            return complexValues(obj->clone(), errorPrefix, result);
+
+        if (obj->type == obj::ObjectType::Array && isComplexArray(obj))
+        {
+            const auto &elements = static_cast<obj::Array *>(obj.get())->value;
+            result.buffer.reserve(elements.size());
+            for (const auto &element : elements)
+            {
+                if (element->type == obj::ObjectType::Complex)
+                    result.buffer.push_back(static_cast<obj::Complex *>(element.get())->value);
+                else if (element->type == obj::ObjectType::Double)
+                    result.buffer.push_back(static_cast<obj::Double *>(element.get())->value);
+                else if (element->type == obj::ObjectType::Integer)
+                    result.buffer.push_back(static_cast<double>(static_cast<obj::Integer *>(element.get())->value));
+                else
+                    return obj::makeTypeError(errorPrefix + ": expected an array of numbers, found element of type " + obj::toString(element->type));
+            }
+            result.values = result.buffer.data();
+            result.n = result.buffer.size();
+            return nullptr;
+        }
+
+        NumericValues realValues;
+        auto errorObj = numericValues(obj, errorPrefix, realValues);
+        if (errorObj)
+            return errorObj;
+        result.buffer.assign(realValues.values, realValues.values + realValues.n);
+        result.values = result.buffer.data();
+        result.n = result.buffer.size();
+        return nullptr;
+    }
+
+    /* forward or inverse transform of the single array argument */
+    std::shared_ptr<obj::Object> transformImpl(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment, const std::string &errorPrefix, bool inverse)
+    {
+        if (arguments->size() != 1)
+            return obj::makeTypeError(errorPrefix + ": expected 1 argument");
+
+        ComplexValues array;
+        auto errorObj = complexValues(evalExpression(arguments->front().get(), environment), errorPrefix, array);
+        if (errorObj)
+            return errorObj;
+        if (array.n == 0)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected a non-empty array", obj::ErrorType::ValueError);
+
+        std::vector<std::complex<double>> result(array.values, array.values + array.n);
+        auto plan = fft::plan(result.size());
+        if (inverse)
+            plan->inverse(result.data());
+        else
+            plan->forward(result.data());
+        return std::make_shared<obj::ArrayComplex>(std::move(result));
+    }
+
+    bool isNumber(const std::shared_ptr<obj::Object> &obj)
+    {
+        return obj->type == obj::ObjectType::Double || obj->type == obj::ObjectType::Integer;
+    }
+
+    double toNumber(const std::shared_ptr<obj::Object> &obj)
+    {
+        if (obj->type == obj::ObjectType::Integer)
+            return static_cast<double>(static_cast<obj::Integer *>(obj.get())->value);
+        return static_cast<obj::Double *>(obj.get())->value;
+    }
+
+    /* evaluates the single array argument of a reduction */
+    std::shared_ptr<obj::Object> singleArrayArgument(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment, const std::string &errorPrefix, NumericValues &values)
+    {
+        if (arguments->size() != 1)
+            return obj::makeTypeError(errorPrefix + ": expected 1 argument");
+
+        return numericValues(evalExpression(arguments->front().get(), environment), errorPrefix, values);
+    }
+
+    std::shared_ptr<obj::Object> emptyArrayError(const std::string &errorPrefix)
+    {
+        return std::make_shared<obj::Error>(errorPrefix + ": expected a non-empty array", obj::ErrorType::ValueError);
+    }
+
+    /* variance with ddof delta degrees of freedom, computed in two passes: the mean and then the
+     * sum of the squared deviations from it, which does not suffer from cancellation
+     */
+    std::shared_ptr<obj::Object> varianceImpl(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment, const std::string &errorPrefix, double &variance)
+    {
+        if (arguments->size() != 1 && arguments->size() != 2)
+            return obj::makeTypeError(errorPrefix + ": expected 1 or 2 arguments");
+
+        NumericValues array;
+        auto errorObj = numericValues(evalExpression(arguments->at(0).get(), environment), errorPrefix, array);
+        if (errorObj)
+            return errorObj;
+
+        int64_t ddof = 0;
+        if (arguments->size() == 2)
+        {
+            auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+            RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Integer, errorPrefix + ": expected argument 2 to be an int");
+            ddof = static_cast<obj::Integer *>(evaluatedExpr2.get())->value;
+        }
+        if (ddof < 0 || static_cast<int64_t>(array.n) <= ddof)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected more than " + std::to_string(ddof) + " values", obj::ErrorType::ValueError);
+
+        const double mean = simd::sum(array.values, array.n) / static_cast<double>(array.n);
+        variance = simd::sumSquaredDeviations(array.values, array.n, mean) / static_cast<double>(static_cast<int64_t>(array.n) - ddof);
+        return nullptr;
+    }
+
+    /* quantile q of sorted values by linear interpolation between the closest ranks */
+    double quantileOfSorted(const std::vector<double> &sorted, double q)
+    {
+        const double position = q * static_cast<double>(sorted.size() - 1);
+        const size_t lower = static_cast<size_t>(std::floor(position));
+        const size_t upper = std::min(lower + 1, sorted.size() - 1);
+        const double fraction = position - static_cast<double>(lower);
+        // interpolating would give inf - inf and 0 * inf, which are nan, at or between infinite values
+        if (fraction == 0.0 || sorted[lower] == sorted[upper])
+            return sorted[lower];
+        return sorted[lower] + fraction * (sorted[upper] - sorted[lower]);
+    }
+
+    /* smallest and largest of the finite values, 0 for both when there are none */
+    void finiteMinMax(const double *values, size_t n, double &minimum, double &maximum)
+    {
+        minimum = std::numeric_limits<double>::infinity();
+        maximum = -std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (!std::isfinite(values[i]))
+                continue;
+            minimum = std::min(minimum, values[i]);
+            maximum = std::max(maximum, values[i]);
+        }
+        if (minimum > maximum)
+            minimum = maximum = 0.0;
+    }
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> numeric_sum(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        NumericValues array;
+        auto errorObj = singleArrayArgument(arguments, environment, "sum", array);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Double>(simd::sum(array.values, array.n));
+    }
+
+    std::shared_ptr<obj::Object> numeric_min(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        NumericValues array;
+        auto errorObj = singleArrayArgument(arguments, environment, "min", array);
+        if (errorObj)
+            return errorObj;
+        if (array.n == 0)
+            return emptyArrayError("min");
+
+        double minimum, maximum;
+        simd::minMax(array.values, array.n, minimum, maximum);
+        return std::make_shared<obj::Double>(minimum);
+    }
+
+    std::shared_ptr<obj::Object> numeric_max(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        NumericValues array;
+        auto errorObj = singleArrayArgument(arguments, environment, "max", array);
+        if (errorObj)
+            return errorObj;
+        if (array.n == 0)
+            return emptyArrayError("max");
+
+        double minimum, maximum;
+        simd::minMax(array.values, array.n, minimum, maximum);
+        return std::make_shared<obj::Double>(maximum);
+    }
+
+    std::shared_ptr<obj::Object> numeric_mean(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        NumericValues array;
+        auto errorObj = singleArrayArgument(arguments, environment, "mean", array);
+        if (errorObj)
+            return errorObj;
+        if (array.n == 0)
+            return emptyArrayError("mean");
+
+        return std::make_shared<obj::Double>(simd::sum(array.values, array.n) / static_cast<double>(array.n));
+    }
+
+    std::shared_ptr<obj::Object> numeric_var(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        double variance = 0.0;
+        auto errorObj = varianceImpl(arguments, environment, "var", variance);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Double>(variance);
+    }
+
+    std::shared_ptr<obj::Object> numeric_std(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        double variance = 0.0;
+        auto errorObj = varianceImpl(arguments, environment, "std", variance);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Double>(std::sqrt(variance));
+    }
+
+    std::shared_ptr<obj::Object> numeric_dot(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return obj::makeTypeError("dot: expected 2 arguments");
+
+        NumericValues lhs, rhs;
+        auto errorObj = numericValues(evalExpression(arguments->at(0).get(), environment), "dot", lhs);
+        if (errorObj)
+            return errorObj;
+        errorObj = numericValues(evalExpression(arguments->at(1).get(), environment), "dot", rhs);
+        if (errorObj)
+            return errorObj;
+        if (lhs.n != rhs.n)
+            return std::make_shared<obj::Error>("dot: expected arrays of equal length, got " + std::to_string(lhs.n) + " and " + std::to_string(rhs.n), obj::ErrorType::ValueError);
+
+        return std::make_shared<obj::Double>(simd::dot(lhs.values, rhs.values, lhs.n));
+    }
+
+    std::shared_ptr<obj::Object> numeric_norm(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return obj::makeTypeError("norm: expected 1 argument");
+
+        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        if (isComplexArray(evaluatedExpr))
+        {
+            ComplexValues array;
+            auto errorObj = complexValues(evaluatedExpr, "norm", array);
+            if (errorObj)
+                return errorObj;
+
+            // a complex number is stored as its real and imaginary part, the sum of the squares of both is the squared magnitude
+            auto parts = reinterpret_cast<const double *>(array.values);
+            return std::make_shared<obj::Double>(std::sqrt(simd::dot(parts, parts, 2 * array.n)));
+        }
+
+        NumericValues array;
+        auto errorObj = numericValues(evaluatedExpr, "norm", array);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Double>(std::sqrt(simd::dot(array.values, array.values, array.n)));
+    }
+
+    std::shared_ptr<obj::Object> numeric_histogram(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2 && arguments->size() != 4)
+            return obj::makeTypeError("histogram: expected 2 or 4 arguments");
+
+        NumericValues array;
+        auto errorObj = numericValues(evalExpression(arguments->at(0).get(), environment), "histogram", array);
+        if (errorObj)
+            return errorObj;
+
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Integer, "histogram: expected argument 2 to be an int");
+        const int64_t nrBins = static_cast<obj::Integer *>(evaluatedExpr2.get())->value;
+        if (nrBins <= 0)
+            return std::make_shared<obj::Error>("histogram: expected a positive number of bins", obj::ErrorType::ValueError);
+
+        // the bins cover the range of the values, unless a lower and upper bound are given
+        double lower = 0.0, upper = 0.0;
+        if (arguments->size() == 4)
+        {
+            auto evaluatedExpr3 = evalExpression(arguments->at(2).get(), environment);
+            auto evaluatedExpr4 = evalExpression(arguments->at(3).get(), environment);
+            if (!isNumber(evaluatedExpr3) || !isNumber(evaluatedExpr4))
+                return obj::makeTypeError("histogram: expected argument 3 and 4 to be a double");
+            lower = toNumber(evaluatedExpr3);
+            upper = toNumber(evaluatedExpr4);
+        }
+        else if (array.n > 0)
+        {
+            simd::minMax(array.values, array.n, lower, upper);
+            if (!std::isfinite(lower) || !std::isfinite(upper))
+                finiteMinMax(array.values, array.n, lower, upper);
+        }
+        if (!std::isfinite(lower) || !std::isfinite(upper) || lower > upper)
+            return std::make_shared<obj::Error>("histogram: expected a finite range for the bins", obj::ErrorType::ValueError);
+        if (lower == upper)
+        {
+            lower -= 0.5;
+            upper += 0.5;
+        }
+
+        // NaN, infinite values and values outside of the range are not counted, the upper bound belongs to the
+        // last bin; a long array is counted in chunks on the threads, the counts of the chunks are added afterwards.
+        // The values are halved first when the width of the range does not fit in a double
+        const double factor = std::isfinite(upper - lower) ? 1.0 : 0.5;
+        const double scaledLower = factor * lower;
+        const double scale = static_cast<double>(nrBins) / (factor * upper - scaledLower);
+        const double lastBin = static_cast<double>(nrBins - 1);
+        const size_t nrChunks = array.n > scheduler::parallelThreshold() ? std::min(array.n, scheduler::parallelThreads()) : 1;
+        std::vector<std::vector<int64_t>> chunkCounts(nrChunks, std::vector<int64_t>(static_cast<size_t>(nrBins), 0));
+        scheduler::parallelFor(nrChunks, 1, [&array, &chunkCounts, nrChunks, nrBins, lower, upper, factor, scaledLower, scale, lastBin](size_t beginChunk, size_t endChunk)
+                               {
+                                   for (size_t chunk = beginChunk; chunk < endChunk; ++chunk)
+                                   {
+                                       auto &counts = chunkCounts[chunk];
+                                       for (size_t i = chunk * array.n / nrChunks; i < (chunk + 1) * array.n / nrChunks; ++i)
+                                       {
+                                           const double v = array.values[i];
+                                           if (!(v >= lower && v <= upper))
+                                               continue;
+                                           // a range narrower than the smallest double over nrBins has an infinite scale,
+                                           // the lower bound then gives NaN and is put in the first bin
+                                           const double position = (factor * v - scaledLower) * scale;
+                                           if (position >= lastBin)
+                                               counts[static_cast<size_t>(nrBins - 1)] += 1;
+                                           else
+                                               counts[position > 0.0 ? static_cast<size_t>(position) : 0] += 1;
+                                       }
+                                   } });
+
+        auto &counts = chunkCounts.front();
+        for (size_t chunk = 1; chunk < nrChunks; ++chunk)
+            for (size_t bin = 0; bin < counts.size(); ++bin)
+                counts[bin] += chunkCounts[chunk][bin];
+
+        std::vector<std::shared_ptr<obj::Object>> countObjs;
+        countObjs.reserve(counts.size());
+        for (const auto &count : counts)
+            countObjs.push_back(std::make_shared<obj::Integer>(count));
+        return std::make_shared<obj::Array>(countObjs);
+    }
+
+    std::shared_ptr<obj::Object> numeric_quantile(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return obj::makeTypeError("quantile: expected 2 arguments");
+
+        NumericValues array;
+        auto errorObj = numericValues(evalExpression(arguments->at(0).get(), environment), "quantile", array);
+        if (errorObj)
+            return errorObj;
+        if (array.n == 0)
+            return emptyArrayError("quantile");
+
+        // a single quantile or an array_double of them, computed from a single sorted copy
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        if (evaluatedExpr2->type == obj::ObjectType::Error)
+            return evaluatedExpr2;
+        std::vector<double> qs;
+        if (isNumber(evaluatedExpr2))
+            qs.push_back(toNumber(evaluatedExpr2));
+        else if (evaluatedExpr2->type == obj::ObjectType::ArrayDouble)
+            qs = static_cast<obj::ArrayDouble *>(evaluatedExpr2.get())->value;
+        else
+            return obj::makeTypeError("quantile: expected argument 2 to be a double or an array_double");
+
+        for (const auto &q : qs)
+            if (!(q >= 0.0 && q <= 1.0))
+                return std::make_shared<obj::Error>("quantile: expected quantiles between 0.0 and 1.0", obj::ErrorType::ValueError);
+
+        std::vector<double> sorted(array.values, array.values + array.n);
+        if (std::any_of(sorted.begin(), sorted.end(), [](double v)
+                        { return std::isnan(v); }))
+            return std::make_shared<obj::Error>("quantile: expected values without NaN", obj::ErrorType::ValueError);
+        std::sort(sorted.begin(), sorted.end());
+
+        if (isNumber(evaluatedExpr2))
+            return std::make_shared<obj::Double>(quantileOfSorted(sorted, qs.front()));
+
+        std::vector<double> result;
+        result.reserve(qs.size());
+        for (const auto &q : qs)
+            result.push_back(quantileOfSorted(sorted, q));
+        return std::make_shared<obj::ArrayDouble>(std::move(result));
+    }
+
+    std::shared_ptr<obj::Object> numeric_fft(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        return transformImpl(arguments, environment, "fft", false);
+    }
+
+    std::shared_ptr<obj::Object> numeric_ifft(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        return transformImpl(arguments, environment, "ifft", true);
+    }
+
+    std::shared_ptr<obj::Object> numeric_rfft(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        NumericValues array;
+        auto errorObj = singleArrayArgument(arguments, environment, "rfft", array);
+        if (errorObj)
+            return errorObj;
+        if (array.n == 0)
+            return emptyArrayError("rfft");
+
+        std::vector<std::complex<double>> result(array.n / 2 + 1);
+        fft::realForward(array.values, array.n, result.data());
+        return std::make_shared<obj::ArrayComplex>(std::move(result));
+    }
+
+    std::shared_ptr<obj::Object> numeric_convolve(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return obj::makeTypeError("convolve: expected 2 arguments");
+
+        auto evaluatedExpr1 = evalExpression(arguments->at(0).get(), environment);
+        if (evaluatedExpr1->type == obj::ObjectType::Error)
+            return evaluatedExpr1;
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        if (evaluatedExpr2->type == obj::ObjectType::Error)
+            return evaluatedExpr2;
+
+        if (isComplexArray(evaluatedExpr1) || isComplexArray(evaluatedExpr2))
+        {
+            ComplexValues lhs, rhs;
+            auto errorObj = complexValues(evaluatedExpr1, "convolve", lhs);
+            if (errorObj)
+                return errorObj;
+            errorObj = complexValues(evaluatedExpr2, "convolve", rhs);
+            if (errorObj)
+                return errorObj;
+            if (lhs.n == 0 || rhs.n == 0)
+                return emptyArrayError("convolve");
+
+            std::vector<std::complex<double>> result(lhs.n + rhs.n - 1);
+            fft::convolve(lhs.values, lhs.n, rhs.values, rhs.n, result.data());
+            return std::make_shared<obj::ArrayComplex>(std::move(result));
+        }
+
+        NumericValues lhs, rhs;
+        auto errorObj = numericValues(evaluatedExpr1, "convolve", lhs);
+        if (errorObj)
+            return errorObj;
+        errorObj = numericValues(evaluatedExpr2, "convolve", rhs);
+        if (errorObj)
+            return errorObj;
+        if (lhs.n == 0 || rhs.n == 0)
+            return emptyArrayError("convolve");
+
+        std::vector<double> result(lhs.n + rhs.n - 1);
+        fft::convolve(lhs.values, lhs.n, rhs.values, rhs.n, result.data());
+        return std::make_shared<obj::ArrayDouble>(std::move(result));
+    }
+
+    std::shared_ptr<obj::Object> numeric_set_threads(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return obj::makeTypeError("set_threads: expected 1 argument");
+
+        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr, Integer, "set_threads: expected argument 1 to be an int");
+        const int64_t n = static_cast<obj::Integer *>(evaluatedExpr.get())->value;
+        if (n < 0)
+            return std::make_shared<obj::Error>("set_threads: expected a non-negative number of threads", obj::ErrorType::ValueError);
+
+        scheduler::setParallelThreads(static_cast<size_t>(n));
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> numeric_threads(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (!arguments->empty())
+            return obj::makeTypeError("threads: expected 0 arguments");
+
+        return std::make_shared<obj::Integer>(static_cast<int64_t>(scheduler::parallelThreads()));
+    }
+
+    std::shared_ptr<obj::Object> numeric_set_parallel_threshold(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return obj::makeTypeError("set_parallel_threshold: expected 1 argument");
+
+        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr, Integer, "set_parallel_threshold: expected argument 1 to be an int");
+        const int64_t n = static_cast<obj::Integer *>(evaluatedExpr.get())->value;
+        if (n < 0)
+            return std::make_shared<obj::Error>("set_parallel_threshold: expected a non-negative number of elements", obj::ErrorType::ValueError);
+
+        scheduler::setParallelThreshold(static_cast<size_t>(n));
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> numeric_parallel_threshold(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (!arguments->empty())
+            return obj::makeTypeError("parallel_threshold: expected 0 arguments");
+
+        return std::make_shared<obj::Integer>(static_cast<int64_t>(scheduler::parallelThreshold()));
+    }
+
+    std::shared_ptr<obj::Module> createNumericModule()
+    {
+        auto numericModule = std::make_shared<obj::Module>();
+        numericModule->environment->add("sum", builtin::makeBuiltInFunctionObj(&builtin::numeric_sum, "all", "double"), false, nullptr);
+        numericModule->environment->add("min", builtin::makeBuiltInFunctionObj(&builtin::numeric_min, "all", "double"), false, nullptr);
+        numericModule->environment->add("max", builtin::makeBuiltInFunctionObj(&builtin::numeric_max, "all", "double"), false, nullptr);
+        numericModule->environment->add("mean", builtin::makeBuiltInFunctionObj(&builtin::numeric_mean, "all", "double"), false, nullptr);
+        numericModule->environment->add("var", builtin::makeBuiltInFunctionObj(&builtin::numeric_var, "all, int", "double"), false, nullptr);
+        numericModule->environment->add("std", builtin::makeBuiltInFunctionObj(&builtin::numeric_std, "all, int", "double"), false, nullptr);
+        numericModule->environment->add("dot", builtin::makeBuiltInFunctionObj(&builtin::numeric_dot, "all, all", "double"), false, nullptr);
+        numericModule->environment->add("norm", builtin::makeBuiltInFunctionObj(&builtin::numeric_norm, "all", "double"), false, nullptr);
+        numericModule->environment->add("histogram", builtin::makeBuiltInFunctionObj(&builtin::numeric_histogram, "all, int, double, double", "[int]"), false, nullptr);
+        numericModule->environment->add("quantile", builtin::makeBuiltInFunctionObj(&builtin::numeric_quantile, "all, all", "all"), false, nullptr);
+        numericModule->environment->add("fft", builtin::makeBuiltInFunctionObj(&builtin::numeric_fft, "all", "[complex]"), false, nullptr);
+        numericModule->environment->add("ifft", builtin::makeBuiltInFunctionObj(&builtin::numeric_ifft, "all", "[complex]"), false, nullptr);
+        numericModule->environment->add("rfft", builtin::makeBuiltInFunctionObj(&builtin::numeric_rfft, "all", "[complex]"), false, nullptr);
+        numericModule->environment->add("convolve", builtin::makeBuiltInFunctionObj(&builtin::numeric_convolve, "all, all", "all"), false, nullptr);
+        numericModule->environment->add("set_threads", builtin::makeBuiltInFunctionObj(&builtin::numeric_set_threads, "int", "null"), false, nullptr);
+        numericModule->environment->add("threads", builtin::makeBuiltInFunctionObj(&builtin::numeric_threads, "", "int"), false, nullptr);
+        numericModule->environment->add("set_parallel_threshold", builtin::makeBuiltInFunctionObj(&builtin::numeric_set_parallel_threshold, "int", "null"), false, nullptr);
+        numericModule->environment->add("parallel_threshold", builtin::makeBuiltInFunctionObj(&builtin::numeric_parallel_threshold, "", "int"), false, nullptr);
+        numericModule->state = obj::ModuleState::Loaded;
+        return numericModule;
+    }
+} // namespace builtin
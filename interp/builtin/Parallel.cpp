@@ -0,0 +1,210 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Parallel.h"
+#include "../Evaluator.h"
+#include "../Interpreter.h"
+#include "../Scheduler.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    typedef std::function<std::shared_ptr<obj::Object>(size_t)> TElementAt;
+
+    /* call function for each of the nrElements elements on the shared pool, the elements are
+     * split in chunks of chunkSize (0 for automatic) that are each evaluated by a single thread,
+     * the return values are stored in order in results when provided
+     *
+     * returns the first error in element order, or nullptr when all calls succeeded
+     */
+    std::shared_ptr<obj::Object> parallelApply(const std::shared_ptr<obj::Function> &function, size_t nrElements, size_t chunkSize, const TElementAt &elementAt, std::vector<std::shared_ptr<obj::Object>> *results)
+    {
+        // a few chunks per thread keeps the threads busy when the cost per element varies
+        if (chunkSize == 0)
+            chunkSize = std::max<size_t>(1, nrElements / (4 * scheduler::parallelThreads()));
+
+        // from now on the environment of the function is used by several threads
+        if (function->environment)
+            function->environment->markShared();
+
+        // the calling thread takes part in the work, but only in the chunks of this call: it never runs an
+        // unrelated task of the pool, which could block on something the caller itself is to provide
+        std::atomic_bool failed{false};
+        std::vector<std::shared_ptr<obj::Object>> outcomes((nrElements + chunkSize - 1) / chunkSize);
+        auto interpreter = interp::Interpreter::current();
+        scheduler::parallelForChunks(nrElements, chunkSize, [&function, &elementAt, &failed, &outcomes, results, chunkSize, interpreter](size_t begin, size_t end)
+                                     {
+                                         // a worker may run chunks of several interpreters, the chunk runs in the one of the caller
+                                         interp::CurrentInterpreter current(interpreter);
+                                         auto &outcome = outcomes[begin / chunkSize];
+                                         try
+                                         {
+                                             auto environment = std::make_shared<obj::Environment>();
+                                             environment->outer = function->environment;
+                                             for (size_t index = begin; index < end && !failed; ++index)
+                                             {
+                                                 auto returnValue = evalFunctionWithArguments(function.get(), {elementAt(index)}, environment);
+                                                 if (returnValue->type == obj::ObjectType::Error)
+                                                 {
+                                                     failed = true;
+                                                     outcome = returnValue;
+                                                     break;
+                                                 }
+                                                 if (results)
+                                                     (*results)[index] = returnValue;
+                                             }
+                                         }
+                                         catch (const std::exception &e)
+                                         {
+                                             failed = true;
+                                             outcome = std::make_shared<obj::Error>(std::string("parallel: task failed: ") + e.what(), obj::ErrorType::UndefinedError);
+                                         } });
+
+        for (const auto &outcome : outcomes)
+        {
+            if (outcome)
+                return outcome;
+        }
+        return nullptr;
+    }
+
+    /* element accessor for the supported inputs, the input is captured so it stays alive while accessed */
+    TElementAt makeElementAt(const std::shared_ptr<obj::Object> &input)
+    {
+        switch (input->type)
+        {
+        case obj::ObjectType::Array:
+        {
+            auto array = std::static_pointer_cast<obj::Array>(input);
+            return [array](size_t index)
+            { return array->value[index]; };
+        }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto array = std::static_pointer_cast<obj::ArrayInt>(input);
+            return [array](size_t index)
+            { return obj::ArrayInt::valueConstruct(array->value[index]); };
+        }
+        case obj::ObjectType::ArrayDouble:
+        {
+            auto array = std::static_pointer_cast<obj::ArrayDouble>(input);
+            return [array](size_t index)
+            { return obj::ArrayDouble::valueConstruct(array->value[index]); };
+        }
+        case obj::ObjectType::ArrayComplex:
+        {
+            auto array = std::static_pointer_cast<obj::ArrayComplex>(input);
+            return [array](size_t index)
+            { return obj::ArrayComplex::valueConstruct(array->value[index]); };
+        }
+        case obj::ObjectType::ArrayView:
+        {
+            auto view = std::static_pointer_cast<obj::ArrayView>(input);
+            return [view](size_t index)
+            { return view->element(index); };
+        }
+        case obj::ObjectType::Range:
+        {
+            auto range = std::static_pointer_cast<obj::Range>(input);
+            return [range](size_t index) -> std::shared_ptr<obj::Object>
+            { return std::make_shared<obj::Integer>(range->lower + static_cast<int64_t>(index) * range->stride); };
+        }
+        }
+        return nullptr;
+    }
+
+    size_t nrElementsOf(const obj::Object *input)
+    {
+        switch (input->type)
+        {
+        case obj::ObjectType::Array:
+            return static_cast<const obj::Array *>(input)->value.size();
+        case obj::ObjectType::ArrayInt:
+            return static_cast<const obj::ArrayInt *>(input)->value.size();
+        case obj::ObjectType::ArrayDouble:
+            return static_cast<const obj::ArrayDouble *>(input)->value.size();
+        case obj::ObjectType::ArrayComplex:
+            return static_cast<const obj::ArrayComplex *>(input)->value.size();
+        case obj::ObjectType::ArrayView:
+            return static_cast<const obj::ArrayView *>(input)->length;
+        case obj::ObjectType::Range:
+            return static_cast<size_t>(static_cast<const obj::Range *>(input)->length());
+        }
+        return 0;
+    }
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> parallel_map(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2 && arguments->size() != 3)
+            return std::make_shared<obj::Error>("parallel_map: expected 2 or 3 arguments of type (func, [all], int)", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->at(0).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Function, "parallel_map: expected argument 1 to be a function");
+
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        if (evaluatedExpr2->type == obj::ObjectType::Error)
+            return evaluatedExpr2;
+        auto elementAt = makeElementAt(evaluatedExpr2);
+        if (!elementAt)
+            return std::make_shared<obj::Error>("parallel_map: expected argument 2 to be an array or a range, got " + obj::toString(evaluatedExpr2->type), obj::ErrorType::TypeError);
+
+        size_t chunkSize = 0;
+        if (arguments->size() == 3)
+        {
+            auto evaluatedExpr3 = evalExpression(arguments->at(2).get(), environment);
+            RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr3, Integer, "parallel_map: expected argument 3 to be an int");
+            auto requestedChunkSize = static_cast<obj::Integer *>(evaluatedExpr3.get())->value;
+            if (requestedChunkSize <= 0)
+                return std::make_shared<obj::Error>("parallel_map: expected a positive chunk size", obj::ErrorType::ValueError);
+            chunkSize = static_cast<size_t>(requestedChunkSize);
+        }
+
+        // the input is shared by the workers as is, it is frozen while they run so that it cannot change underneath them
+        obj::ObjectFreezer freezer(evaluatedExpr2);
+        // and the functions it holds are called from several threads
+        obj::markShared(evaluatedExpr2);
+
+        auto function = std::static_pointer_cast<obj::Function>(evaluatedExpr1);
+        std::vector<std::shared_ptr<obj::Object>> results(nrElementsOf(evaluatedExpr2.get()));
+        auto errorObj = parallelApply(function, results.size(), chunkSize, elementAt, &results);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Array>(results);
+    }
+
+    std::shared_ptr<obj::Object> parallel_for(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return std::make_shared<obj::Error>("parallel_for: expected 2 arguments of type (range, func)", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->at(0).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Range, "parallel_for: expected argument 1 to be a range");
+
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Function, "parallel_for: expected argument 2 to be a function");
+
+        auto function = std::static_pointer_cast<obj::Function>(evaluatedExpr2);
+        auto errorObj = parallelApply(function, nrElementsOf(evaluatedExpr1.get()), 0, makeElementAt(evaluatedExpr1), nullptr);
+        if (errorObj)
+            return errorObj;
+
+        return NullObject;
+    }
+} // namespace builtin
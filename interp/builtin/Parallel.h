@@ -0,0 +1,20 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_BUILTIN_PARALLEL_H
+#define GUARDIAN_OF_INCLUSION_BUILTIN_PARALLEL_H
+
+#include "../Object.h"
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> parallel_map(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
+    std::shared_ptr<obj::Object> parallel_for(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment);
+}
+
+#endif
@@ -0,0 +1,394 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Random.h"
+#include "../Evaluator.h"
+#include "../Random.h"
+#include "../Typing.h"
+
+#include <cmath>
+
+namespace
+{
+    bool isNumber(const std::shared_ptr<obj::Object> &obj)
+    {
+        return obj->type == obj::ObjectType::Double || obj->type == obj::ObjectType::Integer;
+    }
+
+    double toNumber(const std::shared_ptr<obj::Object> &obj)
+    {
+        if (obj->type == obj::ObjectType::Integer)
+            return static_cast<double>(static_cast<obj::Integer *>(obj.get())->value);
+        return static_cast<obj::Double *>(obj.get())->value;
+    }
+
+    /* the numbers given as arguments first to first + count, returns nullptr when they are set, otherwise the error */
+    std::shared_ptr<obj::Object> numberArguments(const std::vector<std::unique_ptr<ast::Expression>> *arguments, size_t first, size_t count, const std::shared_ptr<obj::Environment> &environment, const std::string &errorPrefix, double *values)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto evaluatedExpr = evalExpression(arguments->at(first + i).get(), environment);
+            if (evaluatedExpr->type == obj::ObjectType::Error)
+                return evaluatedExpr;
+            if (!isNumber(evaluatedExpr))
+                return obj::makeTypeError(errorPrefix + ": expected argument " + std::to_string(first + i + 1) + " to be a double");
+            values[i] = toNumber(evaluatedExpr);
+        }
+        return nullptr;
+    }
+
+    /* the array the values are drawn into: a new array for a number of values, or the array itself
+     * when an array of the right type is given.  Returns the array or the error
+     */
+    template <typename TArray, typename T>
+    std::shared_ptr<obj::Object> drawTarget(const std::shared_ptr<obj::Object> &obj, obj::ObjectType arrayType, const std::string &errorPrefix, T *&values, size_t &n)
+    {
+        if (obj->type == obj::ObjectType::Error)
+            return obj;
+
+        if (obj->type == obj::ObjectType::Integer)
+        {
+            const int64_t count = static_cast<obj::Integer *>(obj.get())->value;
+            if (count < 0)
+                return std::make_shared<obj::Error>(errorPrefix + ": expected a non-negative number of values", obj::ErrorType::ValueError);
+            auto result = std::make_shared<TArray>(std::vector<T>(static_cast<size_t>(count)));
+            values = result->value.data();
+            n = result->value.size();
+            return result;
+        }
+
+        if (obj->type == arrayType)
+        {
+            if (obj->frozen > 0)
+                return obj::makeTypeError(errorPrefix + " expects a non-frozen array");
+            auto &arrayValues = static_cast<TArray *>(obj.get())->value;
+            values = arrayValues.data();
+            n = arrayValues.size();
+            return obj;
+        }
+
+        return obj::makeTypeError(errorPrefix + ": expected argument 1 to be an int or an " + obj::toString(arrayType) + ", got " + obj::toString(obj->type));
+    }
+
+    /* the shared part of uniform, normal and exponential: no arguments draw one double, otherwise
+     * the first argument is the number of values or the array_double to fill, followed by either none
+     * or all of the nrParameters numbers; check gives the error message for invalid parameters
+     */
+    template <typename TCheck, typename TDraw, typename TFill>
+    std::shared_ptr<obj::Object> drawDoubles(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment, const std::string &errorPrefix, double *parameters, size_t nrParameters, const TCheck &check, const TDraw &draw, const TFill &fill)
+    {
+        if (arguments->size() != 0 && arguments->size() != 1 && arguments->size() != 1 + nrParameters)
+            return obj::makeTypeError(errorPrefix + ": expected 0, 1 or " + std::to_string(1 + nrParameters) + " arguments");
+
+        if (arguments->empty())
+            return std::make_shared<obj::Double>(draw(rng::threadGenerator()));
+
+        auto target = evalExpression(arguments->front().get(), environment);
+        if (arguments->size() > 1)
+        {
+            auto errorObj = numberArguments(arguments, 1, nrParameters, environment, errorPrefix, parameters);
+            if (errorObj)
+                return errorObj;
+            const std::string message = check(parameters);
+            if (!message.empty())
+                return std::make_shared<obj::Error>(errorPrefix + ": " + message, obj::ErrorType::ValueError);
+        }
+
+        double *values = nullptr;
+        size_t n = 0;
+        auto result = drawTarget<obj::ArrayDouble>(target, obj::ObjectType::ArrayDouble, errorPrefix, values, n);
+        if (result->type != obj::ObjectType::Error)
+            fill(rng::threadGenerator(), values, n);
+        return result;
+    }
+
+    /* the first count elements of values become a uniformly chosen sample of all elements, in random
+     * order (the first steps of the shuffle of Fisher and Yates)
+     */
+    template <typename T>
+    void shuffleValues(rng::Generator &generator, std::vector<T> &values, size_t count)
+    {
+        const size_t n = values.size();
+        for (size_t i = 0; i < count && i + 1 < n; ++i)
+        {
+            const auto j = static_cast<size_t>(generator.integer(static_cast<int64_t>(i), static_cast<int64_t>(n - 1)));
+            std::swap(values[i], values[j]);
+        }
+    }
+
+    template <typename TArray>
+    std::shared_ptr<obj::Object> sampleArray(const std::shared_ptr<obj::Object> &obj, size_t count)
+    {
+        const auto &values = static_cast<TArray *>(obj.get())->value;
+        if (count > values.size())
+            return std::make_shared<obj::Error>("sample: expected a sample size of at most " + std::to_string(values.size()) + ", got " + std::to_string(count), obj::ErrorType::ValueError);
+
+        // the indices are shuffled instead of the values, leaving the array as it is
+        std::vector<size_t> indices(values.size());
+        for (size_t i = 0; i < indices.size(); ++i)
+            indices[i] = i;
+        shuffleValues(rng::threadGenerator(), indices, count);
+
+        std::decay_t<decltype(values)> sample;
+        sample.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            sample.push_back(values[indices[i]]);
+        return std::make_shared<TArray>(std::move(sample));
+    }
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> random_seed(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->empty() || arguments->size() > 3)
+            return obj::makeTypeError("seed: expected 1, 2 or 3 arguments");
+
+        auto evaluatedExpr = evalExpression(arguments->at(0).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr, Integer, "seed: expected argument 1 to be an int");
+        const int64_t seed = static_cast<obj::Integer *>(evaluatedExpr.get())->value;
+
+        int64_t stream = 0;
+        if (arguments->size() >= 2)
+        {
+            auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+            RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Integer, "seed: expected argument 2 to be an int");
+            stream = static_cast<obj::Integer *>(evaluatedExpr2.get())->value;
+            if (stream < 0)
+                return std::make_shared<obj::Error>("seed: expected a non-negative stream", obj::ErrorType::ValueError);
+        }
+
+        auto algorithm = rng::threadGenerator().algorithm();
+        if (arguments->size() == 3)
+        {
+            auto evaluatedExpr3 = evalExpression(arguments->at(2).get(), environment);
+            RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr3, String, "seed: expected argument 3 to be a str");
+            const auto &name = static_cast<obj::String *>(evaluatedExpr3.get())->value;
+            if (!rng::fromString(name, algorithm))
+                return std::make_shared<obj::Error>("seed: unknown algorithm " + name + ", expected xoshiro256** or pcg32", obj::ErrorType::ValueError);
+        }
+
+        rng::threadGenerator().seed(static_cast<uint64_t>(seed), static_cast<uint64_t>(stream), algorithm);
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> random_algorithm(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (!arguments->empty())
+            return obj::makeTypeError("algorithm: expected 0 arguments");
+
+        return std::make_shared<obj::String>(rng::toString(rng::threadGenerator().algorithm()));
+    }
+
+    std::shared_ptr<obj::Object> random_random(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (!arguments->empty())
+            return obj::makeTypeError("random: expected 0 arguments");
+
+        return std::make_shared<obj::Double>(rng::threadGenerator().uniform());
+    }
+
+    std::shared_ptr<obj::Object> random_randint(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return obj::makeTypeError("randint: expected 2 arguments");
+
+        auto evaluatedExpr = evalExpression(arguments->at(0).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr, Integer, "randint: expected argument 1 to be an int");
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Integer, "randint: expected argument 2 to be an int");
+        const int64_t lower = static_cast<obj::Integer *>(evaluatedExpr.get())->value;
+        const int64_t upper = static_cast<obj::Integer *>(evaluatedExpr2.get())->value;
+        if (lower > upper)
+            return std::make_shared<obj::Error>("randint: expected a lower bound not larger than the upper bound", obj::ErrorType::ValueError);
+
+        return std::make_shared<obj::Integer>(rng::threadGenerator().integer(lower, upper));
+    }
+
+    std::shared_ptr<obj::Object> random_uniform(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        double bounds[2] = {0.0, 1.0};
+        return drawDoubles(
+            arguments, environment, "uniform", bounds, 2, [](const double *given)
+            { return given[0] <= given[1] && std::isfinite(given[1] - given[0]) ? "" : "expected a finite range with a lower bound not larger than the upper bound"; },
+            [](rng::Generator &generator)
+            { return generator.uniform(); },
+            [&bounds](rng::Generator &generator, double *values, size_t n)
+            { rng::fillUniform(generator, values, n, bounds[0], bounds[1]); });
+    }
+
+    std::shared_ptr<obj::Object> random_normal(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        double parameters[2] = {0.0, 1.0};
+        return drawDoubles(
+            arguments, environment, "normal", parameters, 2, [](const double *given)
+            { return given[1] >= 0.0 ? "" : "expected a non-negative standard deviation"; },
+            [](rng::Generator &generator)
+            { return generator.normal(); },
+            [&parameters](rng::Generator &generator, double *values, size_t n)
+            { rng::fillNormal(generator, values, n, parameters[0], parameters[1]); });
+    }
+
+    std::shared_ptr<obj::Object> random_exponential(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        double rate = 1.0;
+        return drawDoubles(
+            arguments, environment, "exponential", &rate, 1, [](const double *given)
+            { return given[0] > 0.0 ? "" : "expected a positive rate"; },
+            [](rng::Generator &generator)
+            { return generator.exponential(); },
+            [&rate](rng::Generator &generator, double *values, size_t n)
+            { rng::fillExponential(generator, values, n, rate); });
+    }
+
+    std::shared_ptr<obj::Object> random_integers(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 3)
+            return obj::makeTypeError("integers: expected 3 arguments");
+
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Integer, "integers: expected argument 2 to be an int");
+        auto evaluatedExpr3 = evalExpression(arguments->at(2).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr3, Integer, "integers: expected argument 3 to be an int");
+        const int64_t lower = static_cast<obj::Integer *>(evaluatedExpr2.get())->value;
+        const int64_t upper = static_cast<obj::Integer *>(evaluatedExpr3.get())->value;
+        if (lower > upper)
+            return std::make_shared<obj::Error>("integers: expected a lower bound not larger than the upper bound", obj::ErrorType::ValueError);
+
+        int64_t *values = nullptr;
+        size_t n = 0;
+        auto result = drawTarget<obj::ArrayInt>(evalExpression(arguments->at(0).get(), environment), obj::ObjectType::ArrayInt, "integers", values, n);
+        if (result->type != obj::ObjectType::Error)
+            rng::fillIntegers(rng::threadGenerator(), values, n, lower, upper);
+        return result;
+    }
+
+    std::shared_ptr<obj::Object> random_shuffle(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return obj::makeTypeError("shuffle: expected 1 argument");
+
+        auto evaluatedExpr = evalExpression(arguments->front().get(), environment);
+        if (evaluatedExpr->type == obj::ObjectType::Error)
+            return evaluatedExpr;
+        if (evaluatedExpr->frozen > 0)
+            return obj::makeTypeError("shuffle expects a non-frozen array");
+
+        auto &generator = rng::threadGenerator();
+        switch (evaluatedExpr->type)
+        {
+        case obj::ObjectType::Array:
+        {
+            auto &values = static_cast<obj::Array *>(evaluatedExpr.get())->value;
+            shuffleValues(generator, values, values.size());
+            return NullObject;
+        }
+        case obj::ObjectType::ArrayDouble:
+        {
+            auto &values = static_cast<obj::ArrayDouble *>(evaluatedExpr.get())->value;
+            shuffleValues(generator, values, values.size());
+            return NullObject;
+        }
+        case obj::ObjectType::ArrayComplex:
+        {
+            auto &values = static_cast<obj::ArrayComplex *>(evaluatedExpr.get())->value;
+            shuffleValues(generator, values, values.size());
+            return NullObject;
+        }
+        case obj::ObjectType::ArrayInt:
+        {
+            auto &values = static_cast<obj::ArrayInt *>(evaluatedExpr.get())->value;
+            shuffleValues(generator, values, values.size());
+            return NullObject;
+        }
+        default:
+            return obj::makeTypeError("shuffle: expected argument 1 to be an array, got " + obj::toString(evaluatedExpr->type));
+        }
+    }
+
+    std::shared_ptr<obj::Object> random_sample(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 2)
+            return obj::makeTypeError("sample: expected 2 arguments");
+
+        auto evaluatedExpr2 = evalExpression(arguments->at(1).get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr2, Integer, "sample: expected argument 2 to be an int");
+        const int64_t count = static_cast<obj::Integer *>(evaluatedExpr2.get())->value;
+        if (count < 0)
+            return std::make_shared<obj::Error>("sample: expected a non-negative sample size", obj::ErrorType::ValueError);
+
+        auto evaluatedExpr = evalExpression(arguments->at(0).get(), environment);
+        if (evaluatedExpr->type == obj::ObjectType::ArrayView)
+            evaluatedExpr = evaluatedExpr->clone();
+        else if (evaluatedExpr->type == obj::ObjectType::Range)
+            evaluatedExpr = std::make_shared<obj::ArrayInt>(static_cast<obj::Range *>(evaluatedExpr.get())->values());
+
+        switch (evaluatedExpr->type)
+        {
+        case obj::ObjectType::Error:
+            return evaluatedExpr;
+        case obj::ObjectType::Array:
+            return sampleArray<obj::Array>(evaluatedExpr, static_cast<size_t>(count));
+        case obj::ObjectType::ArrayDouble:
+            return sampleArray<obj::ArrayDouble>(evaluatedExpr, static_cast<size_t>(count));
+        case obj::ObjectType::ArrayComplex:
+            return sampleArray<obj::ArrayComplex>(evaluatedExpr, static_cast<size_t>(count));
+        case obj::ObjectType::ArrayInt:
+            return sampleArray<obj::ArrayInt>(evaluatedExpr, static_cast<size_t>(count));
+        default:
+            return obj::makeTypeError("sample: expected argument 1 to be an array or a range, got " + obj::toString(evaluatedExpr->type));
+        }
+    }
+
+    std::shared_ptr<obj::Module> createRandomModule()
+    {
+        auto module = std::make_shared<obj::Module>();
+        module->environment->add("seed", builtin::makeBuiltInFunctionObj(&builtin::random_seed, "int, int, str", "null"), false, nullptr);
+        module->environment->add("algorithm", builtin::makeBuiltInFunctionObj(&builtin::random_algorithm, "", "str"), false, nullptr);
+        module->environment->add("random", builtin::makeBuiltInFunctionObj(&builtin::random_random, "", "double"), false, nullptr);
+        module->environment->add("randint", builtin::makeBuiltInFunctionObj(&builtin::random_randint, "int, int", "int"), false, nullptr);
+        module->environment->add("uniform", builtin::makeBuiltInFunctionObj(&builtin::random_uniform, "all, double, double", "all"), false, nullptr);
+        module->environment->add("normal", builtin::makeBuiltInFunctionObj(&builtin::random_normal, "all, double, double", "all"), false, nullptr);
+        module->environment->add("exponential", builtin::makeBuiltInFunctionObj(&builtin::random_exponential, "all, double", "all"), false, nullptr);
+        module->environment->add("integers", builtin::makeBuiltInFunctionObj(&builtin::random_integers, "all, int, int", "all"), false, nullptr);
+        module->environment->add("shuffle", builtin::makeBuiltInFunctionObj(&builtin::random_shuffle, "all", "null"), false, nullptr);
+        module->environment->add("sample", builtin::makeBuiltInFunctionObj(&builtin::random_sample, "all, int", "all"), false, nullptr);
+        module->state = obj::ModuleState::Loaded;
+        return module;
+    }
+} // namespace builtin
@@ -0,0 +1,479 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "Synchronization.h"
+#include "../Evaluator.h"
+#include "../Typing.h"
+#include "../Util.h"
+
+namespace
+{
+    std::shared_ptr<obj::Object>
+    validateArguments(
+        const std::string &errorPrefix,
+        const std::shared_ptr<obj::Object> &self,
+        const std::vector<std::shared_ptr<obj::Object>> &arguments,
+        const obj::ObjectType expectedType,
+        std::set<size_t> nrExpectedArguments)
+    {
+        if (self.get()->type != expectedType)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected " + toString(expectedType) + ", got " + toString(self.get()->type), obj::ErrorType::TypeError);
+        if (nrExpectedArguments.find(arguments.size()) == nrExpectedArguments.end())
+        {
+            if (nrExpectedArguments.size() == 1)
+            {
+                return std::make_shared<obj::Error>(errorPrefix + ": expected " + std::to_string(*nrExpectedArguments.begin()) + " arguments, got " + std::to_string(arguments.size()), obj::ErrorType::TypeError);
+            }
+            else
+            {
+                std::vector<std::string> nrExpected;
+                for (const auto &element : nrExpectedArguments)
+                    nrExpected.push_back(std::to_string(element));
+                return std::make_shared<obj::Error>(errorPrefix + ": expected " + util::join(nrExpected, ",") + " arguments, got " + std::to_string(arguments.size()), obj::ErrorType::TypeError);
+            }
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<obj::Object> validateIntegerArgument(const std::string &errorPrefix, const std::vector<std::shared_ptr<obj::Object>> &arguments, size_t index)
+    {
+        if (arguments[index]->type != obj::ObjectType::Integer)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected argument " + std::to_string(index + 1) + " to be an int, got " + toString(arguments[index]->type), obj::ErrorType::TypeError);
+        return nullptr;
+    }
+
+    int64_t integerArgument(const std::vector<std::shared_ptr<obj::Object>> &arguments, size_t index)
+    {
+        return static_cast<obj::Integer *>(arguments[index].get())->value;
+    }
+}
+
+namespace obj
+{
+    Mutex::Mutex() : Object(ObjectType::Mutex)
+    {
+    }
+
+    Mutex::~Mutex()
+    {
+    }
+
+    std::string Mutex::inspect() const
+    {
+        return "<mutex>";
+    }
+
+    RwLock::RwLock() : Object(ObjectType::RwLock)
+    {
+    }
+
+    RwLock::~RwLock()
+    {
+    }
+
+    std::string RwLock::inspect() const
+    {
+        return "<rwlock>";
+    }
+
+    LockGuard::LockGuard(std::shared_ptr<Object> ilockable) : Object(ObjectType::LockGuard), lockable(ilockable)
+    {
+    }
+
+    LockGuard::~LockGuard()
+    {
+    }
+
+    bool LockGuard::locked() const
+    {
+        return mutexLock.owns_lock() || writeLock.owns_lock() || readLock.owns_lock();
+    }
+
+    void LockGuard::unlock()
+    {
+        if (mutexLock.owns_lock())
+            mutexLock.unlock();
+        if (writeLock.owns_lock())
+            writeLock.unlock();
+        if (readLock.owns_lock())
+            readLock.unlock();
+    }
+
+    std::string LockGuard::inspect() const
+    {
+        return locked() ? "<lock_guard locked>" : "<lock_guard>";
+    }
+
+    Condition::Condition() : Object(ObjectType::Condition)
+    {
+    }
+
+    Condition::~Condition()
+    {
+    }
+
+    std::string Condition::inspect() const
+    {
+        return "<condition>";
+    }
+
+    Barrier::Barrier(size_t inrThreads) : Object(ObjectType::Barrier), nrThreads(inrThreads)
+    {
+    }
+
+    Barrier::~Barrier()
+    {
+    }
+
+    bool Barrier::arriveAndWait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const size_t arrivalRound = round;
+        if (++nrArrived == nrThreads)
+        {
+            nrArrived = 0;
+            ++round;
+            lock.unlock();
+            condition.notify_all();
+            return true;
+        }
+        condition.wait(lock, [this, arrivalRound]()
+                       { return round != arrivalRound; });
+        return false;
+    }
+
+    std::string Barrier::inspect() const
+    {
+        return "<barrier>";
+    }
+
+    AtomicInt::AtomicInt(int64_t ivalue) : Object(ObjectType::AtomicInt), value(ivalue)
+    {
+    }
+
+    AtomicInt::~AtomicInt()
+    {
+    }
+
+    std::string AtomicInt::inspect() const
+    {
+        return std::to_string(value.load());
+    }
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Object> mutex_lock(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("lock", self, arguments, obj::ObjectType::Mutex, {0});
+        if (errorObj)
+            return errorObj;
+
+        auto guard = std::make_shared<obj::LockGuard>(self);
+        guard->mutexLock = std::unique_lock<std::mutex>(static_cast<obj::Mutex *>(self.get())->mutex);
+        return guard;
+    }
+
+    std::shared_ptr<obj::Object> mutex_try_lock(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("try_lock", self, arguments, obj::ObjectType::Mutex, {0});
+        if (errorObj)
+            return errorObj;
+
+        auto guard = std::make_shared<obj::LockGuard>(self);
+        guard->mutexLock = std::unique_lock<std::mutex>(static_cast<obj::Mutex *>(self.get())->mutex, std::try_to_lock);
+        if (!guard->locked())
+            return NullObject;
+        return guard;
+    }
+
+    std::shared_ptr<obj::Object> rwlock_read_lock(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("read_lock", self, arguments, obj::ObjectType::RwLock, {0});
+        if (errorObj)
+            return errorObj;
+
+        auto guard = std::make_shared<obj::LockGuard>(self);
+        guard->readLock = std::shared_lock<std::shared_mutex>(static_cast<obj::RwLock *>(self.get())->mutex);
+        return guard;
+    }
+
+    std::shared_ptr<obj::Object> rwlock_write_lock(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("write_lock", self, arguments, obj::ObjectType::RwLock, {0});
+        if (errorObj)
+            return errorObj;
+
+        auto guard = std::make_shared<obj::LockGuard>(self);
+        guard->writeLock = std::unique_lock<std::shared_mutex>(static_cast<obj::RwLock *>(self.get())->mutex);
+        return guard;
+    }
+
+    std::shared_ptr<obj::Object> rwlock_try_read_lock(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("try_read_lock", self, arguments, obj::ObjectType::RwLock, {0});
+        if (errorObj)
+            return errorObj;
+
+        auto guard = std::make_shared<obj::LockGuard>(self);
+        guard->readLock = std::shared_lock<std::shared_mutex>(static_cast<obj::RwLock *>(self.get())->mutex, std::try_to_lock);
+        if (!guard->locked())
+            return NullObject;
+        return guard;
+    }
+
+    std::shared_ptr<obj::Object> rwlock_try_write_lock(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("try_write_lock", self, arguments, obj::ObjectType::RwLock, {0});
+        if (errorObj)
+            return errorObj;
+
+        auto guard = std::make_shared<obj::LockGuard>(self);
+        guard->writeLock = std::unique_lock<std::shared_mutex>(static_cast<obj::RwLock *>(self.get())->mutex, std::try_to_lock);
+        if (!guard->locked())
+            return NullObject;
+        return guard;
+    }
+
+    std::shared_ptr<obj::Object> lock_guard_unlock(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("unlock", self, arguments, obj::ObjectType::LockGuard, {0});
+        if (errorObj)
+            return errorObj;
+
+        static_cast<obj::LockGuard *>(self.get())->unlock();
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> lock_guard_locked(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("locked", self, arguments, obj::ObjectType::LockGuard, {0});
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Boolean>(static_cast<obj::LockGuard *>(self.get())->locked());
+    }
+
+    std::shared_ptr<obj::Object> condition_wait(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("wait", self, arguments, obj::ObjectType::Condition, {1, 2});
+        if (errorObj)
+            return errorObj;
+
+        auto guard = dynamic_cast<obj::LockGuard *>(arguments[0].get());
+        if (!guard || !guard->mutexLock.owns_lock())
+            return std::make_shared<obj::Error>("wait: expected argument 1 to be a locked guard of a mutex", obj::ErrorType::TypeError);
+
+        auto conditionObj = static_cast<obj::Condition *>(self.get());
+        if (arguments.size() == 1)
+        {
+            conditionObj->condition.wait(guard->mutexLock);
+            return NullObject;
+        }
+
+        if (arguments[1]->type != obj::ObjectType::Double)
+            return std::make_shared<obj::Error>("wait: expected argument 2 to be a double", obj::ErrorType::TypeError);
+        int64_t nanoseconds = static_cast<int64_t>(1e9 * static_cast<obj::Double *>(arguments[1].get())->value);
+        auto status = conditionObj->condition.wait_for(guard->mutexLock, std::chrono::nanoseconds(nanoseconds));
+        return std::make_shared<obj::Boolean>(status == std::cv_status::no_timeout);
+    }
+
+    std::shared_ptr<obj::Object> condition_notify_one(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("notify_one", self, arguments, obj::ObjectType::Condition, {0});
+        if (errorObj)
+            return errorObj;
+
+        static_cast<obj::Condition *>(self.get())->condition.notify_one();
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> condition_notify_all(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("notify_all", self, arguments, obj::ObjectType::Condition, {0});
+        if (errorObj)
+            return errorObj;
+
+        static_cast<obj::Condition *>(self.get())->condition.notify_all();
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> barrier_wait(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("wait", self, arguments, obj::ObjectType::Barrier, {0});
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Boolean>(static_cast<obj::Barrier *>(self.get())->arriveAndWait());
+    }
+
+    std::shared_ptr<obj::Object> atomic_int_load(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("load", self, arguments, obj::ObjectType::AtomicInt, {0});
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Integer>(static_cast<obj::AtomicInt *>(self.get())->value.load());
+    }
+
+    std::shared_ptr<obj::Object> atomic_int_store(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("store", self, arguments, obj::ObjectType::AtomicInt, {1});
+        if (!errorObj)
+            errorObj = validateIntegerArgument("store", arguments, 0);
+        if (errorObj)
+            return errorObj;
+
+        static_cast<obj::AtomicInt *>(self.get())->value.store(integerArgument(arguments, 0));
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> atomic_int_fetch_add(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("fetch_add", self, arguments, obj::ObjectType::AtomicInt, {1});
+        if (!errorObj)
+            errorObj = validateIntegerArgument("fetch_add", arguments, 0);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Integer>(static_cast<obj::AtomicInt *>(self.get())->value.fetch_add(integerArgument(arguments, 0)));
+    }
+
+    std::shared_ptr<obj::Object> atomic_int_fetch_sub(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("fetch_sub", self, arguments, obj::ObjectType::AtomicInt, {1});
+        if (!errorObj)
+            errorObj = validateIntegerArgument("fetch_sub", arguments, 0);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Integer>(static_cast<obj::AtomicInt *>(self.get())->value.fetch_sub(integerArgument(arguments, 0)));
+    }
+
+    std::shared_ptr<obj::Object> atomic_int_exchange(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("exchange", self, arguments, obj::ObjectType::AtomicInt, {1});
+        if (!errorObj)
+            errorObj = validateIntegerArgument("exchange", arguments, 0);
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Integer>(static_cast<obj::AtomicInt *>(self.get())->value.exchange(integerArgument(arguments, 0)));
+    }
+
+    std::shared_ptr<obj::Object> atomic_int_compare_exchange(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("compare_exchange", self, arguments, obj::ObjectType::AtomicInt, {2});
+        if (!errorObj)
+            errorObj = validateIntegerArgument("compare_exchange", arguments, 0);
+        if (!errorObj)
+            errorObj = validateIntegerArgument("compare_exchange", arguments, 1);
+        if (errorObj)
+            return errorObj;
+
+        int64_t expected = integerArgument(arguments, 0);
+        bool exchanged = static_cast<obj::AtomicInt *>(self.get())->value.compare_exchange_strong(expected, integerArgument(arguments, 1));
+        return std::make_shared<obj::Boolean>(exchanged);
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeMutex()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto mutexBuiltinType = std::make_shared<obj::BuiltinType>();
+        mutexBuiltinType->builtinObjectType = obj::ObjectType::Mutex;
+
+        mutexBuiltinType->functions = {
+            {"lock", TBuiltInFD({&builtin::mutex_lock, typing::makeFunctionType("", "lock_guard")})},
+            {"try_lock", TBuiltInFD({&builtin::mutex_try_lock, typing::makeFunctionType("", "<lock_guard,null>")})},
+        };
+
+        return mutexBuiltinType;
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeRwLock()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto rwlockBuiltinType = std::make_shared<obj::BuiltinType>();
+        rwlockBuiltinType->builtinObjectType = obj::ObjectType::RwLock;
+
+        rwlockBuiltinType->functions = {
+            {"read_lock", TBuiltInFD({&builtin::rwlock_read_lock, typing::makeFunctionType("", "lock_guard")})},
+            {"write_lock", TBuiltInFD({&builtin::rwlock_write_lock, typing::makeFunctionType("", "lock_guard")})},
+            {"try_read_lock", TBuiltInFD({&builtin::rwlock_try_read_lock, typing::makeFunctionType("", "<lock_guard,null>")})},
+            {"try_write_lock", TBuiltInFD({&builtin::rwlock_try_write_lock, typing::makeFunctionType("", "<lock_guard,null>")})},
+        };
+
+        return rwlockBuiltinType;
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeLockGuard()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto lockGuardBuiltinType = std::make_shared<obj::BuiltinType>();
+        lockGuardBuiltinType->builtinObjectType = obj::ObjectType::LockGuard;
+
+        lockGuardBuiltinType->functions = {
+            {"unlock", TBuiltInFD({&builtin::lock_guard_unlock, typing::makeFunctionType("", "null")})},
+            {"locked", TBuiltInFD({&builtin::lock_guard_locked, typing::makeFunctionType("", "bool")})},
+        };
+
+        return lockGuardBuiltinType;
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeCondition()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto conditionBuiltinType = std::make_shared<obj::BuiltinType>();
+        conditionBuiltinType->builtinObjectType = obj::ObjectType::Condition;
+
+        conditionBuiltinType->functions = {
+            {"wait", TBuiltInFD({&builtin::condition_wait, typing::makeFunctionType("lock_guard", "<bool,null>")})},
+            {"notify_one", TBuiltInFD({&builtin::condition_notify_one, typing::makeFunctionType("", "null")})},
+            {"notify_all", TBuiltInFD({&builtin::condition_notify_all, typing::makeFunctionType("", "null")})},
+        };
+
+        return conditionBuiltinType;
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeBarrier()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto barrierBuiltinType = std::make_shared<obj::BuiltinType>();
+        barrierBuiltinType->builtinObjectType = obj::ObjectType::Barrier;
+
+        barrierBuiltinType->functions = {
+            {"wait", TBuiltInFD({&builtin::barrier_wait, typing::makeFunctionType("", "bool")})},
+        };
+
+        return barrierBuiltinType;
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeAtomicInt()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto atomicIntBuiltinType = std::make_shared<obj::BuiltinType>();
+        atomicIntBuiltinType->builtinObjectType = obj::ObjectType::AtomicInt;
+
+        atomicIntBuiltinType->functions = {
+            {"load", TBuiltInFD({&builtin::atomic_int_load, typing::makeFunctionType("", "int")})},
+            {"store", TBuiltInFD({&builtin::atomic_int_store, typing::makeFunctionType("int", "null")})},
+            {"fetch_add", TBuiltInFD({&builtin::atomic_int_fetch_add, typing::makeFunctionType("int", "int")})},
+            {"fetch_sub", TBuiltInFD({&builtin::atomic_int_fetch_sub, typing::makeFunctionType("int", "int")})},
+            {"exchange", TBuiltInFD({&builtin::atomic_int_exchange, typing::makeFunctionType("int", "int")})},
+            {"compare_exchange", TBuiltInFD({&builtin::atomic_int_compare_exchange, typing::makeFunctionType("int, int", "bool")})},
+        };
+
+        return atomicIntBuiltinType;
+    }
+} // namespace builtin
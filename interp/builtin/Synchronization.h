@@ -0,0 +1,24 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_BUILTIN_SYNCHRONIZATION_H
+#define GUARDIAN_OF_INCLUSION_BUILTIN_SYNCHRONIZATION_H
+
+#include "../Object.h"
+
+namespace builtin
+{
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeMutex();
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeRwLock();
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeLockGuard();
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeCondition();
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeBarrier();
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeAtomicInt();
+}
+
+#endif
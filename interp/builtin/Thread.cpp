@@ -8,6 +8,7 @@
 
 #include "Thread.h"
 #include "../Evaluator.h"
+#include "../Interpreter.h"
 #include "../Typing.h"
 #include "../Util.h"
 
@@ -67,14 +68,21 @@ namespace obj
             functionReturnValue = evalFunctionWithArguments(function.get(), {}, environment);
     }
 
-    void Thread::start()
+    void Thread::start(const std::shared_ptr<Thread> &self)
     {
         if (thread)
         {
             throw std::runtime_error("Cannot start thread twice");
         }
 
-        thread.reset(new std::thread(&Thread::run, this));
+        // from now on the environments of the function and of a function passed as its argument are used by both threads
+        if (function->environment)
+            function->environment->markShared();
+        obj::markShared(argument);
+        thread.reset(new std::thread([self, interpreter = interp::Interpreter::currentShared()]()
+                                     {
+                                         interp::CurrentInterpreter current(interpreter.get());
+                                         self->run(); }));
     }
 
     bool Thread::joinable() const
@@ -105,7 +113,8 @@ namespace builtin
         if (errorObj)
             return errorObj;
 
-        static_cast<obj::Thread *>(self.get())->start();
+        auto thread = std::static_pointer_cast<obj::Thread>(self);
+        thread->start(thread);
         return NullObject;
     }
 
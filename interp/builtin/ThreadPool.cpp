@@ -0,0 +1,246 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#include "ThreadPool.h"
+#include "../Evaluator.h"
+#include "../Interpreter.h"
+#include "../Typing.h"
+#include "../Util.h"
+
+namespace
+{
+    std::shared_ptr<obj::Object>
+    validateArguments(
+        const std::string &errorPrefix,
+        const std::shared_ptr<obj::Object> &self,
+        const std::vector<std::shared_ptr<obj::Object>> &arguments,
+        const obj::ObjectType expectedType,
+        std::set<size_t> nrExpectedArguments)
+    {
+        if (self.get()->type != expectedType)
+            return std::make_shared<obj::Error>(errorPrefix + ": expected " + toString(expectedType) + ", got " + toString(self.get()->type), obj::ErrorType::TypeError);
+        if (nrExpectedArguments.find(arguments.size()) == nrExpectedArguments.end())
+        {
+            if (nrExpectedArguments.size() == 1)
+            {
+                return std::make_shared<obj::Error>(errorPrefix + ": expected " + std::to_string(*nrExpectedArguments.begin()) + " arguments, got " + std::to_string(arguments.size()), obj::ErrorType::TypeError);
+            }
+            else
+            {
+                std::vector<std::string> nrExpected;
+                for (const auto &element : nrExpectedArguments)
+                    nrExpected.push_back(std::to_string(element));
+                return std::make_shared<obj::Error>(errorPrefix + ": expected " + util::join(nrExpected, ",") + " arguments, got " + std::to_string(arguments.size()), obj::ErrorType::TypeError);
+            }
+        }
+        return nullptr;
+    }
+}
+
+namespace obj
+{
+    ThreadPool::ThreadPool(const std::shared_ptr<scheduler::WorkStealingPool> &ipool) : Object(ObjectType::ThreadPool), pool(ipool)
+    {
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        // the last reference can be dropped by a task running on the pool itself, a
+        // worker cannot join itself so the pool is shut down from a separate thread
+        if (pool && pool->isWorkerThread())
+            std::thread([pool = std::move(pool)]() mutable
+                        { pool.reset(); })
+                .detach();
+    }
+
+    std::string ThreadPool::inspect() const
+    {
+        return "<pool>";
+    }
+
+    Future::Future() : Object(ObjectType::Future)
+    {
+    }
+
+    Future::~Future()
+    {
+    }
+
+    void Future::set(const std::shared_ptr<Object> &ivalue)
+    {
+        std::vector<std::function<void()>> readyContinuations;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            value = ivalue;
+            ready = true;
+            readyContinuations.swap(continuations);
+        }
+        condition.notify_all();
+        for (const auto &continuation : readyContinuations)
+            continuation();
+    }
+
+    void Future::onReady(std::function<void()> continuation)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!ready)
+            {
+                continuations.push_back(std::move(continuation));
+                return;
+            }
+        }
+        continuation();
+    }
+
+    bool Future::done() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ready;
+    }
+
+    const std::shared_ptr<Object> &Future::wait() const
+    {
+        // a worker blocking on a task that is still queued could starve the pool, so it
+        // keeps executing pending tasks and only sleeps briefly when there are none
+        auto pool = scheduler::WorkStealingPool::current();
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!ready)
+        {
+            if (pool)
+            {
+                lock.unlock();
+                bool executedTask = pool->runPendingTask();
+                lock.lock();
+                if (executedTask)
+                    continue;
+                condition.wait_for(lock, std::chrono::milliseconds(1));
+            }
+            else
+                condition.wait(lock);
+        }
+        return value;
+    }
+
+    std::string Future::inspect() const
+    {
+        return done() ? "<future done>" : "<future>";
+    }
+}
+
+namespace builtin
+{
+    std::shared_ptr<obj::Future> submitFunction(scheduler::WorkStealingPool &pool, const std::shared_ptr<obj::Function> &function, std::vector<std::shared_ptr<obj::Object>> arguments)
+    {
+        // from now on the environments of the function and of the functions passed as arguments are used by several threads
+        if (function->environment)
+            function->environment->markShared();
+        for (const auto &argument : arguments)
+            obj::markShared(argument);
+
+        auto future = std::make_shared<obj::Future>();
+        pool.submit([future, function, arguments = std::move(arguments), interpreter = interp::Interpreter::currentShared()]()
+                    {
+                        // a worker may run tasks of several interpreters, the task runs in the one that submitted it
+                        interp::CurrentInterpreter current(interpreter.get());
+                        std::shared_ptr<obj::Object> returnValue;
+                        try
+                        {
+                            auto environment = std::make_shared<obj::Environment>();
+                            environment->outer = function->environment;
+                            returnValue = evalFunctionWithArguments(function.get(), arguments, environment);
+                        }
+                        catch (const std::exception &e)
+                        {
+                            returnValue = std::make_shared<obj::Error>(std::string("submit: task failed: ") + e.what(), obj::ErrorType::UndefinedError);
+                        }
+                        future->set(returnValue); });
+        return future;
+    }
+
+    std::shared_ptr<obj::Object> pool_submit(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        if (self->type != obj::ObjectType::ThreadPool)
+            return std::make_shared<obj::Error>("submit: expected " + toString(obj::ObjectType::ThreadPool) + ", got " + toString(self->type), obj::ErrorType::TypeError);
+        if (arguments.empty())
+            return std::make_shared<obj::Error>("submit: expected at least 1 argument", obj::ErrorType::TypeError);
+        RETURN_TYPE_ERROR_ON_MISMATCH(arguments.front(), Function, "submit: expected argument 1 to be a function");
+
+        auto function = std::static_pointer_cast<obj::Function>(arguments.front());
+        std::vector<std::shared_ptr<obj::Object>> functionArguments(arguments.begin() + 1, arguments.end());
+        return submitFunction(*static_cast<obj::ThreadPool *>(self.get())->pool, function, std::move(functionArguments));
+    }
+
+    std::shared_ptr<obj::Object> pool_size(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("size", self, arguments, obj::ObjectType::ThreadPool, {0});
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Integer>(static_cast<int64_t>(static_cast<obj::ThreadPool *>(self.get())->pool->size()));
+    }
+
+    std::shared_ptr<obj::Object> future_wait(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("wait", self, arguments, obj::ObjectType::Future, {0});
+        if (errorObj)
+            return errorObj;
+
+        static_cast<obj::Future *>(self.get())->wait();
+        return NullObject;
+    }
+
+    std::shared_ptr<obj::Object> future_done(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("done", self, arguments, obj::ObjectType::Future, {0});
+        if (errorObj)
+            return errorObj;
+
+        return std::make_shared<obj::Boolean>(static_cast<obj::Future *>(self.get())->done());
+    }
+
+    std::shared_ptr<obj::Object> future_value(const std::shared_ptr<obj::Object> &self, const std::vector<std::shared_ptr<obj::Object>> &arguments)
+    {
+        auto errorObj = validateArguments("value", self, arguments, obj::ObjectType::Future, {0});
+        if (errorObj)
+            return errorObj;
+
+        return static_cast<obj::Future *>(self.get())->wait();
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeThreadPool()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto poolBuiltinType = std::make_shared<obj::BuiltinType>();
+        poolBuiltinType->builtinObjectType = obj::ObjectType::ThreadPool;
+
+        poolBuiltinType->functions = {
+            {"submit", TBuiltInFD({&builtin::pool_submit, typing::makeFunctionType("", "future")})},
+            {"size", TBuiltInFD({&builtin::pool_size, typing::makeFunctionType("", "int")})},
+        };
+
+        return poolBuiltinType;
+    }
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeFuture()
+    {
+        typedef obj::TBuiltinTypeFunctionDefinition TBuiltInFD;
+
+        auto futureBuiltinType = std::make_shared<obj::BuiltinType>();
+        futureBuiltinType->builtinObjectType = obj::ObjectType::Future;
+
+        futureBuiltinType->functions = {
+            {"wait", TBuiltInFD({&builtin::future_wait, typing::makeFunctionType("", "null")})},
+            {"done", TBuiltInFD({&builtin::future_done, typing::makeFunctionType("", "bool")})},
+            {"value", TBuiltInFD({&builtin::future_value, typing::makeFunctionType("", "all")})},
+        };
+
+        return futureBuiltinType;
+    }
+} // namespace builtin
@@ -0,0 +1,24 @@
+/*******************************************************************
+ * Copyright (c) 2022-2023 TheWallSoft
+ * This file is part of the Luci Language
+ * tom@thewallsoft.com, https://github.com/nightwing1978/luci-lang
+ * See Copyright Notice in the LICENSE file or at
+ * https://github.com/nightwing1978/luci-lang/blob/main/LICENSE
+ *******************************************************************/
+
+#ifndef GUARDIAN_OF_INCLUSION_BUILTIN_THREAD_POOL_H
+#define GUARDIAN_OF_INCLUSION_BUILTIN_THREAD_POOL_H
+
+#include "../Object.h"
+#include "../Scheduler.h"
+
+namespace builtin
+{
+    /* schedule the call of function with arguments on the pool, the returned future receives the return value */
+    std::shared_ptr<obj::Future> submitFunction(scheduler::WorkStealingPool &pool, const std::shared_ptr<obj::Function> &function, std::vector<std::shared_ptr<obj::Object>> arguments);
+
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeThreadPool();
+    std::shared_ptr<obj::BuiltinType> makeBuiltinTypeFuture();
+}
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "Threading.h"
 #include "../Evaluator.h"
+#include "../Scheduler.h"
 #include "../Typing.h"
 
 namespace builtin
@@ -51,10 +52,125 @@ namespace builtin
         return NullObject;
     }
 
+    std::shared_ptr<obj::Object> pool(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() > 1)
+            return std::make_shared<obj::Error>("pool: expected 0 or 1 argument of type (int)", obj::ErrorType::TypeError);
+
+        size_t nrWorkers = std::max<size_t>(1, std::thread::hardware_concurrency());
+        if (arguments->size() == 1)
+        {
+            auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+            RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Integer, "pool: expected argument 1 to be an int");
+            auto requestedWorkers = static_cast<obj::Integer *>(evaluatedExpr1.get())->value;
+            if (requestedWorkers <= 0)
+                return std::make_shared<obj::Error>("pool: expected a positive number of workers", obj::ErrorType::ValueError);
+            nrWorkers = static_cast<size_t>(requestedWorkers);
+        }
+
+        return std::make_shared<obj::ThreadPool>(std::make_shared<scheduler::WorkStealingPool>(nrWorkers));
+    }
+
+    std::shared_ptr<obj::Object> channel(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("channel: expected 1 argument of type (int)", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Integer, "channel: expected argument 1 to be an int");
+        auto capacity = static_cast<obj::Integer *>(evaluatedExpr1.get())->value;
+        if (capacity <= 0)
+            return std::make_shared<obj::Error>("channel: expected a positive capacity", obj::ErrorType::ValueError);
+
+        return std::make_shared<obj::Channel>(static_cast<size_t>(capacity));
+    }
+
+    std::shared_ptr<obj::Object> mutex(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (!arguments->empty())
+            return std::make_shared<obj::Error>("mutex: expected 0 arguments", obj::ErrorType::TypeError);
+
+        return std::make_shared<obj::Mutex>();
+    }
+
+    std::shared_ptr<obj::Object> rwlock(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (!arguments->empty())
+            return std::make_shared<obj::Error>("rwlock: expected 0 arguments", obj::ErrorType::TypeError);
+
+        return std::make_shared<obj::RwLock>();
+    }
+
+    std::shared_ptr<obj::Object> condition(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (!arguments->empty())
+            return std::make_shared<obj::Error>("condition: expected 0 arguments", obj::ErrorType::TypeError);
+
+        return std::make_shared<obj::Condition>();
+    }
+
+    std::shared_ptr<obj::Object> barrier(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() != 1)
+            return std::make_shared<obj::Error>("barrier: expected 1 argument of type (int)", obj::ErrorType::TypeError);
+
+        auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+        RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Integer, "barrier: expected argument 1 to be an int");
+        auto nrThreads = static_cast<obj::Integer *>(evaluatedExpr1.get())->value;
+        if (nrThreads <= 0)
+            return std::make_shared<obj::Error>("barrier: expected a positive number of threads", obj::ErrorType::ValueError);
+
+        return std::make_shared<obj::Barrier>(static_cast<size_t>(nrThreads));
+    }
+
+    std::shared_ptr<obj::Object> atomic_int(const std::vector<std::unique_ptr<ast::Expression>> *arguments, const std::shared_ptr<obj::Environment> &environment)
+    {
+        if (!arguments)
+            return NullObject;
+
+        if (arguments->size() > 1)
+            return std::make_shared<obj::Error>("atomic_int: expected 0 or 1 argument of type (int)", obj::ErrorType::TypeError);
+
+        int64_t initialValue = 0;
+        if (arguments->size() == 1)
+        {
+            auto evaluatedExpr1 = evalExpression(arguments->front().get(), environment);
+            RETURN_TYPE_ERROR_ON_MISMATCH(evaluatedExpr1, Integer, "atomic_int: expected argument 1 to be an int");
+            initialValue = static_cast<obj::Integer *>(evaluatedExpr1.get())->value;
+        }
+
+        return std::make_shared<obj::AtomicInt>(initialValue);
+    }
+
     std::shared_ptr<obj::Module> createThreadingModule()
     {
         auto threadingModule = std::make_shared<obj::Module>();
         threadingModule->environment->add("thread", builtin::makeBuiltInFunctionObj(&builtin::thread, "", "thread"), false, nullptr);
+        threadingModule->environment->add("mutex", builtin::makeBuiltInFunctionObj(&builtin::mutex, "", "mutex"), false, nullptr);
+        threadingModule->environment->add("rwlock", builtin::makeBuiltInFunctionObj(&builtin::rwlock, "", "rwlock"), false, nullptr);
+        threadingModule->environment->add("condition", builtin::makeBuiltInFunctionObj(&builtin::condition, "", "condition"), false, nullptr);
+        threadingModule->environment->add("barrier", builtin::makeBuiltInFunctionObj(&builtin::barrier, "int", "barrier"), false, nullptr);
+        threadingModule->environment->add("atomic_int", builtin::makeBuiltInFunctionObj(&builtin::atomic_int, "", "atomic_int"), false, nullptr);
+        threadingModule->environment->add("channel", builtin::makeBuiltInFunctionObj(&builtin::channel, "int", "channel"), false, nullptr);
+        threadingModule->environment->add("pool", builtin::makeBuiltInFunctionObj(&builtin::pool, "", "pool"), false, nullptr);
         threadingModule->environment->add("sleep", builtin::makeBuiltInFunctionObj(&builtin::sleep, "double", "null"), false, nullptr);
         threadingModule->state = obj::ModuleState::Loaded;
         return threadingModule;
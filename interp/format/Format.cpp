@@ -209,7 +209,7 @@ namespace builtin
             return std::string(); // empty indicates error happened
         }
 
-        sprintf_s(buffer, sizeof(buffer) - 1, formatDelegator.c_str(), value);
+        std::snprintf(buffer, sizeof(buffer) - 1, formatDelegator.c_str(), value);
 
         auto result = std::string(buffer);
 